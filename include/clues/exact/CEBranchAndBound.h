@@ -0,0 +1,113 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#ifndef ALGORITHMSPROJECT_CEBRANCHANDBOUND_H
+#define ALGORITHMSPROJECT_CEBRANCHANDBOUND_H
+
+#include "Makros.h"
+
+/**
+ * Exact branch-and-bound algorithm for cluster editing, intended for small graphs (up to several dozens of nodes).
+ *
+ * A graph is a cluster graph iff it has no conflict triples - induced paths a-b-c. In each node of the search tree a
+ * conflict triple is found and three branches are considered: delete edge (a,b); keep (a,b) and delete (b,c); keep
+ * both (a,b) and (b,c) and add (a,c). Pairs are marked as permanent or forbidden, so branches do not overlap.
+ * Marks are closed under implications: if (u,v) and (v,w) are permanent, then (u,w) is permanent, and if (u,v) is
+ * permanent and (v,w) is forbidden, then (u,w) is forbidden.
+ *
+ * Branches are pruned using lower bound obtained from a packing of conflict triples, that are disjoint on pairs that
+ * are not marked yet - each such triple requires at least one modification.
+ */
+class CEBranchAndBound{
+public:
+
+    CEBranchAndBound( VVI & V );
+
+    /**
+     * Searches for an optimal solution. [init_part] is a partition of nodes, it is used as the initial upper bound.
+     * The search is stopped after [max_branches] nodes of the search tree were visited or when Global::checkTle()
+     * returns true.
+     * The best partition found is stored in [best_partition], its result in [best_result].
+     * @return true if the best partition found is proved to be optimal
+     */
+    bool solve( VI init_part, LL max_branches = numeric_limits<LL>::max() );
+
+    /**
+     * @return lower bound for the number of modifications of the current graph required to make it a cluster graph,
+     * obtained by a greedy packing of conflict [triples], disjoint on pairs that are not marked.
+     * Triples are added to the packing starting from those with the smallest number of unmarked pairs.
+     */
+    int lowerBound( vector< tuple<int,int,int> > & triples );
+
+//private:
+
+    VVI * V;
+    int N;
+
+    /**
+     * Original and current adjacency matrix.
+     */
+    VVB orig_adj, adj;
+
+    /**
+     * fixed[a][b] is 1 if (a,b) is permanent, -1 if (a,b) is forbidden and 0 otherwise.
+     */
+    VVI fixed;
+
+    /**
+     * Pairs marked in the current branch, in order of marking.
+     */
+    VPII trail;
+
+    /**
+     * Number of modifications done in the current branch.
+     */
+    int cost = 0;
+
+    VI best_partition;
+    int best_result = 0;
+    bool optimal = true;
+
+    LL branches = 0, max_branches = 0;
+
+    /**
+     * Current graph, as adjacency lists - rebuilt in each node of the search tree.
+     */
+    VVI G;
+
+    /**
+     * Helper arrays used to mark pairs used in the packing of conflict triples.
+     */
+    VVI used;
+    int used_stamp = 0;
+
+    /**
+     * triples_by_free_pairs[k] contains indices of conflict triples with k+1 pairs that are not marked, filled in
+     * [lowerBound].
+     */
+    VVI triples_by_free_pairs = VVI(3);
+
+    vector< tuple<int,int,int> > fix_queue;
+
+    /**
+     * Marks (a,b) as permanent (if [val] is 1) or forbidden (if [val] is -1), modifying the current graph if
+     * necessary. Implied marks are added as well.
+     * @return false if the mark contradicts existing marks. The state is left inconsistent, [undo] should be called.
+     */
+    bool fix( int a, int b, int val );
+
+    /**
+     * Reverts all marks from [trail], leaving first [trail_size] of them.
+     */
+    void undo( int trail_size );
+
+    void branch();
+
+    /**
+     * @return partition of the current graph, that is a cluster graph
+     */
+    VI currentPartition();
+};
+
+#endif //ALGORITHMSPROJECT_CEBRANCHANDBOUND_H
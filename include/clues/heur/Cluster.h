@@ -7,6 +7,7 @@
 
 #include "Makros.h"
 #include "ClusterGraph.h"
+#include "Workspace.h"
 
 
 /**
@@ -16,19 +17,14 @@ class Cluster{
 public:
     static const int invalid_id = -1;
 
-    /**
-     * CAUTION!!  This is single-threaded only in such implementation.
-     * Static helper array used to quickly induce graph [g].
-     */
-    static VI helper;
-
 //    Cluster() : cluster_weight(0), id(invalid_id){}
     Cluster() = default;
 
     /**
      * Constructs Cluster - that is it induces the cluster from given ClusterGraph.
+     * @param ws workspace, whose [induce_helper] is used to quickly induce graph [g]
      */
-    Cluster( ClusterGraph & v, VI nodes, int id );
+    Cluster( ClusterGraph & v, VI nodes, int id, Workspace & ws = Workspace::local() );
 
     friend ostream& operator<<( ostream& str, Cluster& cl );
 
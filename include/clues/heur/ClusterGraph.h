@@ -6,6 +6,8 @@
 #define ALGORITHMSPROJECT_CLUSTERGRAPH_H
 
 #include <graphs/GraphInducer.h>
+#include "graphs/CSRGraph.h"
+#include "utils/ThreadPool.h"
 #include "Makros.h"
 
 
@@ -19,8 +21,9 @@ public:
      * If partition[i] == -1, then the node i will not be considered for graph construction.
      * @param V
      * @param partition
+     * @param pool if not nullptr, then edges of the graph are contracted concurrently using threads of [pool]
      */
-    ClusterGraph( VVI * V, VI partition );
+    ClusterGraph( VVI * V, VI partition, ThreadPool * pool = nullptr );
 
     /**
      * Just an abbreviation
@@ -48,9 +51,17 @@ public:
 //    VI origPartition;
 
     /**
-     * Structure of the graph. V[i][j] = ( id, weight )
+     * Structure of the graph. V[i][j] = ( id, weight ). Neighbors of each node are sorted by id.
      */
     VVPII V;
+
+    /**
+     * The same graph as [V] in CSR format (the same order of neighbors). It is created first by [createGraph], so
+     * structures that need CSR can copy it instead of converting [V].
+     * It can be used only if [csr_valid] is true - code that modifies [V] directly should set it to false.
+     */
+    CSRGraph<PII> csr;
+    bool csr_valid = false;
     int N; // V.size()
 
     VI node_weights;
@@ -66,9 +77,24 @@ public:
     VI partition;
 
     /**
-     * Creates cluster graph structure
+     * Creates cluster graph structure in O(N + E) time, without any hashing or sorting.
+     *
+     * Nodes of the original graph are grouped by their clusters (clusterNodes is a counting sort of nodes by
+     * partition). Then for each cluster a, edges of all its nodes are scanned and parallel edges are merged using
+     * arrays last_seen and weight of size N: last_seen[b] == a means that the edge (a,b) was already found and
+     * its weight is accumulated in weight[b]. This gives unsorted neighbor lists of all clusters. Transposing them
+     * (iterating over a in increasing order and appending a to lists of its neighbors) gives [csr] with neighbors
+     * sorted by id.
+     *
+     * If [pool] is not nullptr, then neighbor lists are created concurrently for ranges of clusters - each thread
+     * has its own arrays last_seen and weight. Transposition is sequential.
+     */
+    void createGraph( ThreadPool * pool = nullptr );
+
+    /**
+     * Sets [V] to [g] and creates [csr] for it. Should be used instead of assigning [V] directly.
      */
-    void createGraph();
+    void setGraph( VVPII g );
 
 };
 
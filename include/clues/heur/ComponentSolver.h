@@ -0,0 +1,172 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#ifndef ALGORITHMSPROJECT_COMPONENTSOLVER_H
+#define ALGORITHMSPROJECT_COMPONENTSOLVER_H
+
+#include <mutex>
+#include "Makros.h"
+#include "Config.h"
+
+/**
+ * Decomposition front-end of the solver. The graph is split into connected components, which are solved
+ * independently - in an optimal solution no cluster contains nodes from different components, so the result for the
+ * whole graph is the sum of results for components plus the number of edges between components.
+ *
+ * If [cnf.component_decomposition_use_kernelization] is set, then components are found in the graph kernelized using
+ * exact rules (together with clusters already marked by the kernelizer) - kernelization often shatters the graph into
+ * many components. Components removed entirely by the kernelizer are solved by it.
+ *
+ * The constructor only finds components, so that the caller can decide (e.g. using [countLargeComponents]) whether
+ * the decomposition is worth using, before any component is solved.
+ *
+ * Components with at most [cnf.component_exact_max_size] nodes are solved exactly using CEBranchAndBound, concurrently
+ * on a thread pool (with a limit of [cnf.component_exact_max_branches] branches per component and a limit of total
+ * time - components not solved within those limits are treated as large ones, initialized with the best partition
+ * found). Other components are packed into
+ * groups of total size at least [cnf.component_min_group_weight] (solving a graph has some overhead independent of its
+ * size, so solving hundreds of small components one by one would be slow). Each group is treated as one large
+ * component and is solved by a given function, concurrently on a thread pool, each with its own hard time budget.
+ * Partitions of components are stitched together into one partition of the graph.
+ */
+class ComponentSolver{
+public:
+
+    ComponentSolver( VVI & V, Config & cnf );
+
+    /**
+     * Function used to solve large component [comp] by thread [thread_id]. It should report found partitions of
+     * graphs[comp] using [updateBestPartition] and return at [deadline] (in seconds from the start of the algorithm).
+     * The deadline is hard - Global::checkTle() returns true after it in the thread calling the function.
+     */
+    using SolveFunction = function< void( int comp, int thread_id, double deadline ) >;
+
+    /**
+     * @return number of components that are not solved by the kernelizer and have more than
+     * [cnf.component_exact_max_size] nodes - those components will surely be solved by the heuristic.
+     */
+    int countLargeComponents();
+
+    /**
+     * Solves small components exactly on [threads] threads, spending at most [seconds] in total - components not
+     * solved by then are treated as large ones. Then packs other components into groups and creates [graphs],
+     * [best_partitions] and [large_components].
+     */
+    void solveSmallComponents( int threads, double seconds );
+
+    /**
+     * Solves all [large_components] using [solve], on [threads] threads.
+     * Each component gets time budget proportional to its weight (see [weights]), but not more than [seconds].
+     * Budgets are scaled so that all components can be solved in [seconds] - components are processed starting from
+     * the largest one.
+     */
+    void solveLargeComponents( int threads, double seconds, const SolveFunction & solve );
+
+    /**
+     * Sets best partition of component [comp] to [part], if it is better than the current best one.
+     * Thread-safe.
+     * @return true if the result for the component was improved
+     */
+    bool updateBestPartition( int comp, VI & part );
+
+    /**
+     * @return partition of the whole graph, obtained by stitching best partitions of all components.
+     * @param result if not nullptr, then the result of the returned partition is written to it
+     */
+    VI getPartition( int * result = nullptr );
+
+    /**
+     * @return result (number of modifications) of the partition returned by [getPartition()].
+     */
+    int getResult();
+
+    /**
+     * @return estimated fraction of the neighborhood of a node that needs to be modified in graph [G] - average
+     * Jaccard distance of closed neighborhoods of ends of an edge, over a sample of edges. It is 0 for a cluster graph.
+     */
+    static double editDensity( VVI & G );
+
+//private:
+
+    VVI * V;
+    Config * cnf;
+    int N;
+
+    /**
+     * Connected components solved exactly and groups of other connected components, nodes in each are sorted.
+     */
+    VVI components;
+
+    /**
+     * graphs[c] is the graph of [V] induced by components[c], node components[c][i] has id i.
+     */
+    vector<VVI> graphs;
+
+    /**
+     * Ids of components that are not solved exactly, sorted by [weights], in non-ascending order.
+     */
+    VI large_components;
+
+    /**
+     * weights[c] is the number of nodes and edges of large component c, multiplied by its [editDensity] (at least
+     * 0.1, so that components that are almost cluster graphs still get some time). Time budgets are proportional to
+     * weights.
+     */
+    VD weights;
+
+    /**
+     * best_partitions[c] is the best partition of graphs[c] found so far, best_results[c] is its result.
+     */
+    VVI best_partitions;
+    VI best_results;
+
+    /**
+     * Number of edges of [V] with ends in different components. Each of them is deleted in every solution.
+     */
+    int edges_between_components = 0;
+
+    /**
+     * Partition of [V] found so far, labels of clusters are ids of nodes in them.
+     * solved[i] is true if the cluster of node i in init_partition is optimal.
+     */
+    VI init_partition;
+    VB solved;
+
+    /**
+     * Helper arrays of size N, filled with -1.
+     */
+    VI id_in_comp, mapper;
+
+    mutex mtx;
+
+    /**
+     * Finds [components]. If [cnf.component_decomposition_use_kernelization] is set, then uses the kernelizer, and
+     * initializes [init_partition] with partitions marked by the kernelizer.
+     */
+    void createComponents();
+
+    /**
+     * Packs [components] that are not solved exactly into groups. Components are considered from the
+     * largest one (by the number of nodes and edges) and added to the current group until its weight reaches
+     * [cnf.component_min_group_weight].
+     */
+    void groupComponents();
+
+    /**
+     * @return graph induced by [comp], node comp[i] has id i
+     */
+    VVI induce( VI & comp );
+
+    /**
+     * @return [init_partition] restricted to [comp], with ids 0,1,...
+     */
+    VI initPartition( VI & comp );
+
+    /**
+     * @return true if all nodes of [comp] are in clusters proved to be optimal
+     */
+    bool solvedExactly( VI & comp );
+};
+
+#endif //ALGORITHMSPROJECT_COMPONENTSOLVER_H
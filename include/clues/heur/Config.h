@@ -159,6 +159,14 @@ public:
     bool use_heuristic_kernelization = true;
     double max_kernelization_time_in_sec = 60;
 
+    /**
+     * If not empty, then kernel created in Solver (CEKernelizer::V and CEKernelizer::inCl) is stored in binary format
+     * (see GraphWriter::writeGraphBinary) in file [kernel_cache_file].<variant>, where variant identifies kernelization
+     * settings. It is loaded from that file in further runs for the same graph and settings, instead of being computed
+     * again.
+     */
+    string kernel_cache_file = "";
+
 //    ******************* NEG
     /**
      * Maximum number of perturbations done by NEG
@@ -210,16 +218,47 @@ public:
 
     bool neg_use_queue_propagation = true;
 
-    bool neg_use_chain2_swaps = true;
+    /**
+     * If true, then NEG keeps best moves of nodes between iterations and recomputes them only for nodes affected by
+     * moves (see NEG::node_move_cache).
+     */
+    bool neg_use_node_move_cache = true;
 
-    bool neg_use_two_node_swaps = true;
+    /**
+     * If true, then in each iteration NEG takes nodes in order of swap values of their best moves (see
+     * NEG::use_gain_buckets) instead of the order of a random permutation.
+     */
+    bool neg_use_gain_buckets = false;
 
-    int neg_move_frequency = 2;
+    /**
+     * Number of threads used by NEG to evaluate moves of nodes concurrently (see NEG::makeParallelNodeMoves). If 1,
+     * then NEG is sequential.
+     */
+    int neg_threads = 1;
 
     /**
-     * If true, then NEG_Nomap and NEG_W1 will not be used (as they are much slower on some graphs).
+     * Number of nodes evaluated concurrently in a single batch, if neg_threads > 1.
      */
-    bool use_neg_map_version = false;
+    int neg_parallel_batch_size = 4096;
+
+    /**
+     * In main_CE, if more than one thread is available and the graph has at least that many nodes, then all threads
+     * are used by a single worker in NEG (neg_threads is set to the number of threads) instead of running a portfolio
+     * of independent workers.
+     */
+    int neg_parallel_min_nodes = 50'000;
+
+    /**
+     * Number of threads used to contract edges when a ClusterGraph is created in Solver. If 1, then it is created
+     * sequentially.
+     */
+    int cluster_graph_threads = 1;
+
+    bool neg_use_chain2_swaps = true;
+
+    bool neg_use_two_node_swaps = true;
+
+    int neg_move_frequency = 2;
 
     int neg_max_iterations_to_do = 1e9;
 
@@ -261,6 +300,21 @@ public:
      */
     bool keep_all_swap_candidates = false;
 
+    /**
+     * Number of threads used to run swap candidate creators in Solver::smallIteration(). If greater than 1, then each
+     * maximal group of consecutive creators in [swpCndCreatorsToUse] other than [node] is run concurrently for the same
+     * state, and candidates created by the whole group are applied at once (e.g. using GREEDY_MAXIMAL_DISJOINT).
+     * CAUTION! With [apply_swap_on_first_negative] this is not equivalent to sequential run - in sequential run
+     * creators after the first one that found a negative candidate are not called at all.
+     */
+    int solver_creator_threads = 1;
+
+    /**
+     * Number of threads used by SwpCndEOCreator::createExpansionOrders() called in Solver::smallIteration() to create
+     * expansion orders for different clusters concurrently. This is independent of [solver_creator_threads].
+     */
+    int solver_eo_threads = 1;
+
     /**
      * Type of state initialization. By default it is RANDOM_MATCHING
      */
@@ -280,6 +334,41 @@ public:
     bool solver_run_fast_induce_first_solution_from_lower_levels = false;
 
     bool neg_do_not_perturb_if_improved = false;
+
+    /**
+     * If true, then the graph is split into connected components that are solved independently (see ComponentSolver).
+     */
+    bool use_component_decomposition = true;
+
+    /**
+     * If true, then the graph is kernelized (using only exact rules) before it is split into connected components -
+     * kernelization often splits the graph into many components.
+     */
+    bool component_decomposition_use_kernelization = true;
+
+    /**
+     * Components with at most that many nodes are solved exactly, using branch and bound.
+     * For random cluster graphs with 15% of pairs modified, branch and bound with the default limit of branches
+     * solves about half of components with 25 nodes, but almost none with 30 or more nodes.
+     */
+    int component_exact_max_size = 25;
+
+    /**
+     * Maximal number of nodes of the search tree of the branch and bound run for a single component. Components that
+     * are not solved within that limit are solved by the heuristic.
+     */
+    int component_exact_max_branches = 5'000;
+
+    /**
+     * Maximal total time of solving small components exactly (see ComponentSolver::solveSmallComponents).
+     */
+    double component_exact_max_time_in_sec = 10;
+
+    /**
+     * Components that are not solved exactly are packed into groups with total number of nodes and edges at least
+     * that large, each group is solved as one graph.
+     */
+    int component_min_group_weight = 20'000;
 };
 
 #endif //CESWAT_CONFIG_H
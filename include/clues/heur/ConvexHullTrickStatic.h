@@ -0,0 +1,130 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#ifndef ALGORITHMSPROJECT_CONVEXHULLTRICKSTATIC_H
+#define ALGORITHMSPROJECT_CONVEXHULLTRICKSTATIC_H
+
+#include "Makros.h"
+
+/**
+ * Integer, array-based counterpart of ConvexHullTrickDynamic, for the case when all lines are added before the first
+ * query (as in edge swaps in NEG). Lines are appended to a vector, the hull is built when the first query is made,
+ * sorting lines by slope if they are not sorted already (the hull is built in linear time for sorted lines). Queries
+ * use binary search, or a pointer walk if query points are nondecreasing.
+ *
+ * All computations are exact - coefficients are integers and products are computed in 128 bits. Ties are resolved in
+ * the same way as in ConvexHullTrickDynamic: among identical lines the first added is kept, and if two hull lines
+ * give the same value in the query point, the one with the smaller slope (for maximization) is returned.
+ *
+ * [clear] does not release memory, so the object can be reused for many hulls without allocations.
+ */
+class ConvexHullTrickStatic{
+public:
+
+    /**
+     * If [max] is true, then we will maximize added functions, otherwise they will be minimized. By default they are
+     * minimized.
+     */
+    ConvexHullTrickStatic( const bool max = false ) : maximize(max){}
+
+    /**
+     * Adds line mx + b, with given id.
+     * If [maximize] is false, then in fact line -mx-b is added, and the upper hull is built.
+     * #CAUTION! Lines must not be added after a query, unless [clear] is called first.
+     */
+    void insert_line( LL m, LL b, int id ){
+        assert( !built );
+        if( maximize ) lines.push_back( {m,b,id} );
+        else lines.push_back( {-m,-b,id} );
+    }
+
+    /**
+     * Finds and returns id of the line that minimizes/maximizes value mx + b. At least one line must be added.
+     */
+    int get_line_id( LL x ){
+        if( !built ) build();
+        int lo = 0, hi = (int)hull.size()-1; // answer is the first i such that hull[i] is not worse than hull[i+1]
+        while( lo < hi ){
+            int mid = (lo+hi) >> 1;
+            if( notWorseThanNext(mid, x) ) hi = mid;
+            else lo = mid+1;
+        }
+        return hull[lo].id;
+    }
+
+    /**
+     * The same as [get_line_id], but it assumes that [x] is not smaller than in the previous call of this function
+     * (since the last [clear]). Finds the line by moving a pointer forward, so a sequence of q queries on a hull with
+     * k lines works in O(q+k) time.
+     */
+    int get_line_id_nondecreasing( LL x ){
+        if( !built ) build();
+        while( ptr+1 < hull.size() && !notWorseThanNext(ptr, x) ) ptr++;
+        return hull[ptr].id;
+    }
+
+    void clear(){
+        lines.clear();
+        hull.clear();
+        ptr = 0;
+        built = false;
+    }
+
+    /**
+     * @return number of lines that are in the hull. It may be less then the number of lines added, if some
+     * are not needed.
+     */
+    int size(){
+        if( !built ) build();
+        return hull.size();
+    }
+
+//private:
+
+    struct Line{
+        LL m, b;
+        int id;
+    };
+
+    vector<Line> lines; // all added lines
+    vector<Line> hull; // lines of the upper hull, sorted by slope
+    int ptr = 0; // pointer used in [get_line_id_nondecreasing]
+    bool built = false;
+    const bool maximize;
+
+    /**
+     * @return true if y is not needed in the hull of lines x,y,z with slopes x.m <= y.m <= z.m
+     */
+    static bool bad( const Line & x, const Line & y, const Line & z ){
+        return (__int128)(x.b - y.b) * (z.m - y.m) >= (__int128)(y.b - z.b) * (y.m - x.m);
+    }
+
+    /**
+     * @return true if hull[i] gives at least the value of hull[i+1] in point x
+     */
+    bool notWorseThanNext( int i, LL x ) const{
+        return (__int128)(hull[i].b - hull[i+1].b) >= (__int128)(hull[i+1].m - hull[i].m) * x;
+    }
+
+    void build(){
+        assert( !lines.empty() );
+        auto cmp = []( const Line & a, const Line & b ){ return a.m < b.m; };
+        if( !is_sorted( ALL(lines), cmp ) ) stable_sort( ALL(lines), cmp ); // stable - first added identical line is kept
+
+        hull.clear();
+        for( Line & l : lines ){
+            if( !hull.empty() && hull.back().m == l.m ){
+                if( l.b <= hull.back().b ) continue;
+                hull.pop_back();
+            }
+            while( hull.size() >= 2 && bad( hull[hull.size()-2], hull.back(), l ) ) hull.pop_back();
+            hull.push_back(l);
+        }
+
+        ptr = 0;
+        built = true;
+    }
+};
+
+#endif //ALGORITHMSPROJECT_CONVEXHULLTRICKSTATIC_H
@@ -15,8 +15,23 @@ class ComponentExpansion{
 public:
     ComponentExpansion( Cluster & cl );
 
+    /**
+     * Creates an object that is not bound to any cluster. [setCluster] needs to be called before first use.
+     */
+    ComponentExpansion();
+
     virtual ~ComponentExpansion(){}
 
+    /**
+     * Binds this object to cluster [cl]. Helper arrays and [heap] are reused - they are reallocated only if [cl] is
+     * larger than all clusters processed so far. This way a single object can be used to create orders for many
+     * clusters, e.g. one object per thread.
+     *
+     * CAUTION! [heap] keeps a pointer to this object, so the object must not be copied or moved after calling this
+     * function.
+     */
+    void setCluster( Cluster & cl );
+
     /**
      * Creates an expansion order, by expanding set S. It uses rules in order they are provided in [cmp_rules].
      *
@@ -80,6 +95,7 @@ public:
      * node selection criteria - e.g. rule10 is not possible to be updated using heap).
      */
     Heap<int> heap;
+    int heap_capacity = 0; // number of items in [heap], at least N
 
     void moveNodeToS(int d, bool use_heap = false);
 
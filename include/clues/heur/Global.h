@@ -5,6 +5,7 @@
 #ifndef ALGORITHMSPROJECT_GLOBAL_H
 #define ALGORITHMSPROJECT_GLOBAL_H
 
+#include <atomic>
 #include <csignal>
 #include <mutex>
 #include <sys/resource.h>
@@ -14,19 +15,33 @@ namespace Global{
 
     extern volatile sig_atomic_t tle;
 
-    extern int max_runtime_in_seconds;
+    /**
+     * Maximal runtime. It is atomic, because it is read by all worker threads in portfolio mode (see main_CE) and
+     * may be changed by the main thread.
+     */
+    extern atomic<int> max_runtime_in_seconds;
 
     /**
      * If true, then no logs will be written to [clog]
      */
     extern const bool disable_all_logs;
 
+    /**
+     * Deadline (in seconds from the start of the algorithm) of the current thread. It is used to give a hard time
+     * budget to a part of the work done by a single thread, e.g. solving one component in ComponentSolver.
+     */
+    extern thread_local double thread_deadline;
+
     /**
      *
-     * @return true if TLE, false otherwise
+     * @return true if TLE (or [thread_deadline] of the calling thread passed), false otherwise
      */
     extern bool checkTle();
 
+    /**
+     * Sets the start time of the algorithm. CAUTION! It should be called only once, before any worker thread is
+     * started - after that, all functions in this namespace only read global data and are thread-safe.
+     */
     extern void startAlg();
 
     /**
@@ -34,6 +49,11 @@ namespace Global{
      */
     extern int secondsFromStart();
 
+    /**
+     * @return number of seconds from the start of the algorithm, with fractional part
+     */
+    extern double preciseSecondsFromStart();
+
     /**
      *
      * @param signum
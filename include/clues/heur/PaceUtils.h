@@ -23,6 +23,12 @@ namespace PaceUtils{
      * For given graph and partition returns the numbers (insertions,deletions,total_modifications).
      */
     extern tuple<int,int,int> getEdgeModificationStatistics( VVI & V, VI & partition );
+
+    /**
+     * @return set of edge modifications necessary to obtain clusters given by [partition] of [V], sorted
+     * lexicographically. Works in time O( N + E + M log(M) ), where M is the number of modifications.
+     */
+    extern VPII getModifications( VVI & V, VI & partition );
     
     /**
      * Calculates result for cluster given by state [st], based on [st.partition]
@@ -0,0 +1,75 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#ifndef ALGORITHMSPROJECT_SOLUTIONWRITER_H
+#define ALGORITHMSPROJECT_SOLUTIONWRITER_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "Makros.h"
+
+/**
+ * Writes the best solution found so far to a file in the background ('anytime' mode), so that if the process is
+ * killed, the last written solution is available.
+ *
+ * Solutions are given by [submit] and written by a separate thread, so workers do not wait for the disk. Only the
+ * most recent submitted solution is written - if a few solutions are submitted while the previous one is being
+ * written, then all but the last one are skipped.
+ * Each solution is first written to a temporary file, which is then renamed to [file], so [file] always contains a
+ * complete solution.
+ */
+class SolutionWriter{
+public:
+    explicit SolutionWriter( string file );
+
+    /**
+     * Writes pending solution (if any) and stops the writing thread.
+     */
+    ~SolutionWriter();
+
+    SolutionWriter( const SolutionWriter& ) = delete;
+    SolutionWriter& operator=( const SolutionWriter& ) = delete;
+
+    /**
+     * Submits new best solution to be written.
+     * @param mods modifications, as returned by Solver::getModifications(). Content of [mods] is swapped with the
+     * internal buffer, so after the call [mods] contains some old data.
+     * @param result number of modifications, written only to the logs
+     */
+    void submit( VPII & mods, int result );
+
+    /**
+     * Blocks until all submitted solutions are written.
+     */
+    void flush();
+
+    /**
+     * @return modifications in output format - each modification in a separate line, nodes indexed from 1.
+     */
+    static string format( const VPII & mods );
+
+//private:
+
+    void writerLoop();
+
+    /**
+     * Writes given modifications to [file] (through a temporary file).
+     */
+    void write( const VPII & mods );
+
+    string file;
+
+    mutex mtx;
+    condition_variable cv;
+
+    VPII pending; // solution to be written
+    bool has_pending = false;
+    bool writing = false;
+    bool stop = false;
+
+    thread writer;
+};
+
+#endif //ALGORITHMSPROJECT_SOLUTIONWRITER_H
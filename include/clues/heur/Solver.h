@@ -9,6 +9,16 @@
 #include "clues/heur/SwapCandidates/SwapCandidate.h"
 #include "Config.h"
 #include "clues/heur/StateImprovers/NEG.h"
+#include "clues/heur/SwapCandidates/SwpCndNode.h"
+#include "clues/heur/SwapCandidates/SwpCndEdge.h"
+#include "clues/heur/SwapCandidates/SwpCndTriangle.h"
+#include "clues/heur/SwapCandidates/SwpCndEO.h"
+#include "clues/heur/SwapCandidates/ComponentExpansionRepulsion.h"
+#include "clues/heur/SwapCandidates/ComponentExpansionAttraction.h"
+#include "utils/ThreadPool.h"
+#include "datastructures/ObjectArena.h"
+
+class CEKernelizer;
 
 class Solver{
 public:
@@ -49,9 +59,8 @@ public:
     void run_fast();
 
     /**
-     * Craetes and returns a pointer to the newly created NEG object. Depending on current state data (such as
-     * recurrence depth, graph statistics, etc) the NEG can be either NodeEdgeGreedy, NodeEdgeGreedyNomap or
-     * NodeEdgeGreedyW1.
+     * Craetes and returns a pointer to the newly created NEG object (NodeEdgeGreedy) for given state.
+     * If cnf->neg_threads > 1, then NEG evaluates node moves concurrently using [neg_pool].
      */
     NEG* createNegForState(State * st);
 
@@ -75,7 +84,8 @@ public:
 
 
     /**
-     * @return set of edge modifications necessary to obtain best result found by the solver.
+     * @return set of edge modifications necessary to obtain best result found by the solver, sorted
+     * lexicographically. Works in time O( N + E + M log(M) ), where M is the number of modifications.
      */
     VPII getModifications();
 
@@ -159,6 +169,29 @@ public:
      */
     void granulateSolution();
 
+    /**
+     * If [cnf->kernel_cache_file] is set and contains the kernel computed for [origV] with the same kernelization
+     * settings (identified by [variant]), then [partition] is set to the stored CEKernelizer::inCl.
+     * @return true if the kernel was loaded from the cache
+     */
+    bool loadKernelFromCache(int variant);
+
+    /**
+     * Stores the kernel graph and kern.inCl in [cnf->kernel_cache_file], if it is set.
+     */
+    void saveKernelToCache(CEKernelizer & kern, int variant);
+
+    /**
+     * @return key identifying kernel of [origV] created with given kernelization settings
+     */
+    unsigned long long getKernelCacheKey(int variant);
+
+    /**
+     * @return file in which kernel created with given kernelization settings is cached. Each [variant] has its own
+     * file, so that kernels created alternately with different settings do not overwrite each other.
+     */
+    string getKernelCacheFile(int variant);
+
     /**
      * Function used to create cluster graph in each Large iteration. Uses [V] and [partition] to create [clg].
      * Then, for that [clg] a new state [st] is created and used in local search.
@@ -185,6 +218,28 @@ public:
      */
     bool apply_swap_for_candidates( vector<SwapCandidate*> & candidates );
 
+    /**
+     * Sorts candidates by non-decreasing swap value. swpVal() is called once for each candidate, then LSD radix sort
+     * with 8-bit digits is used on values shifted by the minimum (only as many passes as there are bytes in the range
+     * of values). The sort is stable.
+     * Works in time O( n * b ), where b <= 4 is the number of bytes of the range of swap values.
+     */
+    void sortCandidatesBySwpVal( vector<SwapCandidate*> & candidates );
+
+    /**
+     * Helper arrays for [apply_swap_for_candidates], reused between calls so that no memory is allocated there.
+     * Cluster c is affected by already accepted candidates iff cl_stamp[c] == cl_epoch - increasing cl_epoch clears
+     * all marks in O(1).
+     * For c >= st->getIdOfEmptyCluster(), if new_cl_stamp[c] == new_cl_epoch, then new_cl_id[c] is the id of the new
+     * cluster created for target c of the current candidate.
+     */
+    VI cl_stamp, new_cl_stamp, new_cl_id;
+    int cl_epoch = 0, new_cl_epoch = 0;
+
+    VPII to_swap_buffer; // list of moves applied in [apply_swap_for_candidates]
+    vector< pair<unsigned,SwapCandidate*> > sort_items, sort_items_tmp; // used in [sortCandidatesBySwpVal]
+    VLL sort_keys; // sort_keys[i] is swpVal() of i-th candidate, used in [sortCandidatesBySwpVal]
+
     /**
      * Makes some perturbations to [state], e.g. using ComponentExpansionRepulsion, or halving clusters, etc. Options
      * are specified by [cnf]. Perturbation will only be made if nonneg_iter_cnt > 0
@@ -201,6 +256,95 @@ public:
      */
     bool smallIteration(int iter_cnt, int nonneg_iter_cnt = 0);
 
+    /**
+     * Results of a single run of a swap candidate creator in [smallIteration]. Candidates are kept by value in typed
+     * vectors. Expansion orders (swap candidates keep pointers to them) are created in arenas.
+     * All of it is freed at once by [clear], which keeps allocated memory, so the object can be reused.
+     */
+    struct SwpCndCreatorResults{
+        string name; // name of the creator, used in [local_search_creator_calls] and TimeMeasurer
+        bool negative = false; // true if a candidate with negative swap value was found
+
+        vector<SwpCndNode> res_node;
+        vector<SwpCndEdge> res_edge;
+        vector<SwpCndTriangle> res_triangle;
+        vector<SwpCndEO> res_eo;
+        vector<SwpCndEORepulsion> res_eo_rep;
+        vector<SwpCndEOAttraction> res_eo_attr;
+
+        ObjectArena<ExpansionOrder> exp_orders_arena;
+        vector<ExpansionOrder*> exp_orders; // pointers to orders in [exp_orders_arena]
+        ObjectArena<ExpansionOrderAttraction> attr_orders;
+        ObjectArena<ExpansionOrderRepulsion> rep_orders;
+
+        /**
+         * Appends pointers to all candidates to [candidates].
+         */
+        void collectCandidates( vector<SwapCandidate*> & candidates );
+
+        void clear();
+    };
+
+    /**
+     * Arena of results of swap candidate creators run in [smallIteration]. The k-th creator run since candidates were
+     * last cleared stores its results in creator_results[k] - a deque is used, so that references to its elements stay
+     * valid when new ones are added. Results are cleared at the end of each smallIteration (or earlier, unless
+     * cnf->keep_all_swap_candidates is set) and reused in next calls, so candidates and orders are not allocated
+     * separately in each call.
+     */
+    deque<SwpCndCreatorResults> creator_results;
+    int creator_results_used = 0; // number of elements of [creator_results] in use
+
+    /**
+     * @return next unused element of [creator_results], creating it if necessary.
+     */
+    SwpCndCreatorResults & nextCreatorResults();
+
+    /**
+     * Runs swap candidate creator [cr_id] for state [st] and stores created candidates in [res].
+     * State [st] is not modified (except for creation of st->cl_neigh_graph, if it was not created earlier), so many
+     * creators can run concurrently for the same state, provided that st->cl_neigh_graph is created beforehand.
+     * Does not support [node] creator - NEG modifies the state.
+     *
+     * @return false if time limit was exceeded, true otherwise
+     */
+    bool runSwpCndCreator( SwpCndCrId cr_id, SwpCndCreatorResults & res );
+
+    /**
+     * Pool used to run swap candidate creators concurrently in [smallIteration], if cnf->solver_creator_threads > 1.
+     * Created when first needed.
+     */
+    ThreadPool * creators_pool = nullptr;
+
+    /**
+     * Pool used to create expansion orders concurrently, if cnf->solver_eo_threads > 1. It cannot be the same as
+     * [creators_pool], because SwpCndEOCreator may itself be run by a task of [creators_pool].
+     */
+    ThreadPool * eo_pool = nullptr;
+
+    /**
+     * Pool used by NEGs created in [createNegForState], if cnf->neg_threads > 1. Created when first needed, unless it
+     * was given using [setNegPool]. Sub-solvers get the pool of their parent, so that a single pool is used in the
+     * whole recursion.
+     */
+    ThreadPool * neg_pool = nullptr;
+    bool owns_neg_pool = false;
+
+    /**
+     * Sets [neg_pool] to [pool]. The pool is not owned by the solver.
+     */
+    void setNegPool( ThreadPool * pool ){ neg_pool = pool; owns_neg_pool = false; }
+
+    /**
+     * @return [neg_pool], creating it first if necessary.
+     */
+    ThreadPool * getNegPool();
+
+    /**
+     * Pool used in [createClusterGraph], if cnf->cluster_graph_threads > 1. Created when first needed.
+     */
+    ThreadPool * clg_pool = nullptr;
+
     /**
      * Creates the partition of original graph [origV] for given state [st]. Reads clusters from the state, then joins
      * all nodes from the same cluster to common partition.
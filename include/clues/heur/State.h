@@ -30,8 +30,9 @@ public:
      * By default, RANDOM_MATCHING initialization method is preferred.
      * @param clg
      * @param init_type
+     * @param ws workspace with helper arrays. It should not be used by other threads as long as this state exists.
      */
-    State( ClusterGraph& clg, StateInitializationType init_type = RANDOM_MATCHING );
+    State( ClusterGraph& clg, StateInitializationType init_type = RANDOM_MATCHING, Workspace & ws = Workspace::local() );
 
     /**
      * Resets all arrays - fill with 'initializer' values.
@@ -48,9 +49,14 @@ public:
     /**
      * Applies swap for given nodes - moves to_swap[i].first from its cluster to cluster to_swap[i].second
      *
+     * Only clusters from which nodes are moved and clusters to which nodes are moved are rebuilt (induced again). If
+     * a cluster becomes empty, then the last nonempty cluster takes its id. [inCl], [idInCl] and [degInCl] are updated
+     * only for nodes in affected clusters. [cl_neigh_graph] (if it was created) is updated incrementally - for each
+     * edge (v,u) of a moved node v only two entries of u are changed (see [updateClNeighGraphEntry]).
+     * Works in time O( \sum deg(v) ), where sum runs over all nodes in affected clusters.
+     *
      * CAUTION!
-     * Changes the whole structure of state, clusters and all arrays. It works by creating completely new state, then
-     * merges clusters properly.
+     * Ids of clusters may change, so all swap candidates created before calling this function are invalidated.
      *
      * If there are some sets of nodes that should be moved to separate new clusters, then corresponding nodes should
      * have marked to_swap[i].second value at least getIdOfEmptyCluster()
@@ -75,11 +81,10 @@ public:
      *
      * An empty cluster is added to the end of [clusters].
      *
-     * ************ !!!!!!!!!!!!!1 *************
-     * CAUTION!!! [cl_neigh_graph] structure is invalidated !!!
-     * ************ !!!!!!!!!!!!!1 *************
+     * Ids of clusters may change, so [cl_neigh_graph] structure is cleared - it is created lazily by its users
+     * (see [createClNeighGraph]).
      *
-     * Works in time O( N +  \sum deg(v) ), where sum runs over all nodes in merged clusters
+     * Works in time O( N + E )
      * @param c1
      * @param c2
      */
@@ -91,6 +96,23 @@ public:
      */
     void createClNeighGraph();
 
+    /**
+     * Recreates list cl_neigh_graph[v] for current assignment of nodes to clusters. Works in time O(deg(v) log deg(v))
+     */
+    void updateClNeighGraphForNode( int v );
+
+    /**
+     * Adds [dw] to the weight of pair (c,w) in cl_neigh_graph[v], creating the pair if necessary and removing it if
+     * its weight drops to 0. The pair is then moved to keep the list sorted.
+     * Works in time O( cl_neigh_graph[v].size() ), lists are usually very short.
+     */
+    void updateClNeighGraphEntry( int v, int c, int dw );
+
+    /**
+     * Changes id of cluster [old_id] to [new_id] in cl_neigh_graph[v], keeping the list sorted.
+     */
+    void renameClusterInClNeighGraph( int v, int old_id, int new_id );
+
     int getIdOfEmptyCluster(){ assert( !clusters.empty() ); return clusters.size()-1; }
 
     friend ostream& operator<<(ostream& str, State& st);
@@ -141,7 +163,9 @@ public:
      * w is the sum of weights of edges with one end in i and the other in cluster cl.
      *
      * Cluster inCl[i] is NOT included in cl_neigh_graph[i] list.
-     * For each i pairs (cl,w) should be sorted by non-increasing w
+     * For each i pairs (cl,w) should be sorted by non-increasing w (and by increasing cl for equal w)
+     *
+     * It is created in the constructor and in [mergeClusters], and it is updated incrementally in [applySwap].
      *
      * This is used to quickly find cluster neighbors of given node.
      */
@@ -152,10 +176,10 @@ public:
      */
     VLL hashes;
 
-
-    VB was, was2, was3; // 'Global' helper arrays of size N
-    VI marker; // helper int array
-//    VVI marker2; // helper VVI array
+    /**
+     * Workspace with helper arrays. It is shared with clusters, creators and NEGs created for this state.
+     */
+    Workspace* ws;
 };
 
 #endif //CESWAT_STATE_H
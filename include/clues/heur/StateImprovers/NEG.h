@@ -9,6 +9,10 @@
 #include <clues/heur/Config.h>
 #include "clues/heur/State.h"
 #include "clues/heur/SwapCandidates/SwapCandidate.h"
+#include "graphs/CSRGraph.h"
+#include "datastructures/GainBuckets.h"
+#include "utils/ThreadPool.h"
+#include "clues/heur/ConvexHullTrickStatic.h"
 
 /**
  * Algorithm works in iterations.
@@ -20,13 +24,16 @@
  * If during whole iteration no improvement was found, algorithm stops.
  *
  *
- * This is a base class from which NodeEdgeGreedy, NodeEdgeGreedyNoamp and NodeEdgeGreedyW1 can inherit to
- * implement their versions of solutions
+ * This is a base class from which NodeEdgeGreedy inherits to implement its version of solution
  */
 class NEG{
 public:
 
-    NEG( State & st );
+    /**
+     * @param ws workspace with helper arrays [helper], [helper2], [helper_was], [helper_was2], [helper_was3]. By default
+     * workspace of the calling thread is used. NEGs that run concurrently must use different workspaces.
+     */
+    NEG( State & st, Workspace & ws = Workspace::local() );
 
     virtual ~NEG(){}
 
@@ -156,6 +163,12 @@ public:
     ClusterGraph *clg; // st.clg;
     int N; // clg.V.size()
 
+    /**
+     * The same structure as clg->V, but in CSR format - it is used instead of clg->V.
+     * Only this structure is shuffled in [shuffleClg], clg->V is not modified.
+     */
+    CSRGraph<PII> clgV;
+
     //****************************************  PERTURBATIONS   ************************
     /**
      * Maximum number of perturbations made.
@@ -195,11 +208,187 @@ public:
 
     /**
      * Checks all nodes from perm[a], perm[a+1], ..., perm[b], then returns best move in the form
-     * (node, cluster, swap_value)
+     * (node, cluster, swap_value). Best move of each node is found using [getBestNodeMove], so node_move_cache is used.
+     * If there are many best moves, then a random one of them is returned (see prefer_cluster_mode).
      */
-    virtual tuple<int,int,int> getBestNodeMoveForRange( VI & perm, int a, int b ) = 0;
+    virtual tuple<int,int,int> getBestNodeMoveForRange( VI & perm, int a, int b );
     vector<tuple<int,int,int>> best_node_move_results;
 
+    /**
+     * Finds the best move of node v: sets [to] to the target cluster (or -1 if v cannot be moved) and [val] to its
+     * swap value. [empty_cl] is the empty cluster considered as target.
+     * If [ties] is not null and [val] <= [ties_max_val], then [ties] contains all target clusters of moves of v with
+     * swap value [val] (in the order in which they were found).
+     * Nothing is modified other than [ties], so it can be called concurrently for different nodes.
+     *
+     * Base implementation copies getEdgesToCluster(v) and calls [evaluateNodeMoveToClusters]. Classes that keep
+     * edges to clusters in contiguous memory should override it and pass them directly.
+     */
+    virtual void evaluateNodeMove( int v, int empty_cl, int & to, int & val, VI * ties = nullptr,
+                                   int ties_max_val = 1e9 );
+
+    /**
+     * The same as [evaluateNodeMove], but clusters neighboring to v are given as pairs
+     * items[i] = (cluster id, sum of weights of edges between v and that cluster), i in [0,n). Cluster inCl[v] may be
+     * among them. For large [n] the best target is found using SwapValueKernels::argminMoveValuePairs().
+     */
+    void evaluateNodeMoveToClusters( int v, const PII* items, int n, int empty_cl, int & to, int & val,
+                                     VI * ties = nullptr, int ties_max_val = 1e9 );
+
+    /**
+     * The same as [evaluateNodeMove], but if node_move_cache contains a valid entry for v, then it is returned
+     * (in that case [ties] contains only that move). Otherwise the move is evaluated and cached.
+     * Only the entry of v in node_move_cache is modified, so it can be called concurrently for different nodes.
+     */
+    void getBestNodeMove( int v, int empty_cl, int & to, int & val, VI * ties = nullptr, int ties_max_val = 1e9 );
+    VI node_move_ties;
+
+    /**
+     * Cache of best moves of single nodes, used by getBestNodeMove().
+     * Entry node_move_cache[v] is valid if neither v nor any of its neighbors was moved, and weights of the cluster
+     * of v and of the target cluster did not change since the entry was created - then the swap value of that move
+     * did not change either. In late iterations most nodes are not affected by moves, so they need not be checked.
+     *
+     * #CAUTION! Some other move of v may become better than the cached one, if some cluster neighboring to v, but not
+     * containing neighbors of v, loses weight. To avoid stopping in such a 'false' local optimum, the cache is
+     * cleared before the last nonnegative iteration in improve().
+     */
+    struct NodeMoveCacheEntry{
+        int to, val; // best move of v (to == -1 if v cannot be moved) and its swap value
+        int node_ver, cl_ver, to_ver, epoch; // versions at the moment the entry was created
+    };
+    vector<NodeMoveCacheEntry> node_move_cache;
+
+    /**
+     * node_move_ver[v] is increased when v or any of its neighbors is moved. cluster_move_ver[c] is increased when
+     * weight of cluster c changes. Increasing node_move_cache_epoch invalidates all entries.
+     */
+    VI node_move_ver, cluster_move_ver;
+    int node_move_cache_epoch = 0;
+
+    /**
+     * If true, then node_move_cache is used in getBestNodeMove(). Classes need to call [invalidateNodeMoveCache] in
+     * moveNodeTo().
+     */
+    bool use_node_move_cache = true;
+
+    /**
+     * Cache is used only for nodes with at least that many neighbors. For nodes with fewer of them checking the cache
+     * entry costs about as much as finding the move again (on sparse graphs it made NEG ~15% slower).
+     */
+    int node_move_cache_min_size = 16;
+
+    /**
+     * If entry for node v is valid, sets [to] and [val] and returns true. Otherwise returns false.
+     */
+    bool getCachedNodeMove( int v, int & to, int & val );
+    void cacheNodeMove( int v, int to, int val );
+
+    /**
+     * Invalidates cache entries affected by moving node v from cluster [from] to cluster [to].
+     */
+    void invalidateNodeMoveCache( int v, int from, int to );
+    void clearNodeMoveCache(){ node_move_cache_epoch++; }
+
+    /**
+     * If true, then nodes are not processed in the order of a random permutation. Instead, as in Fiduccia-Mattheyses
+     * heuristic, nodes are kept in [gain_buckets], keyed by the swap value of their best move, and in each iteration
+     * nodes are taken from the most negative bucket. Buckets are filled once - after each move only keys of the moved
+     * node and its neighbors are updated (and of nodes of affected clusters, if queue propagation is used), see
+     * [updateGainBuckets].
+     * If only node moves are checked in an iteration, then the iteration ends when all remaining keys are greater than
+     * perturb_swp_thr, so nodes that cannot be moved are not checked at all.
+     *
+     * #CAUTION! Keys of nodes whose swap values changed due to moves of non-neighbors (a change of the weight of
+     * some cluster) are not updated - such nodes may be taken too early or too late, but they are checked exactly
+     * when taken. To avoid stopping in a 'false' local optimum, buckets are filled again whenever node_move_cache is
+     * cleared in improve().
+     */
+    bool use_gain_buckets = false;
+    GainBuckets gain_buckets;
+
+    /**
+     * If false, then all nodes are evaluated and inserted to [gain_buckets] at the beginning of the next iteration.
+     */
+    bool gain_buckets_filled = false;
+
+    /**
+     * gain_key[v] is the swap value of the best move of v when v was evaluated the last time, decreased after moves of
+     * neighbors of v, so that it is a lower bound on the current swap value (up to moves of non-neighbors).
+     * Nodes taken from buckets in current iteration are in [gain_taken_nodes] - they are inserted back at the beginning
+     * of the next iteration (or earlier, if they get a negative key).
+     */
+    VI gain_key;
+    VI gain_taken_nodes;
+    VB gain_taken;
+
+    /**
+     * Moves (node, from, to) done since the last call to [updateGainBuckets]. Classes that support gain buckets need
+     * to add moves here in moveNodeTo().
+     */
+    vector<tuple<int,int,int>> gain_moved_nodes;
+    VI gain_stamp; // gain_stamp[v] == gain_stamp_id if v was already evaluated in current call to updateGainBuckets()
+    int gain_stamp_id = 0;
+
+    /**
+     * Number of nodes evaluated to update [gain_buckets].
+     */
+    LL gain_evaluations = 0;
+
+    /**
+     * Prepares [gain_buckets] for a new iteration - fills them with all nodes (in reverse order of [perm], so that nodes
+     * with equal keys are taken in the order of perm), or updates them after moves done since the last iteration and
+     * inserts back nodes taken in the last iteration.
+     */
+    void startGainBucketsIteration( VI & perm );
+
+    /**
+     * Evaluates the best move of node v and updates its key, if v is in gain buckets. If v was already taken from
+     * buckets in current iteration, then it is inserted back only if its best move has negative swap value - otherwise
+     * zero-valued moves could be repeated forever.
+     */
+    void scheduleNodeInGainBuckets( int v );
+
+    /**
+     * Updates keys after moves from [gain_moved_nodes]. Moved nodes and their neighbors that were already taken in
+     * current iteration are evaluated again (each at most once). For other neighbors, no evaluation is needed - when
+     * node v with weight nv moves from cluster A to B, the swap value of moving neighbor p (weight np, edge weight w)
+     * to any cluster decreases by at most:
+     *      2w - np*nv or 4w - 2*np*nv if p is in A,
+     *      2*np*nv - 4w or np*nv - 2w if p is in B,
+     *      |np*nv - 2w| otherwise
+     * so its key is decreased by that much.
+     */
+    void updateGainBuckets();
+
+    /**
+     * If not null, then in each iteration, before the sequential pass, moves of nodes are evaluated concurrently using
+     * this pool (see [makeParallelNodeMoves]). The pool is not owned by NEG.
+     */
+    ThreadPool * pool = nullptr;
+    int parallel_batch_size = 4096;
+
+    /**
+     * Processes nodes from [perm] in batches of [parallel_batch_size] nodes. For each batch, best moves of all nodes
+     * are first evaluated concurrently (this phase only reads the state), then a maximal set of moves with negative
+     * swap values, such that no two of them touch the same cluster (as source or target), is applied sequentially,
+     * taking moves with smaller swap values first. Swap values of moves with pairwise disjoint clusters do not depend
+     * on each other, so all of them remain exact.
+     * Moves that were not applied due to conflicts are found again in the sequential pass.
+     *
+     * Best moves are found using [getBestNodeMove], so evaluateNodeMove() of derived classes needs to be thread-safe.
+     *
+     * @return true if any move was applied
+     */
+    virtual bool makeParallelNodeMoves( VI & perm );
+
+    /**
+     * Helper arrays for [makeParallelNodeMoves]. batch_to[i] and batch_val[i] is the best move of i-th node in the
+     * batch. Cluster c is touched by a move in the current batch if cluster_batch[c] == batch_id.
+     */
+    VI batch_to, batch_val, batch_order, cluster_batch;
+    int batch_id = 0;
+
     /**
      * For given node v, checks all cluster, to which v has sum of edge weights at least [PERC] that cluster weight.
      * Then for each node u in that cluster, it checks, whether interchanging nodes v and u would be profitable.
@@ -243,7 +432,7 @@ public:
      * Adds all nodes in cluster with given id [cl_id] to [queue].
      * @param cl_id
      */
-    void addClusterNodesToQueue( int cl_id );
+    virtual void addClusterNodesToQueue( int cl_id );
 
     /**
      *  Checks all edges with one end in { perm[a], perm[a+1], ..., perm[b] }, then returns best move in the form
@@ -262,6 +451,12 @@ public:
      */
     const bool USE_HULL_TRICK_IN_EDGE_SWAPS = true;
 
+    /**
+     * Hull used in [getBestEdgeMoveForRange]. All lines for node u are added before the first query, so the static
+     * hull is enough. It is a member, so that its memory is reused for all nodes.
+     */
+    ConvexHullTrickStatic edge_swap_hull;
+
     /**
      * Moves edge (v,w) to cluster [to]. Calls twice function [moveNodeTo].
      */
@@ -299,8 +494,10 @@ public:
     int best_result = 1e9;
     int initial_result = 1e9;
 
-    VI helper, helper2; // helper array;
-    VB helper_was, helper_was2, helper_was3;
+    Workspace* ws; // workspace with helper arrays below
+
+    VI &helper, &helper2; // helper array, taken from [ws]
+    VB &helper_was, &helper_was2, &helper_was3; // taken from [ws]
 
     /**
      * If true, then if there should be perturbations done, they are not done if the result was improved. That is
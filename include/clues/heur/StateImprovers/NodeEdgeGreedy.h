@@ -9,6 +9,7 @@
 #include "clues/heur/State.h"
 #include "clues/heur/SwapCandidates/SwapCandidate.h"
 #include "NEG.h"
+#include "datastructures/AdaptiveIntMap.h"
 
 /**
  * Algorithm works in iterations.
@@ -22,7 +23,7 @@
 class NodeEdgeGreedy : public NEG{
 public:
 
-    NodeEdgeGreedy( State & st );
+    NodeEdgeGreedy( State & st, Workspace & ws = Workspace::local() );
 
     virtual void initializeForState(State & st) override;
     virtual void improve() override;
@@ -33,7 +34,22 @@ public:
     int countNonemptyClusters() override;
     virtual void resizeStructuresForEmptyCluster( int empty_cl ) override;
 
-    vector< unordered_set<int> > cluster_nodes;
+    /**
+     * cluster_nodes[c] is the list of nodes in cluster c. Node v is at position pos_in_cluster[v] of
+     * cluster_nodes[ inCl[v] ], so that it can be removed in O(1) time.
+     *
+     * Lists are updated in moveNodeTo() only if queue propagation is used (they are needed after each move then).
+     * Otherwise they are needed only between iterations, so moveNodeTo() just sets [cluster_nodes_valid] to false and
+     * lists are recreated in [updateClusterNodes] - on sparse graphs updating them took a large part of each move.
+     */
+    VVI cluster_nodes;
+    VI pos_in_cluster;
+    bool cluster_nodes_valid = false;
+
+    /**
+     * Recreates [cluster_nodes] if they are not valid. Needs to be called before [cluster_nodes] are used.
+     */
+    void updateClusterNodes();
 
 
     int countClusterNumerationGaps() override;
@@ -43,18 +59,16 @@ public:
 
     /**
      * edges_to_cluster[v] is a map such that edges_to_cluster[v][cl] is the number of edges between node v and cluster
-     * cl.
+     * cl. AdaptiveIntMap keeps small maps inline and switches to a hash table for large ones, so this works well both
+     * for sparse and for dense graphs.
      */
-    vector< unordered_map<int,int,quick_hash> > edges_to_cluster;
-//    vector< unordered_map<int,int> > edges_to_cluster;
-//    vector< unordered_map<int,int,quick_hash> > edges_to_cluster;
-//    vector< map<int,int> > edges_to_cluster;
+    vector< AdaptiveIntMap<> > edges_to_cluster;
 
     /**
-     * Checks all nodes from perm[a], perm[a+1], ..., perm[b], then returns best move in the form
-     * (node, cluster, swap_value)
+     * Checks moves of v to all clusters in edges_to_cluster[v] and to the empty cluster.
      */
-    virtual tuple<int,int,int> getBestNodeMoveForRange( VI & perm, int a, int b ) override;
+    void evaluateNodeMove( int v, int empty_cl, int & to, int & val, VI * ties = nullptr,
+                           int ties_max_val = 1e9 ) override;
 
 
     virtual SwapCandidateAdapter getBestTriangleAll(int v) override;
@@ -74,6 +88,11 @@ public:
     VI getClusterNodes(int c) override;
 
     int maxClusterId() override;
+
+    void addClusterNodesToQueue(int cl_id) override;
+
+    void addToCluster(int v, int c);
+    void removeFromCluster(int v, int c);
 };
 
 #endif //ALGORITHMSPROJECT_NODEEDGEGREEDY_H
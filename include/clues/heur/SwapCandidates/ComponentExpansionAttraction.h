@@ -7,6 +7,8 @@
 
 #include "clues/heur/ExpansionOrder.h"
 #include "SwapCandidate.h"
+#include "datastructures/IndexedHeap.h"
+#include "datastructures/ObjectArena.h"
 
 class ExpansionOrderAttraction{
 public:
@@ -31,6 +33,9 @@ public:
         return StandardUtils::zip(nodes, move_to);
     }
 
+    int swapSize() override{ return k+1; }
+    PII swapAt( int i ) override{ return { eo->ord[i], eo->cl->id }; }
+
     VI getNodes(){ return StandardUtils::getSubarray(eo->ord,0,k); }
     VI getMoveNodesTo(){ return VI(k+1, eo->cl->id); } // all nodes are moved to cluster eo->cl
     virtual LL swpVal(){ return swap_value; }
@@ -68,6 +73,9 @@ public:
  * It is possible (perhaps) to keep a binary search tree (just a set) for swap values calculated for best representatives of
  * all possible node_weights, to replace sqrt(C) factor by logC factor.
  *
+ * All helper structures are flat arrays allocated in the constructor and cleared in time proportional to the number
+ * of touched entries, so that calling createSwapCandidates(Cluster&) for many clusters does not allocate memory (apart
+ * from the returned expansion order and candidates).
  */
 class ComponentExpansionAttraction{
 public:
@@ -87,7 +95,7 @@ public:
      *
      * @return a pair containing pointer to the dynamically allocated ExpansionOrderAttraction and a vector of swap
      * candidates. Those swap candidates store pointers to the EOA. Given EOA need to be deleted after when no longer
-     * used, in order to avoid memory leak.
+     * used, in order to avoid memory leak (unless it was created in [arena]).
      */
     pair<ExpansionOrderAttraction*, vector<SwpCndEOAttraction> > createSwapCandidates(Cluster& cl);
 
@@ -131,14 +139,37 @@ public:
     VI cl_neigh;
 
     /**
-     * 'set' of different cluster weights among all neighboring clusters of S
+     * nw_count[x] is the number of nodes v \notin S with nw_v = x in neighboring clusters of S.
+     * nw_list contains all x such that nw_count[x] > 0, nw_pos[x] is the index of x in nw_list.
      */
-    unordered_map<int,int> node_neigh_weights;
+    VI nw_count, nw_list, nw_pos;
 
     // ************************************************************
 
     /**
-     * cluster_cores[x] is the set that contains pairs (free_value,v) for all nodes v \notin S with nw_v = x.
+     * free_val[v] is the 'free value' of node v \notin S, see [getFreeValue]. It is kept up to date for all nodes in
+     * [cluster_cores].
+     */
+    VI free_val;
+
+    /**
+     * heap_pos[v] is the position of v in cluster_cores[nw_v] (or -1).
+     */
+    VI heap_pos;
+
+    /**
+     * Nodes are ordered by pairs (free_val[v], v).
+     */
+    struct CoreCmp{
+        ComponentExpansionAttraction* cea = nullptr;
+        bool operator()( int a, int b ) const{
+            if( cea->free_val[a] != cea->free_val[b] ) return cea->free_val[a] < cea->free_val[b];
+            return a < b;
+        }
+    };
+
+    /**
+     * cluster_cores[x] is the heap that contains all nodes v \notin S with nw_v = x, ordered by (free_value,v).
      *
      * swap value for node u is the following:
      * nw_u * ( sumNWinS - cluster_weights[c] ) + 2*edges_in_cl[u] - 2*eToS[u] + (nw_u)^2
@@ -148,7 +179,7 @@ public:
      *
      * in sorted order, we are able to quickly node that minimizes its swap value (among all nodes with given nw_u).
      */
-    vector< set<PII> > cluster_cores;
+    vector< IndexedHeap<CoreCmp> > cluster_cores;
 
     /**
      * Calculates and returns 'free value' for given node d.
@@ -159,15 +190,16 @@ public:
 
 
     /**
-     * Removes/inserts all neighbors of node [node_to_move] from [cluster_cores]. It is necessary to remove all
-     * neighbors of moved node, before moving the node, because otherwise we could not calculate the 'free value' used
-     * as key to store nodes in sets.
-     * It also removes/insert all nodes that are in the same cluster as [node_to_move]. Since the density of each
-     * cluster should be at least 0.5, this is not a worry.
-     *
-     * @param insert if true, then entry if node u will be inserted, otherwise it will be erased.
+     * Adds node d to cluster_cores[nw_d].
      */
-    void modifyNodeEntryInClusterCores( int node_to_move, bool insert );
+    void addToClusterCores( int d );
+
+    /**
+     * Updates free values and positions in [cluster_cores] of all neighbors of node [moved] and all nodes that are
+     * in the same cluster as [moved]. Since the density of each cluster should be at least 0.5, this is not a worry.
+     * Should be called after [moved] is moved to S.
+     */
+    void updateClusterCores( int moved );
 
     /**
      * Finds node u that should be moved to S.
@@ -179,7 +211,12 @@ public:
     /**
      * Set to which nodes are attracted.
      */
-    unordered_set<int> S;
+    VI S;
+
+    /**
+     * Buffers for the expansion order and swap values, reused between calls.
+     */
+    VI ord, swpvals;
 
     /**
      * cluster_weights[i] is the weight of cluster st->clusters[i]. This value is changing during node attraction
@@ -197,6 +234,12 @@ public:
      * If true, then only those swap candidates (  ord[0], ord[1], ... , ord[k] ) for which swpval <= 0 will be kept.
      */
     bool keep_only_nonpositive_candidates = true;
+
+    /**
+     * If not nullptr, then expansion orders are created in [arena] (and must not be deleted by the caller), otherwise
+     * they are allocated with new.
+     */
+    ObjectArena<ExpansionOrderAttraction>* arena = nullptr;
 };
 
 
@@ -7,7 +7,8 @@
 
 
 #include <clues/heur/ExpansionOrder.h>
-#include "datastructures/Heap.h"
+#include "datastructures/IndexedHeap.h"
+#include "datastructures/ObjectArena.h"
 #include "SwapCandidate.h"
 
 class ExpansionOrderRepulsion{
@@ -42,6 +43,8 @@ public:
     SwpCndEORepulsion( ExpansionOrderRepulsion * eo, int k, int swap_value, LL hash );
 
     VPII getNodesToSwap() override;
+    int swapSize() override{ return k+1; }
+    PII swapAt( int i ) override{ return { eo->ord[i], eo->move_to[i] }; }
 
     VI getNodes(){ return StandardUtils::getSubarray(eo->ord,0,k); }
     VI getMoveNodesTo(){ return StandardUtils::getSubarray(eo->move_to,0,k); }
@@ -64,8 +67,9 @@ public:
  * nw_u * (nw_c - sumNWinS) + nw_u^2 - 2*edges_to_cluster[u][c] + 2*eInS[u].
  * Since  -nw_u * sumNWinS + nw_u^2 + 2*eInS[u] is independent of c, for fixed u we can select cluster c that minimizes
  * nw_u * nw_c - 2*edges_to_cluster[u][c].    <--- core value
- * We keep those core values for each node u to each of the clusters, where given node u has neighbors.
- * This way, for given u, we can in O(1) access the cluster to which it is best to move it.
+ * We keep those core values for each node u to each of the clusters, where given node u has neighbors, in an indexed
+ * heap of node u. This way, for given u, we can in O(1) access the cluster to which it is best to move it.
+ * All structures are flat arrays, reused between calls for different clusters.
  * Whenever node u is moved from S to some cluster c, then core_value[v][c] for all remaining v \in S nodes are updated.
  *
  * Nodes in S will be updated at most S.size() times.
@@ -101,7 +105,7 @@ public:
      * swap candidate
      *
      * @return pair containing expansion order and a vector of candidates.      CAUTION!!!!!! Order needs to be deleted
-     * after using to avoid memory leak.
+     * after using to avoid memory leak (unless it was created in [arena]).
      */
     pair<ExpansionOrderRepulsion*, vector<SwpCndEORepulsion> > createSwapCandidates(Cluster& cl);
 
@@ -137,71 +141,94 @@ public:
 
     // ************************************************************
 
-    struct ClusterSet{
-        ClusterSet( ComponentExpansionRepulsion* cer, int v, int c ){ this->cer = cer; this->v = v; this->c = c; }
-        bool operator<( const ClusterSet& oth ) const{
-            assert( v == oth.v );
-            int core1 =  cer->swpval_core_for_node[v][c];
-            int core2 = cer->swpval_core_for_node[v][oth.c];
-            if( core1 != core2 ) return core1 < core2;
-            else if( cer->cluster_weights[c] != cer->cluster_weights[oth.c] ){
-                // we return smaller set as the better candidate
-                return cer->cluster_weights[c] < cer->cluster_weights[oth.c] ;
+    /**
+     * Swap value core for moving node u \in S to cluster c is kept in an 'entry'. Entries are stored in flat arrays
+     * indexed by entry id: ent_node[e] is the node u, ent_cl[e] is the cluster c, ent_E[e] is the sum of weights of
+     * edges from u to c and ent_core[e] is the core value nw_u * cluster_weights[c] - 2*ent_E[e].
+     * We cannot store exact swap values because each time we remove node from S we would have to update ALL nodes
+     * remaining in S for ALL neighboring cluster. This would lead to O( S^2*D ) complexity, where D is the maximum
+     * number of node in S. By keeping only the core, we do not know the exact value of swap value, but we have access
+     * in O(1) time to cluster to which given node from S has minimal swap value. Knowing that cluster we can in O(1)
+     * calculate that swap value. This lead to O(S) complexity instead of O(S*D) for finding best choice for move.
+     * Thus we get complexity O( S^2 * logD ).
+     */
+    VI ent_node, ent_cl, ent_E, ent_core;
+
+    /**
+     * ent_pos[e] is the position of entry e in heaps[ st->idInCl[ ent_node[e] ] ], or -1 if it is not in a heap.
+     */
+    VI ent_pos;
+
+    /**
+     * Entries are ordered by core value, then by weight of the cluster (we return smaller set as the better
+     * candidate), then by id of the cluster.
+     */
+    struct EntryCmp{
+        ComponentExpansionRepulsion* cer = nullptr;
+        bool operator()( int a, int b ) const{
+            if( cer->ent_core[a] != cer->ent_core[b] ) return cer->ent_core[a] < cer->ent_core[b];
+            int ca = cer->ent_cl[a], cb = cer->ent_cl[b];
+            if( cer->cluster_weights[ca] != cer->cluster_weights[cb] ){
+                return cer->cluster_weights[ca] < cer->cluster_weights[cb];
             }
-            else return c < oth.c; // we return cluster with larger id
+            return ca < cb;
         }
-        bool operator==( const ClusterSet& oth ) const{ return cer == oth.cer && v == oth.v && c == oth.c; }
-        ComponentExpansionRepulsion* cer;
-        int v,c;
-        friend ostream& operator<<(ostream& oth, ClusterSet& cs);
     };
 
     /**
-     * cluster_sets[v] is a set of pairs (swpval,i) such that moving node v to cluster i results in swap value swpval.
-     * This is used to quickly access best cluster to which node v should be moved
+     * heaps[ st->idInCl[u] ] contains all entries of node u \in S. This is used to quickly access best cluster to which
+     * node u should be moved.
      */
-    vector< set<ClusterSet> > cluster_sets;
+    vector< IndexedHeap<EntryCmp> > heaps;
 
     /**
-     * swpval_for_node[v][c] is the core for swap value of moving node v to cluster c. We cannot store exact swap
-     * values because each time we remove node from S we would have to update ALL nodes remaining in S for ALL
-     * neighboring cluster. This would lead to O( S^2*D ) complexity, where D is the maximum number of node in S.
-     * By keeping only the core, we do not know the exact value of swap value, but we have access in O(1) time to
-     * cluster to which given node from S has minimal swap value. Knowing that cluster we can in O(1) calculate that
-     * swap value. This lead to O(S) complexity instead of O(S*D) for finding best choice for move. This comes, however,
-     * at a cost of slightly increased constant and O(logD) update time for each of up to S^2 updates.
-     * Thus we get complexity O( S^2 * logD ).
+     * cl_local[c] is the index of cluster c in [cl_neigh], or -1 if c is not a neighbor of [cl].
      */
-    vector< unordered_map<int,int> > swpval_core_for_node;
+    VI cl_local;
 
     /**
-     * Updates swap value core for moving node u \in S to cluster c.
+     * cl_entries[ cl_local[c] ] contains ids of all entries with ent_cl[e] == c (also for nodes already moved out of S).
      */
-    void updateSwpValCoreForNode(int u, int c );
+    VVI cl_entries;
 
     /**
-     * Finds pair (u,c) - node u \in S and cluster c such that u should be moved to c.
+     * Helper array. While cluster c is updated, entry_of[u] is the entry of pair (u,c), or -1 if it does not exist
+     * yet. Only nodes in S can be set, so S is the list of touched entries used to reset it.
      */
-    PII getNodeToMove();
+    VI entry_of;
 
-    // ************************************************************
+    /**
+     * Adds cluster c as a neighbor of [cl].
+     */
+    void addNeighborCluster( int c );
 
     /**
-     * Expanded set.
+     * Creates entry for pair (u,c) with ent_E == E. Entry is not added to the heap.
+     * @return id of the created entry
      */
-    unordered_set<int> S;
+    int addEntry( int u, int c, int E );
 
     /**
-     * cluster_weights[i] is the weight of cluster st->clusters[i]. This value is changing during 'repulsion
+     * Updates swap value core of all nodes in S for moving them to cluster c.
      */
-    VI cluster_weights;
+    void updateSwpValCores( int c );
 
     /**
-     * For v \in cl.g.nodes we have edges_to_cluster[v][c] is the sum of weights of edges of node v to cluster c
+     * Finds entry for pair (u,c) - node u \in S and cluster c such that u should be moved to c.
      */
-    vector< unordered_map<int,int> > edges_to_cluster;
+    int getNodeToMove();
 
-    VB was, was2, was3; // helper arrays
+    // ************************************************************
+
+    /**
+     * Expanded set. Nodes are kept in the order in which they appear in cl->g.nodes.
+     */
+    VI S;
+
+    /**
+     * cluster_weights[i] is the weight of cluster st->clusters[i]. This value is changing during 'repulsion
+     */
+    VI cluster_weights;
 
     /**
      * Moves node v from S to cluster c
@@ -209,9 +236,10 @@ public:
     void moveNodeTo(int v, int c);
 
     /**
-     * Calculates and returns swap value for moving node u to cluster c
+     * Calculates and returns swap value for moving node u to cluster c, if the sum of weights of edges from u to c is
+     * Ec.
      */
-    int calculateSwpVal(int u, int c );
+    int calculateSwpVal(int u, int c, int Ec );
 
 
     /**
@@ -219,6 +247,12 @@ public:
      */
     bool keep_only_nonpositive_candidates = true;
 
+    /**
+     * If not nullptr, then expansion orders are created in [arena] (and must not be deleted by the caller), otherwise
+     * they are allocated with new.
+     */
+    ObjectArena<ExpansionOrderRepulsion>* arena = nullptr;
+
 };
 
 #endif //ALGORITHMSPROJECT_COMPONENTEXPANSIONREPULSION_H
@@ -11,6 +11,7 @@
 #include "Makros.h"
 #include "CollectionOperators.h"
 #include "clues/heur/Cluster.h"
+#include "clues/heur/SwapValueKernels.h"
 
 class SwapCandidate{
 public:
@@ -35,6 +36,14 @@ public:
      */
     virtual VPII getNodesToSwap() = 0;
 
+    /**
+     * Non-allocating view of [getNodesToSwap]: the swap consists of swapSize() moves, swapAt(i) is the i-th of them.
+     * Default implementations call [getNodesToSwap], so each derived class that is used in Solver should override
+     * both functions.
+     */
+    virtual int swapSize(){ return getNodesToSwap().size(); }
+    virtual PII swapAt( int i ){ return getNodesToSwap()[i]; }
+
     /**
      * @return swap value, that is the difference in scores (score after change minus current score)
      */
@@ -109,7 +118,11 @@ class SwapCandidateCreator{
 
 class SwapCandidateCreatorAdapter : public SwapCandidateCreator{
 public:
-    SwapCandidateCreatorAdapter( State & s );
+    /**
+     * @param ws workspace with helper arrays [was], [was2], [was3] and [edges_to_cluster]. By default workspace of the
+     * calling thread is used. Creators that run concurrently must use different workspaces.
+     */
+    SwapCandidateCreatorAdapter( State & s, Workspace & ws = Workspace::local() );
 
     /**
      * Just overriding
@@ -125,9 +138,17 @@ public:
     State * state; // pointer to the state
     ClusterGraph* clg; // pointer to the cluster graph of state [state]
 
-    VI edges_to_cluster; // helper array of size(cluster.size()
+    Workspace* ws; // workspace with helper arrays below
+
+    VI & edges_to_cluster; // helper array of size at least cluster.size(), taken from [ws]
+
+    /**
+     * Neighboring clusters of a swap candidate in structure-of-arrays layout, used by [createAllCandidatesForSwpCnd]
+     * to find the best cluster with a vectorized kernel.
+     */
+    ClusterMoveScan move_scan;
 
-    VB was, was2, was3; // helper boolean arrays
+    VB &was, &was2, &was3; // helper boolean arrays, taken from [ws]
 
     /**
      * For each neighbor p of node d, if p and d are ain different clusters (if p is not in [in_cl_d]), then:
@@ -175,6 +196,23 @@ public:
         int best_swpval = Constants::INF;
         int best_trg_cl = -1;
 
+        if( keep_only_best_cluster_to_move_to && neigh_cl.size() >= SwapValueKernels::MIN_SIMD_SIZE ){
+            // swap value of moving to cluster c is swpcnd_w * cluster_weight(c) - 2 * edges_to_cluster[c] + const
+            move_scan.clear();
+            for( int trg_cl : neigh_cl ){
+                move_scan.push( trg_cl, edges_to_cluster[trg_cl], state->clusters[trg_cl].cluster_weight );
+            }
+
+            int min_val;
+            int ind = move_scan.argmin( swpcnd_w, min_val );
+            best_trg_cl = neigh_cl[ind];
+            best_swpval = getSwpValForMove( swpval1, swpcnd_w, swpcnd_deg_in_cl, best_trg_cl );
+            if( debug ) DEBUG2(best_trg_cl,best_swpval);
+
+            if( !keep_only_nonpositive_candidates || best_swpval <= 0 ) res.push_back( constructor(best_swpval, best_trg_cl) );
+            return;
+        }
+
         for( int trg_cl : neigh_cl ){
             int final_swpval = getSwpValForMove( swpval1, swpcnd_w, swpcnd_deg_in_cl,  trg_cl ); // swpval after moving d to cluster trg_cl
 
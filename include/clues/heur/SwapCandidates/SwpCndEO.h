@@ -8,6 +8,7 @@
 #include <clues/heur/ExpansionOrder.h>
 #include <clues/heur/ConvexHullTrickDynamic.h>
 #include "SwapCandidate.h"
+#include "utils/ThreadPool.h"
 
 /**
  * Swap Candidate for Expansion Order
@@ -16,6 +17,8 @@ class SwpCndEO : public SwapCandidate{
 public:
     SwpCndEO( ExpansionOrder& eo, int k, int move_to, int swap_value, LL hash );
     VPII getNodesToSwap() override;
+    int swapSize() override{ return k+1; }
+    PII swapAt( int i ) override{ return { eo->cl->g.nodes[ eo->ord[i] ], move_to }; }
     LL swpVal() override;
 
     VI getAffectedClusters(State& st) override;
@@ -40,7 +43,7 @@ public:
      * Constructing the object works in time O(N), where N is the size of the state cluster graph.
      * @param s
      */
-    SwpCndEOCreator(State & s);
+    SwpCndEOCreator( State & s, Workspace & ws = Workspace::local() );
 
     void createHashes();
 
@@ -83,9 +86,18 @@ public:
      * of all swap candidates.
      *
      * Creating expansion orders is done separately, since they need to be in scope to create swap candidates.
+     *
+     * Orders for different clusters are independent, so if [pool] is set, clusters are processed concurrently, each
+     * thread using its own ComponentExpansion object. Each cluster gets its own seed, so the result does not depend
+     * on the number of threads. [fun] must be safe to call concurrently for different clusters.
      */
     vector<ExpansionOrder> createExpansionOrders( function<VVI(Cluster*)> fun );
 
+    /**
+     * If not null, then expansion orders in [createExpansionOrders] are created using this pool.
+     */
+    ThreadPool * pool = nullptr;
+
     /**
      * Number of edges between set X and Y (Y is just the rest of the cluster C \ X ).
      */
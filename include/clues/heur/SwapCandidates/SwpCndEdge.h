@@ -28,6 +28,8 @@ public:
     }
 
     VPII getNodesToSwap() override{ return {{u,move_node_to}, {v,move_node_to}}; }
+    int swapSize() override{ return 2; }
+    PII swapAt( int i ) override{ return { i == 0 ? u : v, move_node_to }; }
     LL swpVal() override{ return swap_value; }
 
     virtual VI getNodes(){ return {u,v}; }
@@ -41,7 +43,7 @@ public:
 
 class SwpCndEdgeCreator : public SwapCandidateCreatorAdapter{
 public:
-    SwpCndEdgeCreator(State &s);
+    SwpCndEdgeCreator( State & s, Workspace & ws = Workspace::local() );
 
     vector<SwapCandidate *> createSwapCandidatesRaw() override;
 
@@ -20,6 +20,8 @@ public:
     VI getAffectedClusters(State & st) override{ return {st.inCl[node], move_node_to}; }
 
     VPII getNodesToSwap() override{ return {{node,move_node_to}}; }
+    int swapSize() override{ return 1; }
+    PII swapAt( int ) override{ return {node,move_node_to}; }
     LL swpVal() override{ return swap_value; }
 
     int node, move_node_to, swap_value;
@@ -35,7 +37,7 @@ public:
  */
 class SwpCndNodeCreator : public SwapCandidateCreatorAdapter{
 public:
-    SwpCndNodeCreator( State & s );
+    SwpCndNodeCreator( State & s, Workspace & ws = Workspace::local() );
 
     vector<SwapCandidate *> createSwapCandidatesRaw() override;
 
@@ -17,6 +17,9 @@ public:
      */
     SwpCndTriangle( int swpval, int u, int v, int w, int trg_cl );
 
+    int swapSize() override{ return nodes.size(); }
+    PII swapAt( int i ) override{ return {nodes[i], move_node_to[i]}; }
+
     friend ostream& operator<<(ostream& str, SwpCndTriangle& cnd);
 };
 
@@ -31,7 +34,7 @@ public:
  */
 class SwpCndTriangleCreator : public SwapCandidateCreatorAdapter{
 public:
-    SwpCndTriangleCreator(State &s);
+    SwpCndTriangleCreator( State & s, Workspace & ws = Workspace::local() );
 
     vector<SwapCandidate *> createSwapCandidatesRaw() override;
 
@@ -0,0 +1,103 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#ifndef ALGORITHMSPROJECT_SWAPVALUEKERNELS_H
+#define ALGORITHMSPROJECT_SWAPVALUEKERNELS_H
+
+#include "Makros.h"
+
+/**
+ * Clusters to which a node (or a group of nodes - a swap candidate) can be moved, kept in structure-of-arrays layout:
+ * ids[i] is the id of i-th cluster, edge_w[i] is the sum of weights of edges between the node and that cluster and
+ * cl_w[i] is the weight of that cluster.
+ *
+ * Swap value of moving a node with weight nw to the i-th cluster is equal to nw * cl_w[i] - 2 * edge_w[i] + C, where C
+ * does not depend on the target cluster, so the best target can be found by [SwapValueKernels::argminMoveValue] over
+ * contiguous arrays. The object is meant to be reused - [clear] does not release memory.
+ */
+class ClusterMoveScan{
+public:
+    void clear(){ ids.clear(); edge_w.clear(); cl_w.clear(); }
+
+    void push( int id, int e, int w ){
+        ids.push_back(id);
+        edge_w.push_back(e);
+        cl_w.push_back(w);
+    }
+
+    int size() const{ return ids.size(); }
+
+    /**
+     * @return value nw * cl_w[i] - 2 * edge_w[i]
+     */
+    int value( int i, int nw ) const{ return nw * cl_w[i] - 2 * edge_w[i]; }
+
+    /**
+     * @return index of the first cluster with minimal value for node with weight [nw], or -1 if there are no clusters.
+     * The minimal value is written to [min_val].
+     */
+    int argmin( int nw, int & min_val ) const;
+
+//private:
+    VI ids, edge_w, cl_w;
+};
+
+/**
+ * Kernels that find i minimizing nw * cl_w[i] - 2 * edge_w[i]. AVX2 or SSE4.1 version is selected at runtime, depending
+ * on what the processor supports - the scalar version is used otherwise (and for short arrays, where vectorization
+ * does not pay off).
+ */
+namespace SwapValueKernels{
+
+    enum SimdLevel{ SCALAR = 0, SSE41 = 1, AVX2 = 2 };
+
+    /**
+     * @return the best instruction set supported by the processor (detected once).
+     */
+    SimdLevel detectedSimdLevel();
+
+    /**
+     * Instruction set used by [argminMoveValue]. By default equal to [detectedSimdLevel()], it can be lowered e.g. in
+     * tests. CAUTION! Setting a level that is not supported by the processor will crash the program.
+     */
+    extern SimdLevel simd_level;
+
+    /**
+     * Below this number of elements the scalar version is used. Callers may also use it to decide whether filling a
+     * ClusterMoveScan pays off.
+     */
+    const int MIN_SIMD_SIZE = 16;
+
+    /**
+     * @return index i in [0,n) minimizing nw * cl_w[i] - 2 * edge_w[i] (the smallest one in case of ties), or -1 if
+     * n == 0. The minimal value is written to [min_val].
+     */
+    int argminMoveValue( const int* edge_w, const int* cl_w, int n, int nw, int & min_val );
+
+    int argminMoveValueScalar( const int* edge_w, const int* cl_w, int n, int nw, int & min_val );
+    int argminMoveValueSSE41( const int* edge_w, const int* cl_w, int n, int nw, int & min_val );
+    int argminMoveValueAVX2( const int* edge_w, const int* cl_w, int n, int nw, int & min_val );
+
+    /**
+     * The same as [argminMoveValue], but clusters are given as pairs items[i] = (cluster id, edge weight), as kept
+     * e.g. in AdaptiveIntMap, and weights of clusters are read from array [cluster_weights] (AVX2 version gathers
+     * them). Cluster [skip_id] is not considered.
+     * @return index i minimizing nw * cluster_weights[ items[i].first ] - 2 * items[i].second, or -1 if there is no
+     * cluster other than [skip_id].
+     */
+    int argminMoveValuePairs( const PII* items, int n, const int* cluster_weights, int skip_id, int nw, int & min_val );
+
+    int argminMoveValuePairsScalar( const PII* items, int n, const int* cluster_weights, int skip_id, int nw,
+                                    int & min_val );
+    int argminMoveValuePairsSSE41( const PII* items, int n, const int* cluster_weights, int skip_id, int nw,
+                                   int & min_val );
+    int argminMoveValuePairsAVX2( const PII* items, int n, const int* cluster_weights, int skip_id, int nw,
+                                  int & min_val );
+}
+
+inline int ClusterMoveScan::argmin( int nw, int & min_val ) const{
+    return SwapValueKernels::argminMoveValue( edge_w.data(), cl_w.data(), ids.size(), nw, min_val );
+}
+
+#endif //ALGORITHMSPROJECT_SWAPVALUEKERNELS_H
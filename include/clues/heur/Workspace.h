@@ -0,0 +1,71 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#ifndef ALGORITHMSPROJECT_WORKSPACE_H
+#define ALGORITHMSPROJECT_WORKSPACE_H
+
+#include "Makros.h"
+
+/**
+ * Helper ('scratch') arrays used by [State], [Cluster], SwapCandidateCreators and [NEG].
+ *
+ * Each thread should use its own Workspace (see [local()]), this way many Solvers or NEGs can run concurrently in one
+ * process. Arrays are reused between objects - they never shrink, so there is no need to allocate VB(2*N) each time
+ * a new state or a new creator is created.
+ *
+ * CAUTION!! Every operation of an object using the workspace has to leave arrays 'clean' - boolean arrays should
+ * contain only false values, int arrays [helper], [helper2] and [edges_to_cluster] only zeros, [induce_helper] only -1
+ * and hash tables should be empty. This is necessary, because many objects (e.g. a State and its NEG) share the same
+ * workspace. Arrays are not guaranteed to be clean between lifetimes of objects (e.g. an operation could be
+ * interrupted, or a helper function could be called directly in a test) - an object that relies on clean arrays calls
+ * [reserve] with [clear] set when it is created.
+ */
+class Workspace{
+public:
+
+    /**
+     * Makes sure that all arrays have size at least 2*N.
+     * If [clear] is true, then first 2*N elements of all arrays are filled with 'clean' values - this takes time O(N),
+     * and no memory is allocated if arrays are already large enough.
+     */
+    void reserve( int N, bool clear = false );
+
+    /**
+     * @return workspace of the calling thread.
+     */
+    static Workspace& local();
+
+    /**
+     * Helper array used to quickly induce graphs of clusters. Filled with -1.
+     */
+    VI induce_helper;
+
+    /**
+     * Helper boolean arrays used by State and SwapCandidateCreators.
+     */
+    VB was, was2, was3;
+
+    /**
+     * Helper int array used by State (it is overwritten with each use, so it does not need to be cleared).
+     */
+    VI marker;
+
+    /**
+     * Helper array of size at least number of clusters, used by SwapCandidateCreators to count edges to clusters.
+     */
+    VI edges_to_cluster;
+
+    /**
+     * Helper arrays used by NEG.
+     */
+    VI helper, helper2;
+    VB helper_was, helper_was2, helper_was3;
+
+    /**
+     * Helper hash table, e.g. for mapping ids of newly created clusters.
+     */
+    unordered_map<int,int> int_map;
+};
+
+#endif //ALGORITHMSPROJECT_WORKSPACE_H
@@ -10,6 +10,7 @@
 #include "Makros.h"
 #include "CriticalClique.h"
 #include "datastructures/FAU.h"
+#include "datastructures/HashBuckets.h"
 
 /**
  * Class represents an object that performs kernelization of given graph.
@@ -196,11 +197,26 @@ public:
                       bool enable_diamonds = true );
 
     /**
-     * Applies exhaustively rules 1-9. If at any point rule is applied, then restarts kernelization from
-     * rule 1.
+     * Applies exhaustively rules 1-9, 15 and 16.
+     * Local rules (1-4, 6-9) are driven by worklists of nodes whose closed neighborhood changed - see
+     * [applyLocalRules()]. Global rules (15, 16 and heuristic rules) are called only when local rules reach their
+     * fixpoint. If any global rule is applied, then local rules are applied again to the modified part of the graph.
      */
     void fullKernelization(bool use_heuristic_rules, int additional_randomized_iterations);
 
+    /**
+     * Applies local rules (1-4, 6-9) until none of them can be applied. Each rule has its own worklist of nodes that
+     * changed since the last time the rule was applied. A rule is called only for critical cliques that are within
+     * distance 2 from its worklist - the result of each of those rules for a critical clique K depends only on K, N(K)
+     * and N2(K), so critical cliques further away would not be changed by the rule anyway.
+     *
+     * Rules are processed in order - after a rule is applied, modified nodes are added to worklists of all rules and
+     * processing restarts from the first rule with a nonempty worklist.
+     *
+     * @return true if any rule was applied, false otherwise
+     */
+    bool applyLocalRules();
+
     /**
      * Applies heuristic rules to current state of the graph. If heuristic rules make any difference to the graph,
      * then runs fullKernelization again with heuristic rules admitted.
@@ -221,6 +237,16 @@ public:
      */
     void makeCliqueAndRemoveFromGraph( VI nodes );
 
+    /**
+     * Removes given edges from [V], marking their ends as changed.
+     */
+    void removeEdgesFromGraph( VPII & edges );
+
+    /**
+     * Adds edge (a,b) to [V], marking its ends as changed.
+     */
+    void addEdgeToGraph( int a, int b );
+
     /**
      * By empty critical cliques we mean a maximal set of nodes with N(u) == N(v) - neighborhoods need
      * not be closed.
@@ -287,6 +313,85 @@ public:
 
     VB helper1;
 
+    /**
+     * Marker arrays used by rules instead of allocating arrays of size N in each call. Arrays must be cleared after use.
+     */
+    VB helper2, helper3, helper4;
+    VI helper_int;
+
+    /**
+     * cc_of_node[d] is the id of the critical clique in [ccs] that contains d, or -1 if there is no such critical clique.
+     * Used in rule3.
+     */
+    VI cc_of_node;
+
+    /**
+     * Node d is affected in the current application of a rule if affected_stamp[d] == affected_epoch. Incrementing
+     * [affected_epoch] clears all marks.
+     */
+    VI affected_stamp;
+    int affected_epoch = 0;
+    bool isAffected(int d){ return affected_stamp[d] == affected_epoch; }
+    void setAffected(int d){ affected_stamp[d] = affected_epoch; }
+
+    /**
+     * closed_hashes.hash(v) is the XOR of [hashes] of all nodes in the closed neighborhood of v (for nodes removed from
+     * the graph it is just hashes[v]). Nodes with equal hash belong to the same critical clique (with high
+     * probability, collisions are verified in [splitBucket()]).
+     * Hashes are updated in O(1) for each added or removed edge, so all functions that modify [V] must do it.
+     */
+    HashBuckets closed_hashes;
+    LL closedNeighborhoodHash(int v);
+
+    /**
+     * @return true if N[a] == N[b]. Consecutive calls with the same [a] work in time O( |N(b)| ).
+     */
+    bool sameClosedNeighborhood(int a, int b);
+    VI nbh_stamp;
+    int nbh_epoch = 0, nbh_marked = -1;
+
+    /**
+     * Divides nodes with the same value in [closed_hashes] into critical cliques - in case of hash collisions
+     * there may be more than one.
+     */
+    VVI splitBucket( const VI & bucket );
+
+    /**
+     * Nodes whose neighborhood changed (or that were removed from graph) since the last call of [processChangedNodes()].
+     */
+    VI changed_nodes;
+    VB is_changed;
+    void markChanged(int v);
+
+    /**
+     * Local rules, in order in which they are applied in [applyLocalRules()].
+     */
+    static constexpr int LOCAL_RULES_CNT = 8;
+    static constexpr int LOCAL_RULES[LOCAL_RULES_CNT] = {1,2,3,4,6,7,8,9};
+
+    /**
+     * pending[r] is the worklist of nodes that changed since the last time rule LOCAL_RULES[r] was applied.
+     */
+    VVI pending;
+    vector<VB> is_pending;
+
+    /**
+     * Adds all [changed_nodes] to worklists of all local rules.
+     */
+    void processChangedNodes();
+
+    /**
+     * Used to mark visited nodes in [createLocalCriticalCliques()].
+     */
+    VI visit_stamp;
+    int visit_epoch = 0;
+
+    /**
+     * If true, then [markInClVector()] does nothing. It is set during [applyLocalRules()] - rules call
+     * [markInClVector()] after each application, and it is enough to do it once, when the fixpoint is reached.
+     */
+    bool defer_in_cl_update = false;
+
     std::mt19937_64 drng;
     UniformIntGenerator rnd;
 
@@ -328,6 +433,20 @@ public:
      */
     vector<CriticalClique> createCriticalCliques( VI nodes = {} );
 
+    /**
+     * Creates all critical cliques of the graph [V] that contain a node within distance 2 from any node in [region].
+     * Critical cliques are found using buckets of [closed_hashes].
+     *
+     * ATTENTION!! Marks all nodes from the same critical clique to the same cluster (using [fau]).
+     * Critical cliques are randomly shuffled, then sorted by their size in non-ascending order.
+     */
+    vector<CriticalClique> createLocalCriticalCliques( VI & region );
+
+    /**
+     * Randomly shuffles [res], sorts it by sizes in non-ascending order and assigns ids to critical cliques.
+     */
+    void shuffleAndSortBySize( vector<CriticalClique> & res );
+
     /**
      * Finds all nodes that are within [dst] distance from [nodes].
      * Uses [helper1] array.
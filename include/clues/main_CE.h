@@ -22,10 +22,23 @@
 #include <graphs/GraphTrimmer.h>
 #include <clues/heur/Solver.h>
 
+#include <thread>
 #include "Makros.h"
 
 void kernelizationCompare();
 
-void main_CE();
+/**
+ * Reads graph from standard input, solves cluster editing problem and writes the modifications to standard output.
+ *
+ * @param threads number of worker threads. If greater than 1, then portfolio mode is used - [threads] workers run
+ * independent main iterations (each with its own Solver, Config and seeds) and share the best found solution. On large
+ * graphs a single worker is run instead and threads are used inside NEG (see Config::neg_parallel_min_nodes).
+ * @param cache_file if not empty and standard input is redirected from a file, then the graph is stored in
+ * [cache_file] in binary format and loaded from it in further runs for the same input file, instead of parsing the
+ * input. Kernels are cached in [cache_file].kernel (see Config::kernel_cache_file).
+ * @param anytime_file if not empty, then each time a better solution is found, it is written (in the same format as
+ * to the standard output) to [anytime_file] in the background, see SolutionWriter.
+ */
+void main_CE(int threads = 1, string cache_file = "", string anytime_file = "");
 
 #endif //ALGORITHMSPROJECT_MAIN_CE_H
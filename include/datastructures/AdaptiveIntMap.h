@@ -0,0 +1,316 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#ifndef ALGORITHMSPROJECT_ADAPTIVEINTMAP_H
+#define ALGORITHMSPROJECT_ADAPTIVEINTMAP_H
+
+#include "Makros.h"
+#include <cstring>
+
+/**
+ * Map int -> int designed to keep many small maps, one for each node of a graph (e.g. edges_to_cluster[v][cl] - the
+ * number of edges between node v and cluster cl).
+ *
+ * Items (key,value) are kept in a contiguous array of pairs, so iteration is as fast as iteration over a VPII and the
+ * order of items does not change while no item is inserted or erased (erasing moves the last item to the place of the
+ * erased one).
+ * Up to INLINE_SIZE items are kept in a buffer inside the object - for low-degree nodes no memory is allocated at all
+ * and the whole map fits in a single cache line. Above that, items are moved to an array on the heap, pointed to from
+ * the same cache line (the pointer shares memory with the inline buffer). Lookups scan the items
+ * linearly, until the map gets more than HASH_THR items - then an open-addressing (linear probing) table of positions
+ * of items is created, so that lookups in large maps work in expected constant time.
+ *
+ * Interface mimics that of unordered_map: iterating gives PII& (key,value), find() returns end() if key is not
+ * present, erase(it) removes the item pointed to by it.
+ * #CAUTION! Pointers returned by find(), begin() and end() are invalidated by insertions and erasures.
+ */
+template<int INLINE_SIZE = 6, int HASH_THR = 16>
+class alignas(64) AdaptiveIntMap{
+public:
+    typedef PII* iterator;
+    typedef const PII* const_iterator;
+
+    AdaptiveIntMap(){}
+
+    AdaptiveIntMap( const AdaptiveIntMap& oth ) : sz(oth.sz), large(oth.large){
+        if( !large ){
+            copy( oth.small, oth.small + sz, small );
+            return;
+        }
+
+        heap = { new PII[oth.heap.cap], nullptr, oth.heap.cap, oth.heap.table_size };
+        copy( oth.heap.items, oth.heap.items + sz, heap.items );
+        if( heap.table_size > 0 ){
+            heap.table = new int[heap.table_size];
+            copy( oth.heap.table, oth.heap.table + heap.table_size, heap.table );
+        }
+    }
+
+    /**
+     * [oth] is left empty.
+     */
+    AdaptiveIntMap( AdaptiveIntMap&& oth ) noexcept : sz(oth.sz), large(oth.large){
+        if( large ) heap = oth.heap;
+        else copy( oth.small, oth.small + sz, small );
+        oth.sz = 0;
+        oth.large = false;
+    }
+
+    AdaptiveIntMap& operator=( AdaptiveIntMap oth ){
+        char tmp[ sizeof(small) ]; // both alternatives of the union are trivially copyable, so bytes can be swapped
+        memcpy( tmp, small, sizeof(small) );
+        memcpy( small, oth.small, sizeof(small) );
+        memcpy( oth.small, tmp, sizeof(small) );
+        swap( sz, oth.sz );
+        swap( large, oth.large );
+        return *this;
+    }
+
+    ~AdaptiveIntMap(){
+        if( large ){
+            delete[] heap.items;
+            delete[] heap.table;
+        }
+    }
+
+    PII* begin(){ return data(); }
+    PII* end(){ return data() + sz; }
+    const PII* begin() const{ return data(); }
+    const PII* end() const{ return data() + sz; }
+
+    int size() const{ return sz; }
+    bool empty() const{ return sz == 0; }
+
+    /**
+     * @return pointer to the item with given key, or end() if there is no such item.
+     */
+    PII* find( int key ){
+        int p = position(key);
+        return p == -1 ? end() : data() + p;
+    }
+
+    /**
+     * @return value for the given key, or 0 if key is not present.
+     */
+    int get( int key ) const{
+        int p = position(key);
+        return p == -1 ? 0 : data()[p].second;
+    }
+
+    bool contains( int key ) const{ return position(key) != -1; }
+
+    /**
+     * @return reference to value for the given key. If key is not present, item (key,0) is inserted first.
+     */
+    int& operator[]( int key ){
+        int p = position(key);
+        if( p == -1 ) p = insert(key,0);
+        return data()[p].second;
+    }
+
+    void erase( PII* it ){
+        int p = it - data();
+        assert( p >= 0 && p < sz );
+
+        const bool hashed = isHashed();
+        if( hashed ) removeFromTable(p);
+
+        int last = sz-1;
+        if( p != last ){
+            data()[p] = data()[last];
+            if( hashed ) heap.table[ slotOf(last) ] = p;
+        }
+        sz--;
+    }
+
+    /**
+     * Moves [w] from the value of [from] to the value of [to] - item [from] must be present and after the move its
+     * value must be nonnegative. If it becomes 0, the item is erased (a common case, e.g. when a node is moved from
+     * cluster [from] to [to], then edges_to_cluster of its neighbors change that way). Both keys are found in a single
+     * scan for small maps.
+     */
+    void transfer( int from, int to, int w ){
+        int pf = -1, pt = -1;
+        PII* d = data();
+        if( !isHashed() ){
+            for( int i=0; i<sz; i++ ){
+                if( d[i].first == from ) pf = i;
+                else if( d[i].first == to ) pt = i;
+            }
+        }else{
+            pf = position(from);
+            pt = position(to);
+        }
+
+        assert( pf != -1 );
+        if( pt == -1 && d[pf].second == w ){ // the item for [from] just changes its key
+            if( isHashed() ) removeFromTable(pf);
+            d[pf].first = to;
+            if( isHashed() ) addToTable(pf);
+            return;
+        }
+
+        d[pf].second -= w;
+        assert( d[pf].second >= 0 );
+
+        if( pt != -1 ) d[pt].second += w;
+        else insert( to, w ); // items are only appended, so pf remains valid
+
+        if( data()[pf].second == 0 ) erase( data() + pf );
+    }
+
+    void erase( int key ){
+        int p = position(key);
+        if( p != -1 ) erase( data() + p );
+    }
+
+    /**
+     * Removes all items. Memory of items and of the table is kept.
+     */
+    void clear(){
+        sz = 0;
+        if( isHashed() ) fill( heap.table, heap.table + heap.table_size, -1 );
+    }
+
+//private:
+    /**
+     * Items kept outside of the object. Fields are kept directly in the object (in the same memory as [small]), so that
+     * items of a large map are reached with a single indirection.
+     */
+    struct Heap{
+        PII* items;
+        /**
+         * table[slot] is the position of an item in items, or -1 if slot is empty. Table is nullptr if it is not
+         * used. Size of the table is always a power of 2 and at least twice the number of items.
+         */
+        int* table;
+        int cap; // capacity of items
+        int table_size;
+    };
+
+    /**
+     * If [large] is false, items are kept in [small], otherwise in [heap].
+     */
+    union{
+        PII small[INLINE_SIZE];
+        Heap heap;
+    };
+    static_assert( sizeof(Heap) <= sizeof(PII) * INLINE_SIZE, "INLINE_SIZE too small to keep Heap" );
+
+    int sz = 0;
+    bool large = false;
+
+    PII* data(){ return large ? heap.items : small; }
+    const PII* data() const{ return large ? heap.items : small; }
+
+    bool isHashed() const{ return large && heap.table != nullptr; }
+
+    int hashSlot( int key ) const{ return ( (unsigned)key * 2654435769u ) & ( heap.table_size-1 ); }
+
+    /**
+     * @return position of item with given key in data() or -1 if it is not present
+     */
+    int position( int key ) const{
+        const PII* d = data();
+        if( !isHashed() ){
+            for( int i=0; i<sz; i++ ) if( d[i].first == key ) return i;
+            return -1;
+        }
+
+        const int* table = heap.table;
+        const int mask = heap.table_size-1;
+        for( int s = hashSlot(key); table[s] != -1; s = (s+1) & mask ){
+            if( d[ table[s] ].first == key ) return table[s];
+        }
+        return -1;
+    }
+
+    /**
+     * @return slot in the table that keeps position p
+     */
+    int slotOf( int p ) const{
+        const int* table = heap.table;
+        const int mask = heap.table_size-1;
+        int s = hashSlot( data()[p].first );
+        while( table[s] != p ) s = (s+1) & mask;
+        return s;
+    }
+
+    /**
+     * Inserts item (key,val), assuming key is not present. @return position of the inserted item.
+     */
+    int insert( int key, int val ){
+        if( sz == ( large ? heap.cap : INLINE_SIZE ) ) grow();
+
+        data()[sz] = {key,val};
+        sz++;
+
+        if( !large ) return sz-1;
+        if( heap.table == nullptr ){
+            if( sz > HASH_THR ) rehash();
+        }
+        else if( 2*sz > heap.table_size ) rehash();
+        else addToTable(sz-1);
+
+        return sz-1;
+    }
+
+    /**
+     * Doubles capacity of items, moving them from [small] to [heap] if needed.
+     */
+    void grow(){
+        int cap = large ? 2*heap.cap : 2*INLINE_SIZE;
+        PII* items = new PII[cap];
+        copy( data(), data() + sz, items );
+
+        if( large ) delete[] heap.items;
+        else heap = { nullptr, nullptr, 0, 0 }; // items were already copied from [small]
+        heap.items = items;
+        heap.cap = cap;
+        large = true;
+    }
+
+    void addToTable( int p ){
+        int* table = heap.table;
+        const int mask = heap.table_size-1;
+        int s = hashSlot( data()[p].first );
+        while( table[s] != -1 ) s = (s+1) & mask;
+        table[s] = p;
+    }
+
+    /**
+     * Removes position p from the table, using backward-shift deletion, so that no tombstones are needed.
+     */
+    void removeFromTable( int p ){
+        int* table = heap.table;
+        const int mask = heap.table_size-1;
+        int hole = slotOf(p);
+        table[hole] = -1;
+
+        for( int s = (hole+1) & mask; table[s] != -1; s = (s+1) & mask ){
+            int home = hashSlot( data()[ table[s] ].first );
+            // item in slot s can be moved to the hole if its home slot is not in the cyclic range (hole, s]
+            bool in_range = ( hole < s ) ? ( hole < home && home <= s ) : ( hole < home || home <= s );
+            if( !in_range ){
+                table[hole] = table[s];
+                table[s] = -1;
+                hole = s;
+            }
+        }
+    }
+
+    void rehash(){
+        int cap = 2*HASH_THR;
+        while( cap < 2*sz ) cap <<= 1;
+        cap <<= 1;
+
+        delete[] heap.table;
+        heap.table = new int[cap];
+        heap.table_size = cap;
+        fill( heap.table, heap.table + cap, -1 );
+        for( int i=0; i<sz; i++ ) addToTable(i);
+    }
+};
+
+#endif //ALGORITHMSPROJECT_ADAPTIVEINTMAP_H
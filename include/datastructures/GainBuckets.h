@@ -0,0 +1,110 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#ifndef ALGORITHMSPROJECT_GAINBUCKETS_H
+#define ALGORITHMSPROJECT_GAINBUCKETS_H
+
+#include "Makros.h"
+
+/**
+ * Bucket priority queue of ids 0..N-1 with integer keys, as used in the Fiduccia-Mattheyses heuristic.
+ *
+ * Keys are clamped to range [-max_key, max_key] - each key has its own bucket, a doubly linked list of ids kept in
+ * flat arrays. Insertion, removal and key update work in O(1), popping the id with minimal key works in amortized
+ * O(1) plus the number of empty buckets skipped (the pointer to the minimal nonempty bucket is moved only forward
+ * between insertions). Ids with equal keys are popped in LIFO order.
+ *
+ * Memory is not released by [clear], so the structure can be reused without allocations.
+ */
+class GainBuckets{
+public:
+    GainBuckets() = default;
+
+    GainBuckets( int N, int max_key ) : max_key(max_key), head( 2*max_key+1, -1 ), next(N,-1), prev(N,-1),
+        bucket(N,-1), min_bucket(2*max_key+1) {}
+
+    bool empty() const{ return cnt == 0; }
+    int size() const{ return cnt; }
+
+    bool contains( int v ) const{ return bucket[v] != -1; }
+
+    /**
+     * @return key of v (after clamping). v must be present.
+     */
+    int key( int v ) const{ return bucket[v] - max_key; }
+
+    /**
+     * Inserts v with given key, or changes the key of v if it is already present.
+     */
+    void update( int v, int key ){
+        int b = max( 0, min( 2*max_key, key + max_key ) );
+        if( bucket[v] == b ) return;
+        if( bucket[v] != -1 ) remove(v);
+
+        bucket[v] = b;
+        prev[v] = -1;
+        next[v] = head[b];
+        if( head[b] != -1 ) prev[ head[b] ] = v;
+        head[b] = v;
+
+        min_bucket = min( min_bucket, b );
+        cnt++;
+    }
+
+    void remove( int v ){
+        int b = bucket[v];
+        assert( b != -1 );
+        if( prev[v] != -1 ) next[ prev[v] ] = next[v];
+        else head[b] = next[v];
+        if( next[v] != -1 ) prev[ next[v] ] = prev[v];
+        bucket[v] = -1;
+        cnt--;
+    }
+
+    /**
+     * @return minimal key of an id in the structure. The structure must not be empty.
+     */
+    int minKey(){
+        assert( cnt > 0 );
+        while( head[min_bucket] == -1 ) min_bucket++;
+        return min_bucket - max_key;
+    }
+
+    /**
+     * Removes and returns an id with minimal key. The structure must not be empty.
+     */
+    int pop(){
+        minKey();
+        int v = head[min_bucket];
+        remove(v);
+        return v;
+    }
+
+    void clear(){
+        while( !empty() ) pop();
+        min_bucket = 2*max_key+1;
+    }
+
+//private:
+    int max_key = 0;
+    int cnt = 0;
+
+    /**
+     * head[b] is the first id in bucket b (for key b - max_key), or -1 if the bucket is empty
+     */
+    VI head;
+    VI next, prev;
+
+    /**
+     * bucket[v] is the bucket containing v, or -1 if v is not present
+     */
+    VI bucket;
+
+    /**
+     * No bucket with index smaller than min_bucket is nonempty.
+     */
+    int min_bucket = 0;
+};
+
+#endif //ALGORITHMSPROJECT_GAINBUCKETS_H
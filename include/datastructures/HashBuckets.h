@@ -0,0 +1,114 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#ifndef ALGORITHMSPROJECT_HASHBUCKETS_H
+#define ALGORITHMSPROJECT_HASHBUCKETS_H
+
+#include "Makros.h"
+
+/**
+ * Groups ids 0..N-1 by a 64-bit hash assigned to each id. Each hash has its own bucket - a vector of ids with that
+ * hash. Setting or changing the hash of an id works in O(1) (expected), so the structure can be kept up to date when
+ * hashes change incrementally, e.g. XOR hashes of neighborhoods of nodes, that are updated in O(1) when an edge is
+ * added or removed (see [toggle]).
+ *
+ * Different objects may have the same hash - use [split] to divide a bucket into classes of really equal objects.
+ */
+class HashBuckets{
+public:
+    HashBuckets() = default;
+
+    HashBuckets( int N ) : hashes(N,0), pos(N,-1) {}
+
+    int size() const{ return hashes.size(); }
+
+    bool contains( int v ) const{ return pos[v] != -1; }
+
+    /**
+     * @return hash of v. v must be present.
+     */
+    LL hash( int v ) const{ return hashes[v]; }
+
+    /**
+     * Inserts v with given hash, or changes the hash of v if it is already present.
+     */
+    void set( int v, LL h ){
+        if( contains(v) ){
+            if( hashes[v] == h ) return;
+            remove(v);
+        }
+        hashes[v] = h;
+        VI & b = buckets[h];
+        pos[v] = b.size();
+        b.push_back(v);
+    }
+
+    /**
+     * Changes the hash of v to hash(v) ^ x. v must be present.
+     */
+    void toggle( int v, LL x ){
+        assert( contains(v) );
+        set( v, hashes[v] ^ x );
+    }
+
+    void remove( int v ){
+        assert( contains(v) );
+        auto it = buckets.find( hashes[v] );
+        VI & b = it->second;
+        int last = b.back();
+        b[ pos[v] ] = last;
+        pos[last] = pos[v];
+        b.pop_back();
+        if( b.empty() ) buckets.erase(it);
+        pos[v] = -1;
+    }
+
+    /**
+     * @return vector of all ids with hash [h]. Reference is valid until the next modification of the structure.
+     */
+    const VI & bucket( LL h ) const{
+        static const VI empty_bucket;
+        auto it = buckets.find(h);
+        return it == buckets.end() ? empty_bucket : it->second;
+    }
+
+    /**
+     * @return vector of all ids with the same hash as v. v must be present.
+     */
+    const VI & bucketOf( int v ) const{ return bucket( hashes[v] ); }
+
+    /**
+     * Divides [ids] (that should have the same hash) into classes of equal objects. Function [same](a,b) should
+     * return true if objects a and b are equal. Each id is compared with the first id of each class found so far, so if
+     * there are no collisions, [same] is called |ids|-1 times, always with the same first argument.
+     */
+    template<class _T>
+    static VVI split( const VI & ids, _T same ){
+        VVI res;
+        for( int v : ids ){
+            bool found = false;
+            for( VI & cl : res ){
+                if( same( cl[0], v ) ){
+                    cl.push_back(v);
+                    found = true;
+                    break;
+                }
+            }
+            if( !found ) res.push_back( {v} );
+        }
+        return res;
+    }
+
+//private:
+    VLL hashes;
+
+    /**
+     * pos[v] is the index of v in its bucket, or -1 if v is not in the structure.
+     */
+    VI pos;
+
+    unordered_map<LL, VI, fib_hash> buckets;
+};
+
+#endif //ALGORITHMSPROJECT_HASHBUCKETS_H
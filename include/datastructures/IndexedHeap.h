@@ -0,0 +1,125 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#ifndef ALGORITHMSPROJECT_INDEXEDHEAP_H
+#define ALGORITHMSPROJECT_INDEXEDHEAP_H
+
+#include "Makros.h"
+
+/**
+ * Indexed D-ary min-heap of integer ids.
+ *
+ * Unlike Heap and MyPQ, the heap does not store priorities nor allocate items - it keeps only a flat array of ids
+ * and compares them using [_Cmp] (cmp(a,b) is true if a should be closer to the top than b). Priorities are kept by
+ * the user (usually in flat arrays indexed by id) and after a priority of an element is changed, [update] must be
+ * called.
+ *
+ * Position of id in the heap is stored in array [*pos] (pos[id] == -1 if id is not in the heap). Many heaps may share
+ * the same [pos] array, as long as each id belongs to at most one of them.
+ *
+ * All operations except [top] work in time O( D * log_D(size) ). Memory is not released by [clear], so a heap can be
+ * reused without further allocations.
+ */
+template<class _Cmp, int D = 4>
+class IndexedHeap{
+public:
+    IndexedHeap() = default;
+    IndexedHeap( VI* pos, _Cmp cmp ) : pos(pos), cmp(cmp) {}
+
+    /**
+     * Heaps share [pos] arrays and comparators usually keep pointers to their owners, so a copy would silently
+     * modify positions of the original heap. Only moving is allowed.
+     */
+    IndexedHeap( const IndexedHeap & ) = delete;
+    IndexedHeap& operator=( const IndexedHeap & ) = delete;
+    IndexedHeap( IndexedHeap && ) = default;
+    IndexedHeap& operator=( IndexedHeap && ) = default;
+
+    bool empty() const{ return h.empty(); }
+    int size() const{ return h.size(); }
+
+    /**
+     * @return id of the top element (the minimal one according to [cmp]).
+     */
+    int top() const{ return h[0]; }
+
+    bool contains( int id ) const{ return (*pos)[id] != -1; }
+
+    void push( int id ){
+        h.push_back(id);
+        (*pos)[id] = (int)h.size()-1;
+        siftUp( h.size()-1 );
+    }
+
+    /**
+     * Restores heap property after priority of element [id] was changed.
+     */
+    void update( int id ){
+        int p = (*pos)[id];
+        if( !siftUp(p) ) siftDown(p);
+    }
+
+    void pop(){ remove( h[0] ); }
+
+    void remove( int id ){
+        int p = (*pos)[id];
+        int last = h.back();
+        h.pop_back();
+        (*pos)[id] = -1;
+        if( last == id ) return;
+        h[p] = last;
+        (*pos)[last] = p;
+        update(last);
+    }
+
+    /**
+     * Removes all elements. Entries in [pos] are reset only for elements that were in the heap.
+     */
+    void clear(){
+        for( int id : h ) (*pos)[id] = -1;
+        h.clear();
+    }
+
+//private:
+    VI h;
+    VI* pos = nullptr;
+    _Cmp cmp;
+
+    /**
+     * @return true if element at position p was moved
+     */
+    bool siftUp( int p ){
+        int id = h[p];
+        int p0 = p;
+        while( p > 0 ){
+            int par = (p-1) / D;
+            if( !cmp( id, h[par] ) ) break;
+            h[p] = h[par];
+            (*pos)[h[p]] = p;
+            p = par;
+        }
+        h[p] = id;
+        (*pos)[id] = p;
+        return p != p0;
+    }
+
+    void siftDown( int p ){
+        int id = h[p];
+        int n = h.size();
+        while(true){
+            int b = D*p+1;
+            if( b >= n ) break;
+            int best = b;
+            for( int i=b+1; i < min(b+D,n); i++ ) if( cmp( h[i], h[best] ) ) best = i;
+            if( !cmp( h[best], id ) ) break;
+            h[p] = h[best];
+            (*pos)[h[p]] = p;
+            p = best;
+        }
+        h[p] = id;
+        (*pos)[id] = p;
+    }
+};
+
+#endif //ALGORITHMSPROJECT_INDEXEDHEAP_H
@@ -0,0 +1,80 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#ifndef ALGORITHMSPROJECT_OBJECTARENA_H
+#define ALGORITHMSPROJECT_OBJECTARENA_H
+
+#include "Makros.h"
+
+/**
+ * Arena for objects of type _T. Objects are constructed in place in large blocks of memory, so that creating an
+ * object does not call operator new (apart from allocating a new block once in a while), and all objects are destroyed
+ * at once by calling [clear].
+ *
+ * Addresses of created objects are stable - they are valid until [clear] is called or the arena is destroyed, so
+ * other objects may keep pointers to them (e.g. swap candidates keep pointers to expansion orders).
+ *
+ * Blocks are not released by [clear], so an arena that is cleared and refilled many times allocates memory only
+ * during the first fills.
+ */
+template<class _T>
+class ObjectArena{
+public:
+    explicit ObjectArena( int block_size = 256 ) : block_size(block_size) {}
+
+    ObjectArena( const ObjectArena& ) = delete;
+    ObjectArena& operator=( const ObjectArena& ) = delete;
+
+    ObjectArena( ObjectArena&& oth ) noexcept : blocks( move(oth.blocks) ), cnt(oth.cnt), block_size(oth.block_size) {
+        oth.blocks.clear();
+        oth.cnt = 0;
+    }
+
+    ~ObjectArena(){
+        clear();
+        for( _T* b : blocks ) ::operator delete(b);
+    }
+
+    /**
+     * Constructs a new object with given arguments in the arena.
+     * @return pointer to the created object. It must not be deleted.
+     */
+    template<class... Args>
+    _T* create( Args&&... args ){
+        if( cnt == (int)blocks.size() * block_size ){
+            blocks.push_back( static_cast<_T*>( ::operator new( sizeof(_T) * block_size ) ) );
+        }
+        _T* p = blocks[ cnt / block_size ] + ( cnt % block_size );
+        new (p) _T( forward<Args>(args)... );
+        cnt++;
+        return p;
+    }
+
+    /**
+     * @return i-th created object
+     */
+    _T* operator[]( int i ){ return blocks[ i / block_size ] + ( i % block_size ); }
+
+    /**
+     * @return number of objects in the arena.
+     */
+    int size() const{ return cnt; }
+
+    bool empty() const{ return cnt == 0; }
+
+    /**
+     * Destroys all objects in the arena. Memory is kept for further use.
+     */
+    void clear(){
+        for( int i=0; i<cnt; i++ ) (*this)[i]->~_T();
+        cnt = 0;
+    }
+
+//private:
+    vector<_T*> blocks;
+    int cnt = 0; // number of objects in the arena
+    int block_size;
+};
+
+#endif //ALGORITHMSPROJECT_OBJECTARENA_H
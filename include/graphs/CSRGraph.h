@@ -0,0 +1,197 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#ifndef ALGORITHMSPROJECT_CSRGRAPH_H
+#define ALGORITHMSPROJECT_CSRGRAPH_H
+
+#include "Makros.h"
+
+/**
+ * Graph in compressed sparse row (CSR) format.
+ *
+ * Neighbors of all nodes are kept in a single contiguous array [adj]. Neighbors of node v are
+ * adj[ offsets[v] ], ..., adj[ offsets[v+1]-1 ]. This is much more cache-friendly than VVI / VVPII (there is one heap
+ * block instead of N of them), but the structure of the graph can not be modified - only the order of neighbors of
+ * each node can be changed.
+ *
+ * _T is the type of entries of adjacency lists. For unweighted graphs it is int (the same as in VVI), for weighted
+ * graphs it is PII - a pair of 32-bit ints (id, weight), packed next to each other in [adj] (the same as in VVPII).
+ *
+ * V[v] returns a lightweight range, so the code written for VVI / VVPII, e.g.
+ * for( auto & [u,w] : V[v] ){ ... }    or    V[v].size()
+ * works without changes.
+ */
+template<class _T>
+class CSRGraph{
+public:
+
+    /**
+     * Range representing the adjacency list of a single node. It does not own any data - it is valid as long as the
+     * graph is not destroyed or rebuilt.
+     */
+    class Row{
+    public:
+        Row( _T* b, _T* e ) : b(b), e(e) {}
+
+        _T* begin() const{ return b; }
+        _T* end() const{ return e; }
+        int size() const{ return e-b; }
+        bool empty() const{ return b == e; }
+        _T& operator[](int i) const{ return b[i]; }
+
+    private:
+        _T *b, *e;
+    };
+
+    CSRGraph() : offsets(1,0) {}
+
+    /**
+     * Creates CSR graph with the same structure (and the same order of neighbors) as [V].
+     */
+    explicit CSRGraph( const vector<vector<_T>> & V ){
+        int N = V.size();
+        offsets.resize(N+1);
+        offsets[0] = 0;
+        for( int i=0; i<N; i++ ) offsets[i+1] = offsets[i] + V[i].size();
+
+        adj.resize( offsets[N] );
+        for( int i=0; i<N; i++ ) copy( ALL(V[i]), adj.begin() + offsets[i] );
+    }
+
+    /**
+     * Creates CSR graph from list of edges [edges] in two passes - first degrees are counted, then edges are placed at
+     * their positions. Each edge (a,b) is added in both directions, unless [directed] is true.
+     * Neighbors of each node are in the order in which edges appear in [edges].
+     * @param N number of nodes
+     * @param edges list of pairs (a,b), where a,b are in [0,N)
+     * @param weights if not nullptr, then (*weights)[i] is the weight of edge edges[i]. It is used only if _T is PII,
+     * otherwise weights are ignored. If nullptr and _T is PII, then all weights are 1.
+     */
+    static CSRGraph fromEdges( int N, const VPII & edges, bool directed = false, const VI * weights = nullptr ){
+        CSRGraph g;
+        g.offsets.assign(N+1,0);
+        for( auto & [a,b] : edges ){
+            g.offsets[a+1]++;
+            if(!directed) g.offsets[b+1]++;
+        }
+        for( int i=0; i<N; i++ ) g.offsets[i+1] += g.offsets[i];
+
+        g.adj.resize( g.offsets[N] );
+        VI pos( g.offsets.begin(), g.offsets.end()-1 );
+        for( int i=0; i<edges.size(); i++ ){
+            auto [a,b] = edges[i];
+            int w = (weights == nullptr) ? 1 : (*weights)[i];
+            g.adj[ pos[a]++ ] = makeEntry(b,w);
+            if(!directed) g.adj[ pos[b]++ ] = makeEntry(a,w);
+        }
+
+        return g;
+    }
+
+    /**
+     * @return number of nodes
+     */
+    int size() const{ return (int)offsets.size()-1; }
+
+    int degree( int v ) const{ return offsets[v+1] - offsets[v]; }
+
+    Row operator[]( int v ){ return Row( adj.data() + offsets[v], adj.data() + offsets[v+1] ); }
+
+    /**
+     * @return number of edges, assuming that the graph is undirected (each edge is counted once)
+     */
+    long long countEdges() const{ return adj.size() / 2; }
+
+    /**
+     * @return 64-bit hash of the structure of the graph (it depends on the order of neighbors).
+     */
+    unsigned long long hash() const{
+        unsigned long long h = 14695981039346656037ull;
+        auto add = [&h]( unsigned long long x ){ h = (h ^ x) * 1099511628211ull; };
+        for( int d : offsets ) add(d);
+        for( auto & d : adj ){
+            if constexpr ( is_same<_T,PII>::value ){ add(d.first); add(d.second); }
+            else add(d);
+        }
+        return h;
+    }
+
+    /**
+     * Sorts neighbors of each node.
+     * @param remove_duplicates if true, then repeated entries are removed from each adjacency list (and [adj] is
+     * compacted in place).
+     */
+    void sortNeighbors( bool remove_duplicates = false ){
+        int N = size();
+        int p = 0;
+        for( int i=0; i<N; i++ ){
+            int b = offsets[i], e = offsets[i+1];
+            sort( adj.begin() + b, adj.begin() + e );
+            offsets[i] = p;
+            for( int j=b; j<e; j++ ){
+                if( remove_duplicates && p > offsets[i] && adj[p-1] == adj[j] ) continue;
+                adj[p++] = adj[j];
+            }
+        }
+        offsets[N] = p;
+        adj.resize(p);
+    }
+
+    /**
+     * Adapter for the code that works on VVI / VVPII structure.
+     * @return graph with the same structure (and the same order of neighbors) as this one.
+     */
+    vector<vector<_T>> toVV() const{
+        int N = size();
+        vector<vector<_T>> V(N);
+        for( int i=0; i<N; i++ ) V[i] = vector<_T>( adj.begin() + offsets[i], adj.begin() + offsets[i+1] );
+        return V;
+    }
+
+    /**
+     * Adapter for the code that works on unweighted VVI structure - weights (if any) are dropped.
+     */
+    VVI toVVI() const{
+        int N = size();
+        VVI V(N);
+        for( int i=0; i<N; i++ ){
+            V[i].reserve( degree(i) );
+            for( int j=offsets[i]; j<offsets[i+1]; j++ ) V[i].push_back( entryId(adj[j]) );
+        }
+        return V;
+    }
+
+    /**
+     * @return graph with the same structure (and the same order of neighbors) as this one, but with weights dropped.
+     */
+    CSRGraph<int> unweighted() const{
+        CSRGraph<int> g;
+        g.offsets = offsets;
+        g.adj.reserve( adj.size() );
+        for( auto & e : adj ) g.adj.push_back( entryId(e) );
+        return g;
+    }
+
+//private:
+
+    /**
+     * offsets[v] is the index in [adj] of the first neighbor of v. offsets[N] == adj.size()
+     */
+    VI offsets;
+
+    vector<_T> adj;
+
+    static int entryId( int d ){ return d; }
+    static int entryId( const PII & p ){ return p.first; }
+
+    static _T makeEntry( int id, int w ){
+        if constexpr ( is_same<_T,PII>::value ) return PII(id,w);
+        else return id;
+    }
+};
+
+typedef CSRGraph<int> CSRI;
+typedef CSRGraph<PII> CSRPII;
+
+#endif //ALGORITHMSPROJECT_CSRGRAPH_H
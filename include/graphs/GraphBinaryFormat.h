@@ -0,0 +1,43 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#ifndef ALGORITHMSPROJECT_GRAPHBINARYFORMAT_H
+#define ALGORITHMSPROJECT_GRAPHBINARYFORMAT_H
+
+#include <cstdint>
+
+/**
+ * Binary on-disk format of a graph, written by GraphWriter::writeGraphBinary and read by GraphReader::readGraphBinary.
+ *
+ * File consists of:
+ * 1. header (below)
+ * 2. N+1 offsets of the CSR structure (int32)
+ * 3. adj_size entries of the CSR adjacency array - int32 ids, or pairs (int32 id, int32 weight) if the graph is weighted
+ * 4. N node weights (int32), if (flags & HAS_NODE_WEIGHTS)
+ * 5. N partition ids (int32), if (flags & HAS_PARTITION)
+ *
+ * All numbers are in the native byte order - the files are meant as a cache on the same machine, not for exchange.
+ */
+struct GraphBinaryHeader{
+    static constexpr uint64_t MAGIC = 0x3130524753454c43ull; // "CLESGR01"
+
+    enum FLAGS{
+        WEIGHTED = 1, // adjacency entries are (id, weight) pairs
+        HAS_NODE_WEIGHTS = 2, // e.g. ClusterGraph::node_weights
+        HAS_PARTITION = 4 // e.g. CEKernelizer::inCl
+    };
+
+    uint64_t magic = MAGIC;
+    uint32_t flags = 0;
+    int32_t N = 0;
+    int64_t adj_size = 0;
+
+    /**
+     * Arbitrary value given by the writer, e.g. hash of the graph from which stored kernel was created. It can be used
+     * by the reader to check whether the file is up to date.
+     */
+    uint64_t key = 0;
+};
+
+#endif //ALGORITHMSPROJECT_GRAPHBINARYFORMAT_H
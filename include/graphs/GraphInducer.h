@@ -6,6 +6,7 @@
 #define ALGORITHMSPROJECT_GRAPHINDUCER_H
 
 #include "Makros.h"
+#include "CSRGraph.h"
 
 
 struct InducedGraph{
@@ -72,6 +73,12 @@ public:
      */
     static InducedGraphPI induceNoPerm(VVPII & V, VI & nodes, VI & helper );
 
+    /**
+     * The same as [induceNoPerm] above, but for graph in CSR format. The induced graph is created as VVPII, [par] field
+     * is set to nullptr.
+     */
+    static InducedGraphPI induceNoPerm(CSRGraph<PII> & V, VI & nodes, VI & helper );
+
     // returns graph induced by given edges. Works for directed graphs (V can be directed) as welll
     // if directed == true then each edge in edges will be treated as directed edge. Otherwise it will be treated as undirected, bidirectional edge.
     static InducedGraph induce( VVI & V, VPII & edges, bool directed = false );
@@ -6,6 +6,7 @@
 #define ALGORITHMSPROJECT_GRAPHREADER_H
 
 #include "Makros.h"
+#include "CSRGraph.h"
 
 /**
  * Class responsible for reading graphs. It reads graphs from different formats and returns appropriate structure
@@ -28,6 +29,49 @@ namespace GraphReader {
      */
     extern VVI readGraphDIMACSWunweighed(istream &cin, bool edgeFoolowE = false);
 
+    /**
+     * The same as @readGraphDIMACSWunweighed, but the graph is returned in CSR format. Neighbors of each node are
+     * sorted and repeated edges are removed, so toVVI() of the result is the same as @readGraphDIMACSWunweighed.
+     *
+     * The whole stream is read in large blocks and then parsed using @parseGraphDIMACSWunweighed. Edges may be given
+     * both as 'a b' and 'e a b' lines.
+     */
+    extern CSRGraph<int> readGraphDIMACSWunweighedCSR(istream &cin);
+
+    /**
+     * The same as @readGraphDIMACSWunweighedCSR(istream&), but reads from file descriptor [fd] (e.g. 0 for stdin).
+     * If [fd] refers to a regular file (e.g. stdin redirected from a file), then the file is memory-mapped and parsed
+     * without copying. Otherwise (pipe, terminal) it is read in large blocks.
+     */
+    extern CSRGraph<int> readGraphDIMACSWunweighedCSR(int fd);
+
+    /**
+     * Parses graph in dimacs format from the text [beg, end).
+     * Works in two passes over the text - first degrees of nodes are counted, then the neighbors are placed directly in
+     * the CSR structure. Integers are parsed by hand, without streams.
+     * @return graph in CSR format with sorted neighbors and without repeated edges
+     */
+    extern CSRGraph<int> parseGraphDIMACSWunweighed(const char* beg, const char* end);
+
+    /**
+     * Loads graph written by GraphWriter::writeGraphBinary. The file is memory-mapped and its arrays are copied
+     * directly into [V] (and [node_weights], [partition]), without any parsing.
+     *
+     * @param node_weights if not nullptr, then node weights are loaded to it (or it is cleared, if the file does not
+     * contain node weights)
+     * @param partition the same as [node_weights], but for the partition
+     * @param key if not nullptr, then the key from the header is written to it
+     * @return true if the graph was loaded, false if the file does not exist, is invalid or contains a graph of
+     * different type (weighted instead of unweighted or vice versa)
+     */
+    extern bool readGraphBinary( const string & file, CSRGraph<int> & V, VI * node_weights = nullptr,
+                                 VI * partition = nullptr, unsigned long long * key = nullptr );
+
+    /**
+     * The same as above, for weighted graphs.
+     */
+    extern bool readGraphBinary( const string & file, CSRGraph<PII> & V, VI * node_weights = nullptr,
+                                 VI * partition = nullptr, unsigned long long * key = nullptr );
 
 };
 
@@ -6,6 +6,7 @@
 #define ALGORITHMSPROJECT_GRAPHWRITER_H
 
 #include "Makros.h"
+#include "CSRGraph.h"
 
 namespace GraphWriter{
 
@@ -32,6 +33,28 @@ namespace GraphWriter{
      */
     extern void writeGraphDIMACS( VVI & V, ostream & out, bool edgeFoolowE = false, int addToId = 0 );
 
+    /**
+     * Writes graph to [file] in binary format described in GraphBinaryFormat.h. Such file can be loaded by
+     * GraphReader::readGraphBinary much faster than parsing a text format.
+     * The file is first written under a temporary name and then renamed, so readers never see a partially written file.
+     *
+     * E.g. to store a cluster graph: writeGraphBinary( CSRGraph<PII>(clg.V), file, &clg.node_weights )
+     * or a kernel: writeGraphBinary( CSRGraph<int>(kern.V), file, nullptr, &kern.inCl )
+     *
+     * @param node_weights if not nullptr, node weights will be stored
+     * @param partition if not nullptr, partition will be stored
+     * @param key value stored in the header, see GraphBinaryHeader::key
+     * @return true if the file was written successfully
+     */
+    extern bool writeGraphBinary( const CSRGraph<int> & V, const string & file, const VI * node_weights = nullptr,
+                                  const VI * partition = nullptr, unsigned long long key = 0 );
+
+    /**
+     * The same as above, for weighted graphs.
+     */
+    extern bool writeGraphBinary( const CSRGraph<PII> & V, const string & file, const VI * node_weights = nullptr,
+                                  const VI * partition = nullptr, unsigned long long key = 0 );
+
 }
 
 #endif //ALGORITHMSPROJECT_GRAPHWRITER_H
@@ -32,7 +32,12 @@ namespace RandomNumberGenerators{
 
 class UniformIntGenerator{
 public:
-    static int lastSeed;
+    /**
+     * Seed used for the next generator created with DEFAULT_SEED. It is kept per thread, so that generators can be
+     * created concurrently. Each worker thread should set its own value before creating generators, otherwise all
+     * threads would get the same sequence of seeds.
+     */
+    static thread_local int lastSeed;
 
     UniformIntGenerator( LL minVal, LL maxVal, LL seed = RandomNumberGenerators::DEFAULT_SEED ){
         unif = std::uniform_int_distribution<long long>(minVal, maxVal);
@@ -59,7 +64,7 @@ private:
 
 class UniformDoubleGenerator{
 public:
-    static int lastSeed;
+    static thread_local int lastSeed; // per-thread, see UniformIntGenerator::lastSeed
     UniformDoubleGenerator( double minVal, double maxVal, int seed = RandomNumberGenerators::DEFAULT_SEED ){
         rng.seed(lastSeed);
         lastSeed = (lastSeed + 1) % 1'000'000'007;
@@ -0,0 +1,89 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#ifndef ALGORITHMSPROJECT_THREADPOOL_H
+#define ALGORITHMSPROJECT_THREADPOOL_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include "Makros.h"
+
+/**
+ * Simple pool of persistent worker threads used to run independent tasks concurrently.
+ *
+ * Tasks are given as a range of indices [0,n). Indices are not assigned statically - each thread (including the calling
+ * one) repeatedly takes the next free index, so threads that finish early take over remaining work ('self scheduling').
+ * This gives good load balancing even if running times of tasks differ a lot (e.g. clusters of very different sizes).
+ *
+ * CAUTION! A task must not call [parallelFor] of the same pool - nested calls would deadlock. It is fine to use a
+ * different pool inside a task.
+ */
+class ThreadPool{
+public:
+    /**
+     * @param threads total number of threads used by [parallelFor], including the calling thread. If [threads] <= 1,
+     * then no worker threads are created and all tasks are run sequentially in the calling thread.
+     */
+    explicit ThreadPool( int threads );
+
+    ~ThreadPool();
+
+    ThreadPool( const ThreadPool& ) = delete;
+    ThreadPool& operator=( const ThreadPool& ) = delete;
+
+    /**
+     * Calls f(i) for each i in [0,n), concurrently, and returns when all calls are finished.
+     * Calling thread also executes tasks.
+     */
+    void parallelFor( int n, const function<void(int)> & f );
+
+    /**
+     * Same as [parallelFor], but calls f(i, thread_id), where thread_id is in range [0, size()) and identifies the
+     * thread that executes the task (0 is the calling thread). This way tasks can use per-thread helper objects.
+     */
+    void parallelForWithThreadId( int n, const function<void(int,int)> & f );
+
+    /**
+     * Runs all tasks concurrently and returns when all of them are finished.
+     */
+    void run( vector<function<void()>> & tasks );
+
+    /**
+     * @return total number of threads used, including the calling thread.
+     */
+    int size(){ return workers.size() + 1; }
+
+    /**
+     * @return number of hardware threads, at least 1.
+     */
+    static int hardwareThreads();
+
+//private:
+
+    void workerLoop( int thread_id );
+
+    vector<thread> workers;
+
+    mutex mtx;
+    condition_variable cv_job, cv_done;
+
+    /**
+     * Guards [parallelFor], so that only one job is processed at a time if many threads share the pool.
+     */
+    mutex run_mtx;
+
+    const function<void(int,int)> * job = nullptr;
+    int job_size = 0;
+    int generation = 0; // incremented with each new job
+    int active = 0; // number of workers currently processing [job]
+    bool stop = false;
+
+    atomic<int> next_index;
+    atomic<int> finished;
+};
+
+#endif //ALGORITHMSPROJECT_THREADPOOL_H
@@ -14,6 +14,7 @@
 #ifndef TIMEMEASURER_H
 #define TIMEMEASURER_H
 
+#include <mutex>
 #include "Makros.h"
 
 
@@ -72,6 +73,11 @@ private:
     
     
     static map<string,LL> times;
+    /**
+     * Guards [times] and [timesTotal], so that measurements can be started and stopped from many threads.
+     */
+    static recursive_mutex mtx;
+
     static map<string,LL> timesTotal; // total time of measurement for given parameter in clock() units (CLICKS_PER_SEC). Sum of times between startMEasurement() and stopMeasurement()
 };
 
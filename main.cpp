@@ -1,7 +1,40 @@
 #include <clues/main_CE.h>
 
 int main( int argc, char **argv  ) {
-    main_CE();
+    int threads = 1;
+    string cache_file = "";
+    string anytime_file = "";
+
+    auto usage = [&](){
+        cerr << "Usage: " << argv[0] << " [-t|--threads N] [--cache FILE] [--anytime FILE] < graph.gr" << endl;
+        return 1;
+    };
+
+    for( int i=1; i<argc; i++ ){
+        string arg = argv[i];
+        if( arg != "-t" && arg != "--threads" && arg != "--cache" && arg != "--anytime" ){
+            cerr << "Unknown argument: " << arg << endl;
+            return usage();
+        }
+        if( i+1 == argc ){
+            cerr << "Missing value for argument " << arg << endl;
+            return usage();
+        }
+
+        string val = argv[++i];
+        if( arg == "-t" || arg == "--threads" ){
+            char* end;
+            long t = strtol( val.c_str(), &end, 10 );
+            if( val.empty() || *end != '\0' || t < 1 ){
+                cerr << "Invalid number of threads: " << val << endl;
+                return usage();
+            }
+            threads = t;
+        }
+        if( arg == "--cache" ) cache_file = val;
+        if( arg == "--anytime" ) anytime_file = val;
+    }
+
+    main_CE(threads, cache_file, anytime_file);
     return 0;
 }
-
@@ -0,0 +1,110 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#include <clues/heur/SwapCandidates/ComponentExpansionAttraction.h>
+#include <clues/heur/Global.h>
+#include <atomic>
+#include <new>
+
+/**
+ * Number of calls to operator new - all allocations in the program are counted.
+ */
+static atomic<long long> allocations(0);
+
+void* operator new( size_t size ){
+    allocations++;
+    void* p = malloc( size == 0 ? 1 : size );
+    if( p == nullptr ) throw bad_alloc();
+    return p;
+}
+
+void operator delete( void* p ) noexcept { free(p); }
+void operator delete( void* p, size_t ) noexcept { free(p); }
+
+/**
+ * Measures time and number of memory allocations of ComponentExpansionAttraction::createSwapCandidates() (the
+ * exp_ord_attr creator) called for all clusters of a large State.
+ *
+ * Usage:
+ * ComponentExpansionAttractionBenchmark [N] [repetitions]
+ * A random graph with N nodes (default 10^5) is generated, with planted clusters of sizes 5..30 (each edge inside a
+ * cluster is present with probability 0.7) and 2N random edges between clusters. The state is created for the planted
+ * partition.
+ */
+int main( int argc, char **argv ) {
+    const int N = (argc > 1) ? stoi(argv[1]) : 100'000;
+    const int REPS = (argc > 2) ? stoi(argv[2]) : 5;
+
+    Global::startAlg();
+    Global::max_runtime_in_seconds = 1e9;
+
+    mt19937 gen(7);
+    VVI V(N);
+    VI partition(N);
+    {
+        uniform_real_distribution<double> prob(0,1);
+        uniform_int_distribution<int> cl_size(5,30), node(0,N-1);
+
+        int cnt = 0;
+        for( int b = 0; b < N; ){
+            int e = min( N, b + cl_size(gen) );
+            for( int i=b; i<e; i++ ){
+                partition[i] = cnt;
+                for( int j=i+1; j<e; j++ ){
+                    if( prob(gen) < 0.7 ){ V[i].push_back(j); V[j].push_back(i); }
+                }
+            }
+            cnt++;
+            b = e;
+        }
+
+        for( int i=0; i<2*N; i++ ){
+            int a = node(gen), b = node(gen);
+            if( partition[a] == partition[b] ) continue;
+            V[a].push_back(b);
+            V[b].push_back(a);
+        }
+        for( auto & neigh : V ){
+            sort(ALL(neigh));
+            neigh.resize( unique(ALL(neigh)) - neigh.begin() );
+        }
+    }
+
+    VI ids(N);
+    iota(ALL(ids),0);
+    ClusterGraph clg( &V, ids );
+    State st( clg, SINGLE_NODES );
+    st.applyPartition(partition);
+
+    clog << "N: " << N << ", clusters: " << st.clusters.size() << endl;
+
+    ComponentExpansionAttraction cea(st);
+    cea.keep_only_nonpositive_candidates = true;
+
+    long long calls = 0, candidates = 0, allocs = 0;
+    double secs = 0;
+    for( int r=0; r<REPS; r++ ){
+        long long allocs_before = allocations;
+        auto start = chrono::steady_clock::now();
+
+        for( auto & cl : st.clusters ){
+            if( cl.id == st.getIdOfEmptyCluster() ) continue;
+            auto res = cea.createSwapCandidates(cl);
+            candidates += res.second.size();
+            delete res.first;
+            calls++;
+        }
+
+        secs += chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+        allocs += allocations - allocs_before;
+    }
+
+    clog << "createSwapCandidates(Cluster&) calls: " << calls << ", candidates: " << candidates << endl;
+    clog << "time: " << secs << " s, " << (1e6 * secs / calls) << " us per call" << endl;
+    clog << "allocations: " << allocs << ", " << ((double)allocs / calls) << " per call" << endl;
+    clog << "(each call allocates at least the returned ExpansionOrderAttraction, its order and the vector of "
+            "candidates)" << endl;
+
+    return 0;
+}
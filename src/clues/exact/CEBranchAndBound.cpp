@@ -0,0 +1,163 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#include <clues/exact/CEBranchAndBound.h>
+#include <clues/heur/PaceUtils.h>
+#include <clues/heur/Global.h>
+
+CEBranchAndBound::CEBranchAndBound(VVI &V) {
+    this->V = &V;
+    N = V.size();
+
+    orig_adj = VVB( N, VB(N,false) );
+    for( int i=0; i<N; i++ ) for( int w : V[i] ) orig_adj[i][w] = true;
+    adj = orig_adj;
+
+    fixed = VVI( N, VI(N,0) );
+    used = VVI( N, VI(N,0) );
+    G.resize(N);
+}
+
+bool CEBranchAndBound::solve(VI init_part, LL max_branches) {
+    best_partition = init_part;
+    best_result = PaceUtils::evaluateSolution( *V, init_part );
+    optimal = true;
+    branches = 0;
+    this->max_branches = max_branches;
+
+    branch();
+    return optimal;
+}
+
+bool CEBranchAndBound::fix(int a, int b, int val) {
+    fix_queue.clear();
+    fix_queue.emplace_back( a,b,val );
+
+    for( int i=0; i<fix_queue.size(); i++ ){
+        auto [u,v,t] = fix_queue[i];
+        if( fixed[u][v] == t ) continue;
+        if( fixed[u][v] != 0 ) return false;
+
+        fixed[u][v] = fixed[v][u] = t;
+        trail.emplace_back(u,v);
+
+        bool e = ( t == 1 );
+        if( adj[u][v] != e ){
+            adj[u][v] = adj[v][u] = e;
+            cost++;
+        }
+
+        for( int w=0; w<N; w++ ){
+            if( w == u || w == v ) continue;
+            if( t == 1 ){ // u and v must be in the same cluster, so they have the same relation with all other nodes
+                if( fixed[u][w] != 0 ) fix_queue.emplace_back( v, w, fixed[u][w] );
+                if( fixed[v][w] != 0 ) fix_queue.emplace_back( u, w, fixed[v][w] );
+            }else{
+                if( fixed[u][w] == 1 ) fix_queue.emplace_back( v, w, -1 );
+                if( fixed[v][w] == 1 ) fix_queue.emplace_back( u, w, -1 );
+            }
+        }
+    }
+
+    return true;
+}
+
+void CEBranchAndBound::undo(int trail_size) {
+    while( trail.size() > trail_size ){
+        auto [u,v] = trail.back();
+        trail.pop_back();
+
+        fixed[u][v] = fixed[v][u] = 0;
+        if( adj[u][v] != orig_adj[u][v] ){
+            adj[u][v] = adj[v][u] = orig_adj[u][v];
+            cost--;
+        }
+    }
+}
+
+int CEBranchAndBound::lowerBound(vector<tuple<int, int, int>> &triples) {
+    for( VI & b : triples_by_free_pairs ) b.clear();
+
+    for( int i=0; i<triples.size(); i++ ){
+        auto [a,b,c] = triples[i];
+        int free_pairs = ( fixed[a][b] == 0 ) + ( fixed[b][c] == 0 ) + ( fixed[a][c] == 0 );
+        if( free_pairs == 0 ) return N*N; // conflict triple that cannot be resolved
+        triples_by_free_pairs[free_pairs-1].push_back(i);
+    }
+
+    used_stamp++;
+    int lb = 0;
+
+    for( VI & bucket : triples_by_free_pairs ){
+        for( int i : bucket ){
+            auto [a,b,c] = triples[i];
+            PII pairs[3] = { {a,b}, {b,c}, {a,c} };
+
+            bool available = true;
+            for( auto [x,y] : pairs ) if( fixed[x][y] == 0 && used[x][y] == used_stamp ) available = false;
+            if( !available ) continue;
+
+            for( auto [x,y] : pairs ) if( fixed[x][y] == 0 ) used[x][y] = used[y][x] = used_stamp;
+            lb++;
+        }
+    }
+
+    return lb;
+}
+
+VI CEBranchAndBound::currentPartition() {
+    VI part(N,-1);
+    int cnt = 0;
+    for( int i=0; i<N; i++ ){
+        if( part[i] != -1 ) continue;
+        part[i] = cnt;
+        for( int w : G[i] ) part[w] = cnt;
+        cnt++;
+    }
+    return part;
+}
+
+void CEBranchAndBound::branch() {
+    if( branches >= max_branches || ( (branches & 63) == 0 && Global::checkTle() ) ){
+        optimal = false;
+        return;
+    }
+    branches++;
+
+    for( int i=0; i<N; i++ ){
+        G[i].clear();
+        for( int j=0; j<N; j++ ) if( adj[i][j] ) G[i].push_back(j);
+    }
+
+    auto triples = PaceUtils::getInducedP2Paths(G);
+    if( triples.empty() ){
+        if( cost < best_result ){
+            best_result = cost;
+            best_partition = currentPartition();
+        }
+        return;
+    }
+
+    if( cost + lowerBound(triples) >= best_result ) return;
+
+    // branching on a triple with the largest number of marked pairs - some branches will be infeasible
+    tuple<int,int,int> t;
+    for( VI & bucket : triples_by_free_pairs ){
+        if( bucket.empty() ) continue;
+        t = triples[ bucket[0] ];
+        break;
+    }
+
+    auto [a,b,c] = t;
+    int trail_size = trail.size();
+
+    if( fix(a,b,-1) ) branch();
+    undo(trail_size);
+
+    if( fix(a,b,1) && fix(b,c,-1) ) branch();
+    undo(trail_size);
+
+    if( fix(a,b,1) && fix(b,c,1) ) branch();
+    undo(trail_size);
+}
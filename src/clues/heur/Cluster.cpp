@@ -4,11 +4,9 @@
 
 #include "clues/heur/Cluster.h"
 
-VI Cluster::helper(1,-1);
-
-Cluster::Cluster( ClusterGraph & v, VI nodes, int id ) {
+Cluster::Cluster( ClusterGraph & v, VI nodes, int id, Workspace & ws ) {
     if( !nodes.empty() ){
-        g = induce(v,nodes, helper);
+        g = induce(v,nodes, ws.induce_helper);
         cluster_weight = accumulate( ALL(g.node_weights),0 );
     }
     this->id = id;
@@ -16,14 +16,14 @@ ostream& operator<<( ostream& str, ClusterGraph& g ){
 
 
 
-ClusterGraph::ClusterGraph(VVI *V, VI partition) {
+ClusterGraph::ClusterGraph(VVI *V, VI partition, ThreadPool * pool) {
     origV = V;
     this->partition = partition;
 
-    createGraph();
+    createGraph(pool);
 }
 
-void ClusterGraph::createGraph() {
+void ClusterGraph::createGraph( ThreadPool * pool ) {
     int N = origV->size();
 
 //    partition = origPartition;
@@ -48,32 +48,97 @@ void ClusterGraph::createGraph() {
 //    DEBUG(clusterNodes);
 
     node_weights = VI(cnt,0);
+    for( int i=0; i<cnt; i++ ) node_weights[i] = clusterNodes[i].size();
+
+    const int T = ( pool == nullptr ) ? 1 : pool->size();
+    const int chunks = ( pool == nullptr ) ? 1 : max( 1, min( cnt, 4*T ) );
+
+    // chunk c contains clusters chunk_begin[c], ..., chunk_begin[c+1]-1, chunks have roughly equal sums of degrees
+    VI chunk_begin(chunks+1, cnt);
+    chunk_begin[0] = 0;
+    if( chunks > 1 ){
+        LL total = 0;
+        for( int i=0; i<N; i++ ) if( partition[i] >= 0 ) total += (*origV)[i].size() + 1;
+
+        LL sum = 0;
+        int c = 1;
+        for( int a=0; a<cnt && c < chunks; a++ ){
+            for( int d : clusterNodes[a] ) sum += (*origV)[d].size() + 1;
+            while( c < chunks && sum * chunks >= total * c ) chunk_begin[c++] = a+1;
+        }
+    }
 
-    map<PII,int> edge_weights;
-    for( int i=0; i<N; i++ ){
-        if( partition[i] < 0 ) continue;
-
-        node_weights[ partition[i] ]++;
+    /**
+     * chunk_adj[c] are unsorted neighbor lists of clusters in chunk c, one after another. Neighbors of cluster a are
+     * on positions [ adj_end[a-1], adj_end[a] ) (or [ 0, adj_end[a] ) for the first cluster in the chunk).
+     */
+    vector<VPII> chunk_adj(chunks);
+    VI adj_end(cnt);
+
+    vector<VI> last_seen( T, VI(cnt,-1) ), weight( T, VI(cnt) );
+
+    auto contractChunk = [&]( int c, int t ){
+        VI & seen = last_seen[t];
+        VI & w = weight[t];
+        VPII & out = chunk_adj[c];
+
+        for( int a = chunk_begin[c]; a < chunk_begin[c+1]; a++ ){
+            int beg = out.size();
+            for( int i : clusterNodes[a] ){
+                for( int d : (*origV)[i] ){
+                    int b = partition[d];
+                    if( b < 0 || b == a ) continue;
+                    if( seen[b] != a ){
+                        seen[b] = a;
+                        w[b] = 0;
+                        out.emplace_back(b,0);
+                    }
+                    w[b]++;
+                }
+            }
 
-        for( int d : (*origV)[i] ){
-            if( i < d ){
-                int a = partition[i];
-                int b = partition[d];
-                if(b<0) continue;
+            for( int k=beg; k<out.size(); k++ ) out[k].second = w[ out[k].first ];
+            adj_end[a] = out.size();
+        }
+    };
+
+    if( pool == nullptr ) contractChunk(0,0);
+    else pool->parallelForWithThreadId( chunks, contractChunk );
+
+    // each edge (a,b) is in the list of a and in the list of b, so degrees are sizes of lists
+    csr.offsets.assign(cnt+1, 0);
+    for( int c=0; c<chunks; c++ ){
+        int beg = 0;
+        for( int a = chunk_begin[c]; a < chunk_begin[c+1]; a++ ){
+            csr.offsets[a+1] = csr.offsets[a] + ( adj_end[a] - beg );
+            beg = adj_end[a];
+        }
+    }
 
-                if(a>b) swap(a,b);
-                if( a == b ) continue;
-                edge_weights[ {a,b} ]++;
+    // transposition - clusters a are appended in increasing order, so neighbors in csr are sorted by id
+    csr.adj.resize( csr.offsets[cnt] );
+    VI pos( csr.offsets.begin(), csr.offsets.end()-1 );
+    for( int c=0; c<chunks; c++ ){
+        int beg = 0;
+        for( int a = chunk_begin[c]; a < chunk_begin[c+1]; a++ ){
+            for( int k=beg; k<adj_end[a]; k++ ){
+                auto [b,w] = chunk_adj[c][k];
+                csr.adj[ pos[b]++ ] = {a,w};
             }
+            beg = adj_end[a];
         }
     }
 
     this->N = cnt;
-    V = VVPII(cnt);
-    for( auto [e,w] : edge_weights ){
-        auto [a,b] = e;
-        GraphUtils::addEdge( V,a,b,w );
-    }
+    V = csr.toVV();
+    csr_valid = true;
+}
+
+void ClusterGraph::setGraph( VVPII g ) {
+    V = std::move(g);
+    N = V.size();
+    csr = CSRGraph<PII>(V);
+    csr_valid = true;
 }
 
 
@@ -0,0 +1,292 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#include <clues/heur/ComponentSolver.h>
+#include <clues/heur/PaceUtils.h>
+#include <clues/heur/Global.h>
+#include <clues/kernelization/CEKernelizer.h>
+#include <clues/exact/CEBranchAndBound.h>
+#include <graphs/components/ConnectedComponents.h>
+#include <graphs/GraphUtils.h>
+#include <datastructures/FAU.h>
+#include <utils/ThreadPool.h>
+
+ComponentSolver::ComponentSolver(VVI &V, Config &cnf) {
+    this->V = &V;
+    this->cnf = &cnf;
+    N = V.size();
+    id_in_comp = mapper = VI(N,-1);
+
+    createComponents();
+}
+
+void ComponentSolver::createComponents() {
+    init_partition = VI(N);
+    iota( ALL(init_partition), 0 );
+    solved = VB(N,false);
+
+    if( cnf->component_decomposition_use_kernelization ){
+        CEKernelizer kern(*V);
+        kern.fullKernelization(false,0);
+
+        // nodes from the same cluster marked by the kernelizer must be in the same component
+        FAU fau(N);
+        for( int i=0; i<N; i++ ){
+            for( int w : kern.V[i] ) if( i < w ) fau.Union(i,w);
+            fau.Union( i, kern.fau.Find(i) );
+        }
+
+        VVI comps(N);
+        for( int i=0; i<N; i++ ) comps[ fau.Find(i) ].push_back(i);
+        for( VI & c : comps ) if( !c.empty() ) components.push_back( move(c) );
+
+        for( int i=0; i<N; i++ ){
+            init_partition[i] = kern.fau.Find(i);
+            solved[i] = !kern.inV[i] && kern.V[i].empty();
+        }
+    }else{
+        components = ConnectedComponents::getConnectedComponents(*V);
+        for( VI & c : components ) sort( ALL(c) );
+    }
+}
+
+VVI ComponentSolver::induce(VI &comp) {
+    for( int i=0; i<comp.size(); i++ ) id_in_comp[ comp[i] ] = i;
+    VVI G( comp.size() );
+    for( int i=0; i<comp.size(); i++ ){
+        for( int w : (*V)[ comp[i] ] ) if( id_in_comp[w] != -1 ) G[i].push_back( id_in_comp[w] );
+    }
+    for( int d : comp ) id_in_comp[d] = -1;
+    return G;
+}
+
+VI ComponentSolver::initPartition(VI &comp) {
+    VI part( comp.size() );
+    int cnt = 0;
+    for( int i=0; i<comp.size(); i++ ){
+        int & p = mapper[ init_partition[ comp[i] ] ];
+        if( p == -1 ) p = cnt++;
+        part[i] = p;
+    }
+    for( int d : comp ) mapper[ init_partition[d] ] = -1;
+    return part;
+}
+
+bool ComponentSolver::solvedExactly(VI &comp) {
+    for( int d : comp ) if( !solved[d] ) return false;
+    return true;
+}
+
+int ComponentSolver::countLargeComponents() {
+    int cnt = 0;
+    for( VI & comp : components ) if( comp.size() > cnf->component_exact_max_size && !solvedExactly(comp) ) cnt++;
+    return cnt;
+}
+
+void ComponentSolver::solveSmallComponents(int threads, double seconds) {
+    const bool debug = !Global::disable_all_logs;
+    const double start = Global::preciseSecondsFromStart(), deadline = start + seconds;
+
+    VI small;
+    for( int c=0; c<components.size(); c++ ){
+        VI & comp = components[c];
+        if( !solvedExactly(comp) && comp.size() <= cnf->component_exact_max_size ) small.push_back(c);
+    }
+    // the largest components first, so that threads are not left with a single long task at the end
+    sort( ALL(small), [&]( int a, int b ){ return components[a].size() > components[b].size(); } );
+
+    // graphs are induced before, since helper arrays are shared
+    vector<VVI> small_graphs( small.size() );
+    VVI parts( small.size() );
+    for( int i=0; i<small.size(); i++ ){
+        small_graphs[i] = induce( components[ small[i] ] );
+        parts[i] = initPartition( components[ small[i] ] );
+    }
+
+    VI optimal( small.size(), 0 );
+    ThreadPool pool( max( 1, min<int>( threads, small.size() ) ) );
+    pool.parallelFor( small.size(), [&]( int i ){
+        Global::thread_deadline = deadline;
+        CEBranchAndBound bb( small_graphs[i] );
+        optimal[i] = bb.solve( parts[i], cnf->component_exact_max_branches );
+        parts[i] = bb.best_partition;
+        Global::thread_deadline = numeric_limits<double>::max();
+    } );
+    const double exact_time = Global::preciseSecondsFromStart() - start;
+
+    int bb_solved = 0, bb_unsolved = 0;
+    for( int i=0; i<small.size(); i++ ){
+        VI & comp = components[ small[i] ];
+        for( int j=0; j<comp.size(); j++ ){
+            init_partition[ comp[j] ] = comp[ parts[i][j] ];
+            solved[ comp[j] ] = optimal[i];
+        }
+        if( optimal[i] ) bb_solved++;
+        else bb_unsolved++;
+    }
+
+    groupComponents();
+
+    const int C = components.size();
+    graphs.resize(C);
+    best_partitions.resize(C);
+    best_results.resize(C);
+    weights = VD(C,0);
+
+    edges_between_components = GraphUtils::countEdges(*V);
+    for( int c=0; c<C; c++ ){
+        VI & comp = components[c];
+        VVI & G = graphs[c];
+        G = induce(comp);
+
+        best_partitions[c] = initPartition(comp);
+        best_results[c] = PaceUtils::evaluateSolution( G, best_partitions[c] );
+        edges_between_components -= GraphUtils::countEdges(G);
+
+        if( !solvedExactly(comp) ){
+            large_components.push_back(c);
+            weights[c] = ( comp.size() + GraphUtils::countEdges(G) ) * max( 0.1, editDensity(G) );
+        }
+    }
+
+    sort( ALL(large_components), [&]( int a, int b ){
+        if( weights[a] != weights[b] ) return weights[a] > weights[b];
+        return a < b;
+    } );
+
+    if(debug){
+        clog << "ComponentSolver: " << C << " components, " << large_components.size() << " large components, "
+             << edges_between_components << " edges between components" << endl;
+        clog << "Small components solved by branch and bound: " << bb_solved << ", not solved within the limits: "
+             << bb_unsolved << ", time: " << exact_time << endl;
+        if( !large_components.empty() ){
+            clog << "Largest component - nodes: " << components[ large_components[0] ].size() << ", edges: "
+                 << GraphUtils::countEdges( graphs[ large_components[0] ] ) << ", edit density: "
+                 << editDensity( graphs[ large_components[0] ] ) << endl;
+        }
+        clog << "Result before solving large components: " << getResult() << endl;
+    }
+}
+
+void ComponentSolver::groupComponents() {
+    VI comp_of(N);
+    for( int c=0; c<components.size(); c++ ) for( int d : components[c] ) comp_of[d] = c;
+
+    VVI groups, large;
+    VLL weights;
+    for( VI & comp : components ){
+        if( solvedExactly(comp) ){
+            groups.push_back( move(comp) );
+            continue;
+        }
+
+        LL w = comp.size();
+        for( int d : comp ) for( int u : (*V)[d] ) if( d < u && comp_of[u] == comp_of[d] ) w++;
+        large.push_back( move(comp) );
+        weights.push_back(w);
+    }
+
+    VI order( large.size() );
+    iota( ALL(order), 0 );
+    sort( ALL(order), [&]( int a, int b ){ return weights[a] > weights[b]; } );
+
+    // components are added to the current group, until its weight reaches the limit
+    LL group_weight = 0;
+    for( int i : order ){
+        if( group_weight == 0 || group_weight >= cnf->component_min_group_weight ){
+            groups.push_back( {} );
+            group_weight = 0;
+        }
+        VI & group = groups.back();
+        group.insert( group.end(), ALL(large[i]) );
+        group_weight += weights[i];
+    }
+
+    for( VI & g : groups ) sort( ALL(g) );
+    components = move(groups);
+}
+
+void ComponentSolver::solveLargeComponents(int threads, double seconds, const SolveFunction &solve) {
+    if( large_components.empty() ) return;
+
+    const double start = Global::preciseSecondsFromStart();
+
+    double total_weight = 0;
+    for( int c : large_components ) total_weight += weights[c];
+
+    ThreadPool pool( max( 1, min<int>( threads, large_components.size() ) ) );
+    const int P = pool.size();
+
+    pool.parallelForWithThreadId( large_components.size(), [&]( int i, int thread_id ){
+        int c = large_components[i];
+        double budget = min( seconds, seconds * P * weights[c] / total_weight );
+        double now = Global::preciseSecondsFromStart();
+
+        // budget is hard - otherwise a single long iteration of [solve] could use the time of other components
+        Global::thread_deadline = min( now + budget, start + seconds );
+        solve( c, thread_id, Global::thread_deadline );
+        Global::thread_deadline = numeric_limits<double>::max();
+    } );
+}
+
+bool ComponentSolver::updateBestPartition(int comp, VI &part) {
+    int res = PaceUtils::evaluateSolution( graphs[comp], part );
+    lock_guard<mutex> lock(mtx);
+    if( res >= best_results[comp] ) return false;
+    best_results[comp] = res;
+    best_partitions[comp] = part;
+    return true;
+}
+
+VI ComponentSolver::getPartition(int *result) {
+    lock_guard<mutex> lock(mtx);
+    if( result != nullptr ){
+        *result = edges_between_components;
+        for( int r : best_results ) *result += r;
+    }
+
+    VI part(N);
+    int offset = 0;
+    for( int c=0; c<components.size(); c++ ){
+        VI & comp = components[c];
+        for( int i=0; i<comp.size(); i++ ) part[ comp[i] ] = offset + best_partitions[c][i];
+        offset += comp.size();
+    }
+    return part;
+}
+
+int ComponentSolver::getResult() {
+    lock_guard<mutex> lock(mtx);
+    int res = edges_between_components;
+    for( int r : best_results ) res += r;
+    return res;
+}
+
+double ComponentSolver::editDensity(VVI &G) {
+    const int n = G.size();
+    const int SAMPLE_NODES = 200, SAMPLE_EDGES_PER_NODE = 20;
+
+    VB in_neigh(n,false);
+    double sum = 0;
+    int cnt = 0;
+
+    for( int v = 0; v < n; v += max( 1, n / SAMPLE_NODES ) ){
+        in_neigh[v] = true;
+        for( int u : G[v] ) in_neigh[u] = true;
+
+        for( int j=0; j < G[v].size() && j < SAMPLE_EDGES_PER_NODE; j++ ){
+            int u = G[v][j];
+            int common = 1; // u itself
+            for( int w : G[u] ) if( in_neigh[w] ) common++;
+            int all = G[v].size() + G[u].size() + 2 - common;
+            sum += 1.0 - (double)common / all;
+            cnt++;
+        }
+
+        in_neigh[v] = false;
+        for( int u : G[v] ) in_neigh[u] = false;
+    }
+
+    return cnt == 0 ? 0 : sum / cnt;
+}
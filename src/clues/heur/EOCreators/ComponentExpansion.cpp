@@ -8,21 +8,39 @@
 
 
 ComponentExpansion::ComponentExpansion( Cluster & cl ){
+    cmp_rules = { 3,2,1 }; // by default rules are executed in order 3,2,1
+    setCluster(cl);
+}
+
+ComponentExpansion::ComponentExpansion(){
+    cl = nullptr;
+    clg = nullptr;
+    V = nullptr;
+    N = 0;
+    sumNWinS = 0;
+    cmp_rules = { 3,2,1 };
+}
+
+void ComponentExpansion::setCluster(Cluster &cl) {
     this->cl = &cl;
     this->clg = &cl.g;
     V = &clg->V;
     N = V->size();
-    eInS = VI(N, 0);
 
-    sumEW = VI(N, 0);
-    for( int i=0; i<N; i++ ) for( auto & [d,w] : (*V)[i] ) sumEW[i] += w;
+    // [eInS] and [inS] are cleared at the end of each getExpansionOrder(), so only new fields need to be initialized
+    if( eInS.size() < N ) eInS.resize(N, 0);
+    if( inS.size() < N ) inS.resize(N, false);
 
-    inS = VB(N,false);
-    sumNWinS = 0;
+    if( sumEW.size() < N ) sumEW.resize(N);
+    for( int i=0; i<N; i++ ){
+        sumEW[i] = 0;
+        for( auto & [d,w] : (*V)[i] ) sumEW[i] += w;
+    }
 
-    cmp_rules = { 3,2,1 }; // by default rules are executed in order 3,2,1
+    sumNWinS = 0;
 
-    {
+    if( heap_capacity < N ){
+        heap_capacity = N;
         heap = Heap<int>( N,0, [&](int a, int b ){ return cmpFun(a, b); } );
         for( int i=0; i<N; i++ ){
             heap.removeFromHeap(i); // removing all elements from heap - only those that will be necessary will be
@@ -10,16 +10,19 @@ namespace Global{
 
     volatile sig_atomic_t tle = 0;
 
-    int max_runtime_in_seconds = 580;
+    atomic<int> max_runtime_in_seconds(580);
 
     const bool CONTEST_MODE = false;
 
     const bool disable_all_logs = CONTEST_MODE; // by default should be equal to CONTEST_MODE
 //    const bool disable_all_logs = false; // by default should be equal to CONTEST_MODE
 
+    thread_local double thread_deadline = numeric_limits<double>::max();
+
     bool checkTle() {
         //return tle;
-        return secondsFromStart() > max_runtime_in_seconds;
+        double t = preciseSecondsFromStart();
+        return (int)t > max_runtime_in_seconds || t > thread_deadline;
     }
 
     void terminate(int signum) {
@@ -35,6 +38,10 @@ namespace Global{
     }
 
     int secondsFromStart(){
+        return preciseSecondsFromStart();
+    }
+
+    double preciseSecondsFromStart(){
         chrono::high_resolution_clock::time_point now = high_resolution_clock::now();
         duration<double> time_span = duration_cast<duration<double>>(now - start_time);
         return time_span.count();
@@ -33,6 +33,31 @@ namespace PaceUtils{
         return res;
    }
 
+    VPII getModifications(VVI &V, VI &part) {
+        const int N = V.size();
+        VVI clusters = PaceUtils::partitionToClusters(part); // nodes in each cluster are sorted
+
+        VI pos_in_cl(N);
+        for( VI & cl : clusters ) for( int i=0; i<cl.size(); i++ ) pos_in_cl[cl[i]] = i;
+
+        VI marker(N,-1);
+        VPII mods;
+
+        // modifications are created in lexicographic order, node by node
+        for( int a=0; a<N; a++ ){
+            int beg = mods.size();
+            for( int b : V[a] ) marker[b] = a;
+
+            VI & cl = clusters[ part[a] ];
+            for( int i = pos_in_cl[a]+1; i<cl.size(); i++ ) if( marker[cl[i]] != a ) mods.emplace_back(a,cl[i]); // additions
+            for( int b : V[a] ) if( b > a && part[b] != part[a] ) mods.emplace_back(a,b); // deletions
+
+            sort( mods.begin() + beg, mods.end() );
+        }
+
+        return mods;
+    }
+
     tuple<int, int, int> getEdgeModificationStatistics(VVI &V, VI &partition) {
         int insertions = 0, deletions = 0, modifications = 0;
         int N = V.size();
@@ -0,0 +1,88 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#include <charconv>
+#include "clues/heur/SolutionWriter.h"
+#include "clues/heur/Global.h"
+
+SolutionWriter::SolutionWriter(string file) : file(file) {
+    writer = thread( [this](){ writerLoop(); } );
+}
+
+SolutionWriter::~SolutionWriter() {
+    {
+        lock_guard<mutex> lock(mtx);
+        stop = true;
+    }
+    cv.notify_all();
+    writer.join();
+}
+
+void SolutionWriter::submit(VPII &mods, int result) {
+    {
+        lock_guard<mutex> lock(mtx);
+        swap( pending, mods );
+        has_pending = true;
+    }
+    cv.notify_all();
+    if(!Global::disable_all_logs) clog << "Submitted solution with result " << result << " to be written" << endl;
+}
+
+void SolutionWriter::flush() {
+    unique_lock<mutex> lock(mtx);
+    cv.wait( lock, [&](){ return !has_pending && !writing; } );
+}
+
+void SolutionWriter::writerLoop() {
+    VPII mods;
+    while(true){
+        {
+            unique_lock<mutex> lock(mtx);
+            cv.wait( lock, [&](){ return stop || has_pending; } );
+            if( !has_pending ) return; // stop, nothing more to write
+
+            swap( mods, pending );
+            has_pending = false;
+            writing = true;
+        }
+
+        write(mods);
+
+        {
+            lock_guard<mutex> lock(mtx);
+            writing = false;
+        }
+        cv.notify_all();
+    }
+}
+
+string SolutionWriter::format(const VPII &mods) {
+    string res;
+    res.resize( 24 * mods.size() );
+    char* p = res.data();
+    for( auto & [a,b] : mods ){
+        p = to_chars( p, p+11, a+1 ).ptr;
+        *p++ = ' ';
+        p = to_chars( p, p+11, b+1 ).ptr;
+        *p++ = '\n';
+    }
+    res.resize( p - res.data() );
+    return res;
+}
+
+void SolutionWriter::write(const VPII &mods) {
+    string tmp = file + ".tmp";
+    {
+        ofstream out( tmp, ios::binary );
+        string s = format(mods);
+        out.write( s.data(), s.size() );
+        out.close();
+        if( !out ){
+            cerr << "Could not write solution to file " << tmp << endl;
+            return;
+        }
+    }
+
+    if( rename( tmp.c_str(), file.c_str() ) != 0 ) cerr << "Could not rename " << tmp << " to " << file << endl;
+}
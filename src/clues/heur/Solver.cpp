@@ -4,7 +4,10 @@
 
 #include <graphs/GraphUtils.h>
 #include <datastructures/FAU.h>
+#include <datastructures/HashBuckets.h>
 #include <utils/RandomNumberGenerators.h>
+#include <utils/TimeMeasurer.h>
+#include <climits>
 #include <clues/heur/PaceUtils.h>
 #include <clues/heur/SwapCandidates/SwapCandidate.h>
 #include <clues/heur/ExpansionOrder.h>
@@ -17,9 +20,9 @@
 #include <clues/heur/Global.h>
 #include <clues/heur/StateImprovers/NodeEdgeGreedy.h>
 #include <clues/kernelization/CEKernelizer.h>
+#include <graphs/GraphReader.h>
+#include <graphs/GraphWriter.h>
 #include <clues/heur/StateImprovers/SparseGraphTrimmer.h>
-#include <clues/heur/StateImprovers/NodeEdgeGreedyNomap.h>
-#include <clues/heur/StateImprovers/NodeEdgeGreedyW1.h>
 #include "clues/heur/Solver.h"
 
 Solver::Solver(VVI & V, VI initial_partition, Config& cnf, int rec_depth){
@@ -47,6 +50,26 @@ Solver::~Solver(){
         delete st;
         st = nullptr;
     }
+
+    if(creators_pool != nullptr){
+        delete creators_pool;
+        creators_pool = nullptr;
+    }
+
+    if(eo_pool != nullptr){
+        delete eo_pool;
+        eo_pool = nullptr;
+    }
+
+    if(neg_pool != nullptr){
+        if(owns_neg_pool) delete neg_pool;
+        neg_pool = nullptr;
+    }
+
+    if(clg_pool != nullptr){
+        delete clg_pool;
+        clg_pool = nullptr;
+    }
 }
 
 void Solver::run(int iters) {
@@ -55,10 +78,12 @@ void Solver::run(int iters) {
     const bool debug = ( recurrence_depth == 0 );
     const bool debug_all = false;
 
-    if(recurrence_depth == 0 && cnf->use_kernelization){
+    const int kernel_variant = 2 * cnf->use_heuristic_kernelization;
+    if(recurrence_depth == 0 && cnf->use_kernelization && !loadKernelFromCache(kernel_variant)){
         CEKernelizer kern( *origV );
         kern.fullKernelization(cnf->use_heuristic_kernelization,0);
         partition = kern.inCl;
+        saveKernelToCache(kern, kernel_variant);
         clog << "Kernelization done!" << endl;
     }
 
@@ -111,7 +136,8 @@ void Solver::run(int iters) {
 void Solver::run_recursive() {
     const bool debug = ( recurrence_depth <= 5 );
 
-    if(recurrence_depth == 0 && cnf->use_kernelization){
+    const int kernel_variant = 1 + 2 * cnf->use_heuristic_kernelization + 4 * cnf->use_only_fast_exact_kernelization;
+    if(recurrence_depth == 0 && cnf->use_kernelization && !loadKernelFromCache(kernel_variant)){
         CEKernelizer kern( *origV );
 //        kern.fullKernelization(cnf->use_heuristic_kernelization,0);
 
@@ -125,6 +151,7 @@ void Solver::run_recursive() {
         kern.fullKernelization(false,0);
         if(cnf->use_heuristic_kernelization) kern.improveKernelizationUsingHeuristicRules();
         partition = kern.inCl;
+        saveKernelToCache(kern, kernel_variant);
     }
 
     createClusterGraph();
@@ -153,6 +180,7 @@ void Solver::run_recursive() {
 
         if (recurrence_depth < cnf->max_recursion_depth) {
             Solver solver(*origV, partition, *cnf, recurrence_depth + 1);
+            if( cnf->neg_threads > 1 ) solver.setNegPool( getNegPool() );
             solver.run_recursive();
 
             partition = solver.best_partition;
@@ -189,21 +217,17 @@ void Solver::run_recursive() {
 }
 
 NEG *Solver::createNegForState(State *st) {
-    if( cnf->use_neg_map_version ) return new NodeEdgeGreedy(*st);
+    NEG * neg = new NodeEdgeGreedy(*st, *st->ws);
+    if( cnf->neg_threads > 1 ) neg->pool = getNegPool();
+    return neg;
+}
 
-    NEG * neg;
-    bool W1 = true;
-    for( int i=0; i<N; i++ ){
-        if( clg.node_weights[i] != 1 ){
-            W1 = false;
-            break;
-        }
+ThreadPool *Solver::getNegPool() {
+    if( neg_pool == nullptr ){
+        neg_pool = new ThreadPool( cnf->neg_threads );
+        owns_neg_pool = true;
     }
-
-    if( W1 ) neg = new NodeEdgeGreedyW1(*st);
-    else neg = new NodeEdgeGreedyNomap(*st);
-
-    return neg;
+    return neg_pool;
 }
 
 
@@ -211,7 +235,10 @@ void Solver::run_fast() {
     if( Global::checkTle() ) return;
 //    if( recurrence_depth == max_rec_depth ) return; // original position here
 
-    if(recurrence_depth == 0 && cnf->use_kernelization){
+    const int kernel_variant = 1 + 2 * cnf->use_heuristic_kernelization + 4 * cnf->use_only_fast_exact_kernelization;
+    if(recurrence_depth == 0 && cnf->use_kernelization && loadKernelFromCache(kernel_variant)){
+        partition = PaceUtils::properlyRemapPartition(partition);
+    }else if(recurrence_depth == 0 && cnf->use_kernelization){
         CEKernelizer kern( *origV );
 
         if(cnf->use_only_fast_exact_kernelization){ // disable all rules except very fast rules
@@ -226,6 +253,7 @@ void Solver::run_fast() {
 
         assert( kern.inCl.size() == N );
         partition = kern.inCl;
+        saveKernelToCache(kern, kernel_variant);
 
         partition = PaceUtils::properlyRemapPartition(partition);
     }
@@ -333,6 +361,7 @@ void Solver::run_fast() {
 
     { // running recursively
         Solver solver(*origV, partition, *cnf, recurrence_depth + 1);
+        if( cnf->neg_threads > 1 ) solver.setNegPool( getNegPool() );
 
         solver.lower_level_best_partition_to_induce = best_partition;
 
@@ -514,33 +543,7 @@ void Solver::run_fast() {
 
 
 VPII Solver::getModifications() {
-    set<PII> mods;
-    VVI clusters = PaceUtils::partitionToClusters(best_partition);
-//    cout << "clusters: " << clusters << endl;
-
-    for( VI & v : clusters ){
-        for( int i=0; i<v.size(); i++ ){
-            for(int j=i+1; j<v.size(); j++){
-                mods.insert( { min(v[i],v[j]), max(v[i],v[j]) } );
-            }
-        }
-    }
-
-    VPII edges = GraphUtils::getGraphEdges(*origV);
-    for( auto & p : edges ) if(p.first > p.second) swap(p.first, p.second);
-
-    for( auto e : edges ){
-        int a = e.first, b = e.second;
-        if(a>b) swap(a,b);
-
-        if( best_partition[a] == best_partition[b] ) mods.erase(PII(a,b));
-        else mods.insert(PII(a,b));
-    }
-
-//    cout << "mods: " << mods << endl;
-//    cout << "best_partition: " << best_partition << endl;
-
-    return VPII(ALL(mods));
+    return PaceUtils::getModifications( *origV, best_partition );
 }
 
 pair<VI,VI> Solver::largeIteration(int iter_cnt) {
@@ -618,7 +621,7 @@ void Solver::granulateSolution() {
         VVI inPartition(N);
         for (int i = 0; i < N; i++) inPartition[partition[i]].push_back(i);
 
-        unordered_map<LL,VI> zb;
+        HashBuckets zb(N);
         for( int i=0; i<N; i++ ){
             LL hash = 0;
             for( int j=0; j<known_solutions.size(); j++ ){
@@ -626,14 +629,21 @@ void Solver::granulateSolution() {
                 LL position_hash = hashes2[j%N];
                 hash ^= ( cluster_hash + position_hash );
             }
-            zb[hash].push_back(i);
+            zb.set(i,hash);
         }
 
+        auto always_together = [&]( int a, int b ){ // verifying hash collisions
+            for( auto & sol : known_solutions ) if( sol[a] != sol[b] ) return false;
+            return true;
+        };
+
         FAU fau(N);
-        for( auto & [hash,vec] : zb ){
-//            if(debug) DEBUG(vec);
-            for( int i=1; i<vec.size(); i++ ){
-                fau.Union( vec[i], vec[0] );
+        for( auto & [hash,bucket] : zb.buckets ){
+            for( VI & vec : HashBuckets::split( bucket, always_together ) ){
+//                if(debug) DEBUG(vec);
+                for( int i=1; i<vec.size(); i++ ){
+                    fau.Union( vec[i], vec[0] );
+                }
             }
         }
 
@@ -777,8 +787,39 @@ pair<VI,VI> Solver::createPartitionsForGivenState(State &st) {
     return {part, part_clg};
 }
 
+unsigned long long Solver::getKernelCacheKey(int variant) {
+    return CSRGraph<int>(*origV).hash() * 1'000'003 + variant;
+}
+
+string Solver::getKernelCacheFile(int variant) {
+    return cnf->kernel_cache_file + "." + to_string(variant);
+}
+
+bool Solver::loadKernelFromCache(int variant) {
+    if( cnf->kernel_cache_file.empty() ) return false;
+
+    CSRGraph<int> kernel;
+    VI inCl;
+    unsigned long long key;
+    string file = getKernelCacheFile(variant);
+    if( !GraphReader::readGraphBinary( file, kernel, nullptr, &inCl, &key ) ) return false;
+    if( key != getKernelCacheKey(variant) || inCl.size() != N ) return false; // kernel of a different graph
+    for( int d : inCl ) if( d < 0 || d >= kernel.size() ) return false;
+
+    partition = inCl;
+    if(!Global::disable_all_logs) clog << "Kernel loaded from " << file << endl;
+    return true;
+}
+
+void Solver::saveKernelToCache(CEKernelizer &kern, int variant) {
+    if( cnf->kernel_cache_file.empty() ) return;
+    GraphWriter::writeGraphBinary( CSRGraph<int>(kern.V), getKernelCacheFile(variant), nullptr, &kern.inCl,
+                                   getKernelCacheKey(variant) );
+}
+
 void Solver::createClusterGraph() {
-    clg = ClusterGraph( &V, partition );
+    if( cnf->cluster_graph_threads > 1 && clg_pool == nullptr ) clg_pool = new ThreadPool( cnf->cluster_graph_threads );
+    clg = ClusterGraph( &V, partition, clg_pool );
 
     if(!Global::disable_all_logs) {
         clog << endl;
@@ -825,53 +866,36 @@ bool Solver::smallIteration(int iter_cnt, int nonneg_iter_cnt) {
 
     bool improved = false;
 
-    vector<SwapCandidate*> candidates;
-
-    vector<SwpCndNode> res_node, res_node_all;
-    vector<SwpCndEdge> res_edge, res_edge_all;
-    vector<SwpCndTriangle> res_triangle, res_triangle_all;
-    vector<SwpCndEO> res_eo, res_eo_all;
-    vector<SwpCndEORepulsion> res_eo_rep, res_eo_rep_all;
-    vector<SwpCndEOAttraction> res_eo_attr, res_eo_attr_all;
-
-    // CAUTION! If swp candidates store pointers to those orders from exp_ordres, they will be invalidated when the
-    // vector is reallocated. Thus, SwpCndEO cannot be stored
-    vector<ExpansionOrder*> exp_orders;
-
-    vector<ExpansionOrderAttraction*> attr_orders;
-    vector<ExpansionOrderRepulsion*> rep_orders;
-
-    auto createSwpCndEoForOrders = [&]( vector<ExpansionOrder> & orders,  SwpCndEOCreator & cr ){
-        int beg = exp_orders.size();
-        for( int j=0; j<orders.size(); j++ ){
-            exp_orders.push_back( new ExpansionOrder({-1}, nullptr) ); // adding empty order
-            swap(exp_orders.back()->ord, orders[j].ord);
-            exp_orders.back()->cl = orders[j].cl;
-        }
-
-        vector<SwpCndEO> res = cr.createSwapCandidates(exp_orders, beg, exp_orders.size() );
-
-        bool negative = false;
-        for( auto & cnd : res ){
-            res_eo.push_back(cnd);
-            if(cnd.swpVal() < 0) negative = true;
-        }
+    // creating pools here - creators may be run concurrently, so they cannot create them on their own
+    if( cnf->solver_creator_threads > 1 && creators_pool == nullptr ){
+        creators_pool = new ThreadPool( cnf->solver_creator_threads );
+    }
+    if( cnf->solver_eo_threads > 1 && eo_pool == nullptr ) eo_pool = new ThreadPool( cnf->solver_eo_threads );
 
-        return negative; // true if there was a negative swap candidate
-    };
+    vector<SwapCandidate*> candidates;
 
+    // candidates and orders are kept in [creator_results], they are all freed at once here
     auto clearOrdersAndCandidates = [&](){
-        for (auto ptr : attr_orders) delete ptr; for (auto ptr : rep_orders) delete ptr;
-        for (auto ptr : exp_orders) delete ptr;
-        exp_orders.clear(); attr_orders.clear(); rep_orders.clear();
-
-        vector<SwpCndNode>().swap(res_node);
-        vector<SwpCndEdge>().swap(res_edge);
-
-        res_node.clear(); res_edge.clear(); res_triangle.clear();
-        res_eo.clear(); res_eo_rep.clear(); res_eo_attr.clear();
+        for( int k=0; k<creator_results_used; k++ ) creator_results[k].clear();
+        creator_results_used = 0;
+        candidates.clear();
+    };
+    clearOrdersAndCandidates(); // previous call might have been interrupted, leaving some results
 
-        vector<SwapCandidate*>().swap(candidates);
+    /**
+     * Updates statistics of a single creator.
+     * Called only from this thread, so [local_search_creator_calls] need not be guarded.
+     */
+    auto mergeCreatorResults = [&]( SwpCndCreatorResults & r ){
+        if( r.name.empty() ) return; // unknown creator
+
+        local_search_creator_calls[r.name].first++;
+        if(r.negative){
+            local_search_creator_calls[r.name].second++;
+            if(!Global::disable_all_logs){
+                clog << " --> " << r.name << " negative swpval, time: " << Global::secondsFromStart() << endl;
+            }
+        }
     };
 
     for( int i=0; i<cnf->swpCndCreatorsToUse.size(); i++ ){
@@ -883,329 +907,129 @@ bool Solver::smallIteration(int iter_cnt, int nonneg_iter_cnt) {
 
         if(Global::checkTle()) return false;
 
-        switch( cnf->swpCndCreatorsToUse[i] ){
-            case edge_same_cl:{
-                Timer::start("SwpCndEdge_same_cl");
-                local_search_creator_calls["SwpCndEdge_same_cl"].first++;
-
-                SwpCndEdgeCreator cr(*st);
-                cr.keep_only_nonpositive_candidates = cnf->keep_only_nonpositive_candidates;
-                cr.keep_only_best_cluster_to_move_to = cnf->keep_only_best_cluster_to_move_to;
-                vector<SwpCndEdge> res;
-                for( auto & cl : st->clusters ){
-                    auto cnds = cr.create_MoveTo_SwapCandidatesForCluster(cl);
-                    for( auto & cnd : cnds ){
-                        res.push_back(cnd);
-                    }
-                }
-
-                bool negative = false;
-                for( auto & cnd : res ){
-                    res_edge.push_back(cnd);
-                    if(cnd.swpVal() < 0) negative = true;
-                }
-
-                if(negative) local_search_creator_calls["SwpCndEdge_same_cl"].second++;
-                Timer::stop("SwpCndEdge_same_cl");
-                break;
-            }
-            case edge_diff_cl:{
-                Timer::start( "SwpCndEdge_diff_cl" );
-                local_search_creator_calls["SwpCndEdge_diff_cl"].first++;
+        if( cnf->swpCndCreatorsToUse[i] == node ){
+            Timer::start("SwpCndNode");
+            local_search_creator_calls["SwpCndNode"].first++;
 
-                SwpCndEdgeCreator cr(*st);
-                cr.keep_only_nonpositive_candidates = cnf->keep_only_nonpositive_candidates;
-                cr.keep_only_best_cluster_to_move_to = cnf->keep_only_best_cluster_to_move_to;
-                bool only_common_neighbors = cnf->use_only_common_neighbors_in_swp_cnd_edge;
-                vector<SwpCndEdge> res = cr.create_MoveTo_SwapCandidates_DifferentClusters( only_common_neighbors );
-
-                bool negative = false;
-                for( auto & cnd : res ){
-                    res_edge.push_back(cnd);
-                    if(cnd.swpVal() < 0) negative = true;
-                }
 
-                if(negative) local_search_creator_calls["SwpCndEdge_diff_cl"].second++;
-                Timer::stop( "SwpCndEdge_diff_cl" );
-                break;
-            }
-            case edge_all:{
-                Timer::start( "SwpCndEdge_all" );
-                local_search_creator_calls["SwpCndEdge_all"].first++;
+            const bool USE_NEG = true;
 
-                SwpCndEdgeCreator cr(*st);
-                cr.keep_only_nonpositive_candidates = cnf->keep_only_nonpositive_candidates;
-                cr.keep_only_best_cluster_to_move_to = cnf->keep_only_best_cluster_to_move_to;
-                bool only_common_neighbors = cnf->use_only_common_neighbors_in_swp_cnd_edge;
-                vector<SwpCndEdge> res = cr.create_MoveTo_SwapCandidates_DifferentClusters( only_common_neighbors );
-                for( auto & cl : st->clusters ){
-                    auto cnds = cr.create_MoveTo_SwapCandidatesForCluster(cl);
-                    for( auto & cnd : cnds ){
-                        res.push_back(cnd);
-                    }
-                }
+            if (USE_NEG) {
+                if (!Global::disable_all_logs)
+                    clog << "Before NEG, result: " << PaceUtils::evaluateState(*st) << endl;
 
-                bool negative = false;
-                for( auto & cnd : res ){
-                    res_edge.push_back(cnd);
-                    if(cnd.swpVal() < 0) negative = true;
-                }
-
-                if(negative) local_search_creator_calls["SwpCndEdge_all"].second++;
-                Timer::stop( "SwpCndEdge_all" );
-                break;
-            }
-            case triangle:{
-                Timer::start( "SwpCndTriangle" );
-                local_search_creator_calls["SwpCndTriangle"].first++;
-
-                SwpCndTriangleCreator cr(*st);
-                cr.keep_only_nonpositive_candidates = cnf->keep_only_nonpositive_candidates;
-                cr.keep_only_best_cluster_to_move_to = cnf->keep_only_best_cluster_to_move_to;
-                bool only_empty_cluster = cnf->use_only_empty_cluster_in_swp_cnd_triangle;
-                vector<SwpCndTriangle> res = cr.create_MoveTo_SwapCandidates( only_empty_cluster );
-
-                bool negative = false;
-                for( auto & cnd : res ){
-                    res_triangle.push_back(cnd);
-                    if(cnd.swpVal() < 0) negative = true;
-                }
+                NEG *neg = createNegForState(st);
+                neg->setConfigurations(*cnf);
 
-                if(negative){
-                    local_search_creator_calls["SwpCndTriangle"].second++;
-                    if(!Global::disable_all_logs) clog << "smallIteration triangle negative swpval" << endl;
+                int before;
+                if (!Global::CONTEST_MODE) {
+                    assert(PaceUtils::evaluateState(*st) == neg->best_result);
+                    before = neg->best_result;
                 }
-                Timer::stop( "SwpCndTriangle" );
-                break;
-            }
-            case node: {
-                Timer::start("SwpCndNode");
-                local_search_creator_calls["SwpCndNode"].first++;
-
-
-                const bool USE_NEG = true;
-
-                if (USE_NEG) {
-                    if (!Global::disable_all_logs)
-                        clog << "Before NEG, result: " << PaceUtils::evaluateState(*st) << endl;
 
-                    NEG *neg = createNegForState(st);
-                    neg->setConfigurations(*cnf);
-
-                    int before;
-                    if (!Global::CONTEST_MODE) {
-                        assert(PaceUtils::evaluateState(*st) == neg->best_result);
-                        before = neg->best_result;
-                    }
-
-                    neg->move_frequency = cnf->neg_move_frequency;
-
-                    if (!Global::disable_all_logs)
-                        clog << "  Before neg.improve(), result: " << neg->best_result << endl;
-
-                    neg->improve();
-                    delete st;
-                    st = new State(clg, SINGLE_NODES);
-                    VVI to_merge = StandardUtils::partitionToLayers(neg->best_partition);
-                    st->mergeClusters(to_merge);
-                    partition = PaceUtils::mapClgPartitionToOriginalPartition(clg,
-                                                                              st->inCl); // #TEST - uncommented seems to work ok
+                neg->move_frequency = cnf->neg_move_frequency;
 
-                    if (!Global::disable_all_logs) clog << "  After SwpCndNode, result: " << neg->best_result << endl;
+                if (!Global::disable_all_logs)
+                    clog << "  Before neg.improve(), result: " << neg->best_result << endl;
 
-                    if(Global::checkTle()){
-                        delete neg;
-                        return false;
-                    }
-
-                    if (!Global::CONTEST_MODE) {
-                        assert(PaceUtils::evaluateState(*st) == neg->best_result);
-                        int after = neg->best_result;
-                        if (after < before) improved = true; // #TEST #TEST - originally this was not here
+                neg->improve();
+                delete st;
+                st = new State(clg, SINGLE_NODES);
+                VVI to_merge = StandardUtils::partitionToLayers(neg->best_partition);
+                st->mergeClusters(to_merge);
+                partition = PaceUtils::mapClgPartitionToOriginalPartition(clg,
+                                                                          st->inCl); // #TEST - uncommented seems to work ok
 
-                        {
-                            VI temp_part = PaceUtils::mapClgPartitionToOriginalPartition(clg, neg->best_partition);
-                            assert(neg->best_result == PaceUtils::evaluateSolution(*origV, temp_part));
-                        }
-                    }
+                if (!Global::disable_all_logs) clog << "  After SwpCndNode, result: " << neg->best_result << endl;
 
+                if(Global::checkTle()){
                     delete neg;
-
-                    local_search_creator_calls["SwpCndNode"].second++;
-                } else {
-                    SwpCndNodeCreator cr(*st);
-                    cr.keep_only_nonpositive_candidates = cnf->keep_only_nonpositive_candidates;
-                    cr.keep_only_best_cluster_to_move_to = cnf->keep_only_best_cluster_to_move_to;
-                    auto res = cr.createSwapCandidates();
-
-                    bool negative = false;
-                    for (auto &cnd : res) {
-                        res_node.push_back(cnd);
-                        if (cnd.swpVal() < 0) negative = true;
-                    }
-                    if (negative) local_search_creator_calls["SwpCndNode"].second++;
-                }
-
-                Timer::stop("SwpCndNode");
-                break;
-            }
-            case exp_ord:{
-                Timer::start( "SwpCndEO" );
-                local_search_creator_calls["SwpCndEO"].first++;
-
-                SwpCndEOCreator cr(*st);
-                cr.keep_only_best_cluster_to_move_to = cnf->keep_only_best_cluster_to_move_to;
-
-                auto orders = cr.createExpansionOrders( cnf->expansionOrderInitialSetProvider );
-                if( Global::checkTle() ) return false;
-
-                bool negative = createSwpCndEoForOrders(orders,cr);
-                if( Global::checkTle() ) return false;
-
-                if(negative){
-                    local_search_creator_calls["SwpCndEO"].second++;
-                    if(!Global::disable_all_logs){
-                        clog << " --> expOrd negative swpval, time: " << Global::secondsFromStart() << endl;
-                    }
-                }
-                Timer::stop( "SwpCndEO" );
-                break;
-            }
-            case exp_ord_rep:{
-                Timer::start( "SwpCndEORep" );
-                local_search_creator_calls["SwpCndEORep"].first++;
-
-                ComponentExpansionRepulsion cr(*st);
-                cr.min_cluster_size = cnf->min_cluster_size_for_eo_rep;
-                cr.keep_only_nonpositive_candidates = cnf->keep_only_nonpositive_candidates; // #TEST - commented to allow more induced orders
-
-                auto [orders, res] = cr.createSwapCandidates();
-                rep_orders += orders;
-                if( Global::checkTle() ){
-                    clearOrdersAndCandidates();
                     return false;
                 }
 
-                bool negative = false;
-                for( auto & cnd : res ){
-                    if( cr.keep_only_nonpositive_candidates ) assert( cnd.swpVal() <= 0 );
+                if (!Global::CONTEST_MODE) {
+                    assert(PaceUtils::evaluateState(*st) == neg->best_result);
+                    int after = neg->best_result;
+                    if (after < before) improved = true; // #TEST #TEST - originally this was not here
 
-                    res_eo_rep.push_back(cnd);
-                    if(cnd.swpVal() < 0){
-                        negative = true;
-//                        clog << "Negative SwpCndEORep for cl.size(): " << cnd.eo->cl->size() << ", k: " << cnd.k << endl;
+                    {
+                        VI temp_part = PaceUtils::mapClgPartitionToOriginalPartition(clg, neg->best_partition);
+                        assert(neg->best_result == PaceUtils::evaluateSolution(*origV, temp_part));
                     }
                 }
 
-                if(!negative){ // inducing orders
-                    vector<ExpansionOrder> induced_orders;
-                    for( auto * o : orders ){
-                        induced_orders += ExpansionOrderRepulsion::induceOrders(*st, *o);
-                    }
-
-                    SwpCndEOCreator cr(*st);
-                    bool t = createSwpCndEoForOrders(induced_orders, cr);
-                    if(t){
-//                        if(!Global::disable_all_logs) clog << "   Induced order from SwpCndRep has negative swap value with current negative: "
-//                                                           << negative << endl;
-                        negative = t;
-                    }
-                }
+                delete neg;
 
-                if( Global::checkTle() ){
-                    clearOrdersAndCandidates();
-                    return false;
-                }
+                local_search_creator_calls["SwpCndNode"].second++;
+            } else {
+                SwpCndNodeCreator cr(*st);
+                cr.keep_only_nonpositive_candidates = cnf->keep_only_nonpositive_candidates;
+                cr.keep_only_best_cluster_to_move_to = cnf->keep_only_best_cluster_to_move_to;
+                auto res = cr.createSwapCandidates();
 
-                if(negative){
-                    local_search_creator_calls["SwpCndEORep"].second++;
-                    if(!Global::disable_all_logs){
-                        clog << " --> expOrdRep negative swpval, time: " << Global::secondsFromStart() << endl;
-                    }
+                auto & res_node = nextCreatorResults().res_node;
+                bool negative = false;
+                for (auto &cnd : res) {
+                    res_node.push_back(cnd);
+                    if (cnd.swpVal() < 0) negative = true;
                 }
-                Timer::stop( "SwpCndEORep" );
-                break;
+                if (negative) local_search_creator_calls["SwpCndNode"].second++;
             }
-            case exp_ord_attr:{
-                Timer::start( "SwpCndEOAttr" );
-                local_search_creator_calls["SwpCndEOAttr"].first++;
-
-                ComponentExpansionAttraction cr(*st);
-                cr.min_cluster_size = cnf->min_cluster_size_for_eo_attr;
-                cr.keep_only_nonpositive_candidates = cnf->keep_only_nonpositive_candidates;  // #TEST - commented to allow more induced orders
-
-                auto [orders, res] = cr.createSwapCandidates();
-                attr_orders += orders;
-                if( Global::checkTle() ){
-                    clearOrdersAndCandidates();
-                    return false; // not clearing rep_orders, possible memory leak
-                }
 
-                bool negative = false;
-                for( auto & cnd : res ){
-                    if( cr.keep_only_nonpositive_candidates ) assert( cnd.swpVal() <= 0 );
-
-                    res_eo_attr.push_back(cnd);
-                    if(cnd.swpVal() < 0){
-                        negative = true;
-//                        clog << "Negative SwpCndEOAttr for cl.size(): " << cnd.eo->cl->size() << ", k: " << cnd.k << endl;
-                    }
-                }
+            Timer::stop("SwpCndNode");
+        }
+        else{
+            // creators from range [i,j) are run together. They do not modify the state, so they can run concurrently
+            int j = i+1;
+            if( cnf->solver_creator_threads > 1 ){
+                while( j < cnf->swpCndCreatorsToUse.size() && cnf->swpCndCreatorsToUse[j] != node ) j++;
+            }
 
-                if(!negative){ // inducing orders
-                    vector<ExpansionOrder> induced_orders;
-                    for( auto * o : orders ){
-                        induced_orders += ExpansionOrderAttraction::induceOrders(*st, *o);
-                    }
+            vector<SwpCndCreatorResults*> results(j-i);
+            for( auto & r : results ) r = &nextCreatorResults();
+            vector<char> finished_in_time(j-i, true);
 
-                    SwpCndEOCreator cr(*st);
-                    bool t = createSwpCndEoForOrders(induced_orders, cr);
-                    if(t){
-                        if(!Global::disable_all_logs){
-//                            clog << "   Induced order from SwpCndAttr has negative swap value with current negative: "
-//                                 << negative << endl;
-                        }
-                        negative = t;
-                    }
-                }
+            if( j-i == 1 ) finished_in_time[0] = runSwpCndCreator( cnf->swpCndCreatorsToUse[i], *results[0] );
+            else{
+                // creating it here, otherwise many creators would try to create it at the same time
+                if( st->cl_neigh_graph.empty() ) st->createClNeighGraph();
+
+                // seeds are drawn here - worker threads would otherwise use the same seeds in each smallIteration
+                VI seeds(j-i);
+                UniformIntGenerator rnd( 0, 1'000'000'000 );
+                for( int k=0; k<j-i; k++ ) seeds[k] = rnd.rand();
+
+                creators_pool->parallelFor( j-i, [&]( int k ){
+                    UniformIntGenerator::lastSeed = seeds[k];
+                    finished_in_time[k] = runSwpCndCreator( cnf->swpCndCreatorsToUse[i+k], *results[k] );
+                } );
+            }
 
-                if( Global::checkTle() ){
-                    clearOrdersAndCandidates();
-                    return false; // not clearing rep_orders, possible memory leak
-                }
+            for( auto * r : results ) mergeCreatorResults(*r);
 
-                if(negative){
-                    local_search_creator_calls["SwpCndEOAttr"].second++;
-                    if(!Global::disable_all_logs){
-                        clog << " --> expOrdAttr negative swpval, time: " << Global::secondsFromStart() << endl;
-                    }
-                }
-                Timer::stop( "SwpCndEOAttr" );
-                break;
-            }
-            default:{
-                clog << "No default swap candidate creator mode" << endl;
+            if( count( ALL(finished_in_time), false ) > 0 ){
+                clearOrdersAndCandidates();
+                return false;
             }
-        }
 
-        vector<SwapCandidate*>().swap(candidates);
+            i = j-1;
+        }
 
-        for( auto & cnd : res_node ) candidates.push_back(&cnd);
-        for( auto & cnd : res_edge ) candidates.push_back(&cnd);
-        for( auto & cnd : res_triangle ) candidates.push_back(&cnd);
-        for( auto & cnd : res_eo ) candidates.push_back(&cnd);
-        for( auto & cnd : res_eo_rep ) candidates.push_back(&cnd);
-        for( auto & cnd : res_eo_attr ) candidates.push_back(&cnd);
+        candidates.clear();
+        for( int k=0; k<creator_results_used; k++ ) creator_results[k].collectCandidates(candidates);
 
         if(debug){
             DEBUG(*st);
 
-            if( !res_node.empty() ) DEBUG(res_node);
-            if( !res_edge.empty() ) DEBUG(res_edge);
-            if( !res_triangle.empty() ) DEBUG(res_triangle);
-            if( !res_eo.empty() ) DEBUG(res_eo);
-            if( !res_eo_attr.empty() ) DEBUG(res_eo_attr);
-            if( !res_eo_rep.empty() ) DEBUG(res_eo_rep);
+            for( int k=0; k<creator_results_used; k++ ){
+                auto & r = creator_results[k];
+                if( !r.res_node.empty() ) DEBUG(r.res_node);
+                if( !r.res_edge.empty() ) DEBUG(r.res_edge);
+                if( !r.res_triangle.empty() ) DEBUG(r.res_triangle);
+                if( !r.res_eo.empty() ) DEBUG(r.res_eo);
+                if( !r.res_eo_attr.empty() ) DEBUG(r.res_eo_attr);
+                if( !r.res_eo_rep.empty() ) DEBUG(r.res_eo_rep);
+            }
 
             if(!candidates.empty()){
                 clog << "candidates: " << endl;
@@ -1270,16 +1094,177 @@ bool Solver::smallIteration(int iter_cnt, int nonneg_iter_cnt) {
 
     perturbState(nonneg_iter_cnt);
 
-    { // clearing pointers to avoid memory leak
-//        for (auto ptr : exp_orders) delete ptr;
-//        for (auto ptr : attr_orders) delete ptr;
-//        for (auto ptr : rep_orders) delete ptr;
-        clearOrdersAndCandidates();
-    }
+    clearOrdersAndCandidates(); // freeing all candidates and orders at once
 
     return improved;
 }
 
+bool Solver::runSwpCndCreator(SwpCndCrId cr_id, SwpCndCreatorResults &res) {
+    using Timer = TimeMeasurer;
+
+    switch( cr_id ){
+        case edge_same_cl: res.name = "SwpCndEdge_same_cl"; break;
+        case edge_diff_cl: res.name = "SwpCndEdge_diff_cl"; break;
+        case edge_all: res.name = "SwpCndEdge_all"; break;
+        case triangle: res.name = "SwpCndTriangle"; break;
+        case exp_ord: res.name = "SwpCndEO"; break;
+        case exp_ord_rep: res.name = "SwpCndEORep"; break;
+        case exp_ord_attr: res.name = "SwpCndEOAttr"; break;
+        default:{
+            clog << "No default swap candidate creator mode" << endl;
+            return true;
+        }
+    }
+
+    auto addCandidates = [&]( auto & cnds, auto & dst ){
+        for( auto & cnd : cnds ){
+            dst.push_back(cnd);
+            if(cnd.swpVal() < 0) res.negative = true;
+        }
+    };
+
+    // CAUTION! Orders are allocated on the heap - candidates keep pointers to them, so they cannot be kept in a vector
+    // that may be reallocated
+    auto createSwpCndEoForOrders = [&]( vector<ExpansionOrder> & orders,  SwpCndEOCreator & cr ){
+        int beg = res.exp_orders.size();
+        for( int j=0; j<orders.size(); j++ ){
+            res.exp_orders.push_back( res.exp_orders_arena.create( VI(), orders[j].cl ) ); // adding empty order
+            swap(res.exp_orders.back()->ord, orders[j].ord);
+        }
+
+        vector<SwpCndEO> cnds = cr.createSwapCandidates(res.exp_orders, beg, res.exp_orders.size() );
+        addCandidates( cnds, res.res_eo );
+    };
+
+    Timer::start(res.name);
+    bool tle = false;
+
+    switch( cr_id ){
+        case edge_same_cl:
+        case edge_diff_cl:
+        case edge_all:{
+            SwpCndEdgeCreator cr(*st);
+            cr.keep_only_nonpositive_candidates = cnf->keep_only_nonpositive_candidates;
+            cr.keep_only_best_cluster_to_move_to = cnf->keep_only_best_cluster_to_move_to;
+
+            vector<SwpCndEdge> cnds;
+            if( cr_id != edge_same_cl ){
+                bool only_common_neighbors = cnf->use_only_common_neighbors_in_swp_cnd_edge;
+                cnds = cr.create_MoveTo_SwapCandidates_DifferentClusters( only_common_neighbors );
+            }
+            if( cr_id != edge_diff_cl ){
+                for( auto & cl : st->clusters ) cnds += cr.create_MoveTo_SwapCandidatesForCluster(cl);
+            }
+
+            addCandidates( cnds, res.res_edge );
+            break;
+        }
+        case triangle:{
+            SwpCndTriangleCreator cr(*st);
+            cr.keep_only_nonpositive_candidates = cnf->keep_only_nonpositive_candidates;
+            cr.keep_only_best_cluster_to_move_to = cnf->keep_only_best_cluster_to_move_to;
+            bool only_empty_cluster = cnf->use_only_empty_cluster_in_swp_cnd_triangle;
+            vector<SwpCndTriangle> cnds = cr.create_MoveTo_SwapCandidates( only_empty_cluster );
+
+            addCandidates( cnds, res.res_triangle );
+            break;
+        }
+        case exp_ord:{
+            SwpCndEOCreator cr(*st);
+            cr.keep_only_best_cluster_to_move_to = cnf->keep_only_best_cluster_to_move_to;
+            cr.pool = eo_pool;
+
+            auto orders = cr.createExpansionOrders( cnf->expansionOrderInitialSetProvider );
+            if( Global::checkTle() ){ tle = true; break; }
+
+            createSwpCndEoForOrders(orders,cr);
+            if( Global::checkTle() ) tle = true;
+            break;
+        }
+        case exp_ord_rep:{
+            ComponentExpansionRepulsion cr(*st);
+            cr.arena = &res.rep_orders;
+            cr.min_cluster_size = cnf->min_cluster_size_for_eo_rep;
+            cr.keep_only_nonpositive_candidates = cnf->keep_only_nonpositive_candidates; // #TEST - commented to allow more induced orders
+
+            auto [orders, cnds] = cr.createSwapCandidates();
+            if( Global::checkTle() ){ tle = true; break; }
+
+            if( cr.keep_only_nonpositive_candidates ) for( auto & cnd : cnds ) assert( cnd.swpVal() <= 0 );
+            addCandidates( cnds, res.res_eo_rep );
+
+            if(!res.negative){ // inducing orders
+                vector<ExpansionOrder> induced_orders;
+                for( auto * o : orders ){
+                    induced_orders += ExpansionOrderRepulsion::induceOrders(*st, *o);
+                }
+
+                SwpCndEOCreator eo_cr(*st);
+                createSwpCndEoForOrders(induced_orders, eo_cr);
+            }
+
+            if( Global::checkTle() ) tle = true;
+            break;
+        }
+        case exp_ord_attr:{
+            ComponentExpansionAttraction cr(*st);
+            cr.arena = &res.attr_orders;
+            cr.min_cluster_size = cnf->min_cluster_size_for_eo_attr;
+            cr.keep_only_nonpositive_candidates = cnf->keep_only_nonpositive_candidates;  // #TEST - commented to allow more induced orders
+
+            auto [orders, cnds] = cr.createSwapCandidates();
+            if( Global::checkTle() ){ tle = true; break; }
+
+            if( cr.keep_only_nonpositive_candidates ) for( auto & cnd : cnds ) assert( cnd.swpVal() <= 0 );
+            addCandidates( cnds, res.res_eo_attr );
+
+            if(!res.negative){ // inducing orders
+                vector<ExpansionOrder> induced_orders;
+                for( auto * o : orders ){
+                    induced_orders += ExpansionOrderAttraction::induceOrders(*st, *o);
+                }
+
+                SwpCndEOCreator eo_cr(*st);
+                createSwpCndEoForOrders(induced_orders, eo_cr);
+            }
+
+            if( Global::checkTle() ) tle = true;
+            break;
+        }
+        default: break;
+    }
+
+    Timer::stop(res.name);
+    return !tle;
+}
+
+Solver::SwpCndCreatorResults &Solver::nextCreatorResults() {
+    if( creator_results_used == creator_results.size() ) creator_results.emplace_back();
+    return creator_results[ creator_results_used++ ];
+}
+
+void Solver::SwpCndCreatorResults::collectCandidates(vector<SwapCandidate *> &candidates) {
+    for( auto & cnd : res_node ) candidates.push_back(&cnd);
+    for( auto & cnd : res_edge ) candidates.push_back(&cnd);
+    for( auto & cnd : res_triangle ) candidates.push_back(&cnd);
+    for( auto & cnd : res_eo ) candidates.push_back(&cnd);
+    for( auto & cnd : res_eo_rep ) candidates.push_back(&cnd);
+    for( auto & cnd : res_eo_attr ) candidates.push_back(&cnd);
+}
+
+void Solver::SwpCndCreatorResults::clear() {
+    name.clear();
+    negative = false;
+
+    res_node.clear(); res_edge.clear(); res_triangle.clear();
+    res_eo.clear(); res_eo_rep.clear(); res_eo_attr.clear();
+
+    exp_orders.clear();
+    exp_orders_arena.clear();
+    attr_orders.clear();
+    rep_orders.clear();
+}
+
 void Solver::perturbState(int nonneg_iter_cnt) {
     return;
 }
@@ -1294,10 +1279,7 @@ bool Solver::apply_swap_for_candidates(vector<SwapCandidate *> &candidates) {
     std::mt19937_64 drng; // do we need to seed at all? may do not make any shuffle??
 
     StandardUtils::shuffle(candidates, drng);
-    sort(ALL(candidates), []( SwapCandidate* a, SwapCandidate* b ){
-        // sorting candidates by their swap value
-        return a->swpVal() < b->swpVal(); // old sorting
-    });
+    sortCandidatesBySwpVal(candidates);
 
     if(debug){
         clog << "Candidates sorted: " << endl;
@@ -1307,18 +1289,30 @@ bool Solver::apply_swap_for_candidates(vector<SwapCandidate *> &candidates) {
     }
 
     if( cnf->swap_application_mode == GREEDY_MAXIMAL_DISJOINT ){
-        VB affected_clusters( 2 * st->N,false );
-        VPII to_swap;
+        const int empty_id = st->getIdOfEmptyCluster();
 
-        int first_empty_for_all_cnds = st->getIdOfEmptyCluster();
+        if( cl_stamp.size() < 2 * st->N ){
+            cl_stamp = new_cl_stamp = new_cl_id = VI( 2 * st->N, 0 );
+            cl_epoch = new_cl_epoch = 0;
+        }
+        cl_epoch++; // clearing affected clusters
+
+        VPII & to_swap = to_swap_buffer;
+        to_swap.clear();
+
+        int first_empty_for_all_cnds = empty_id;
 
         for( auto * cnd : candidates ){
             if(cnd->swpVal() < 0) improved = true;
 
-            VI affected = cnd->getAffectedClusters(*st);
+            // affected clusters are clusters of moved nodes and target clusters
+            int swap_size = cnd->swapSize();
             bool can = true;
-            for( int c : affected ){
-                if( c < st->getIdOfEmptyCluster() && affected_clusters[c] ){ can = false; break; }
+            for( int i=0; i<swap_size && can; i++ ){
+                auto [v,c] = cnd->swapAt(i);
+                int cv = st->inCl[v];
+                if( cv < empty_id && cl_stamp[cv] == cl_epoch ) can = false;
+                if( c < empty_id && cl_stamp[c] == cl_epoch ) can = false;
             }
 
             const bool APPLY_ALL_SWAPS_REGARDLESS_OF_SAME_CLUSTERS = false; // should be false
@@ -1329,30 +1323,24 @@ bool Solver::apply_swap_for_candidates(vector<SwapCandidate *> &candidates) {
                     clog << "Adding candidate " << cnd->getNodesToSwap() << " with swpval: "
                          << cnd->swpVal() << " to apply swap" << endl;
                 }
-                for( int c : affected ) affected_clusters[c] = true;
-
-                auto nodes_to_swap = cnd->getNodesToSwap();
-
-                unordered_map<int,int> empty_cl_mapper;
-                unordered_map<int,int> marker;
-                int first_empty = first_empty_for_all_cnds;
-                for( PII & p : nodes_to_swap ){
-                    if( p.second < st->getIdOfEmptyCluster() ) marker[p.first] = p.second;
-                    else{
-                        auto it = empty_cl_mapper.find( p.second );
-                        if( it == empty_cl_mapper.end() ){ // cluster p.second is NOT present - creating it
-                            empty_cl_mapper[p.second] = first_empty;
-                            marker[p.first] = first_empty;
-                            first_empty++;
-                        }else{ // cluster p.second is PRESENT, with id empty_cl_mapper[p.second]
-                            marker[p.first] = empty_cl_mapper[p.second];
+
+                new_cl_epoch++; // each candidate creates its own new clusters
+                for( int i=0; i<swap_size; i++ ){
+                    auto [v,c] = cnd->swapAt(i);
+                    cl_stamp[ st->inCl[v] ] = cl_epoch;
+                    cl_stamp[c] = cl_epoch;
+
+                    int trg = c;
+                    if( c >= empty_id ){
+                        if( new_cl_stamp[c] != new_cl_epoch ){ // cluster c is NOT present - creating it
+                            new_cl_stamp[c] = new_cl_epoch;
+                            new_cl_id[c] = first_empty_for_all_cnds++;
                         }
+                        trg = new_cl_id[c];
                     }
 
-                    to_swap.push_back( {p.first, marker[p.first]} );
+                    to_swap.emplace_back( v, trg );
                 }
-
-                first_empty_for_all_cnds = first_empty;
             }
         }
 
@@ -1363,7 +1351,9 @@ bool Solver::apply_swap_for_candidates(vector<SwapCandidate *> &candidates) {
         SwapCandidate * cnd = candidates[0];
         if( cnd->swpVal() <= 0 ){
             if( cnd->swpVal() < 0 ) improved = true;
-            auto to_swap = cnd->getNodesToSwap();
+            VPII & to_swap = to_swap_buffer;
+            to_swap.resize( cnd->swapSize() );
+            for( int i=0; i<to_swap.size(); i++ ) to_swap[i] = cnd->swapAt(i);
             st->applySwap( to_swap );
         }
     }else{
@@ -1378,6 +1368,44 @@ bool Solver::apply_swap_for_candidates(vector<SwapCandidate *> &candidates) {
     return improved;
 }
 
+void Solver::sortCandidatesBySwpVal(vector<SwapCandidate *> &candidates) {
+    int n = candidates.size();
+    if( n <= 1 ) return;
+
+    sort_keys.resize(n);
+    LL mn = numeric_limits<LL>::max(), mx = numeric_limits<LL>::min();
+    for( int i=0; i<n; i++ ){
+        sort_keys[i] = candidates[i]->swpVal();
+        mn = min(mn, sort_keys[i]);
+        mx = max(mx, sort_keys[i]);
+    }
+
+    if( mx - mn > UINT_MAX ){ // should never happen, swap values are ints
+        VI order(n);
+        iota( ALL(order), 0 );
+        stable_sort( ALL(order), [&]( int a, int b ){ return sort_keys[a] < sort_keys[b]; } );
+        vector<SwapCandidate*> sorted(n);
+        for( int i=0; i<n; i++ ) sorted[i] = candidates[ order[i] ];
+        candidates.swap(sorted);
+        return;
+    }
+
+    sort_items.resize(n);
+    sort_items_tmp.resize(n);
+    for( int i=0; i<n; i++ ) sort_items[i] = { (unsigned)( sort_keys[i] - mn ), candidates[i] };
+
+    unsigned range = mx - mn;
+    for( int shift = 0; shift < 32 && (range >> shift) > 0; shift += 8 ){
+        int cnt[257] = {0};
+        for( auto & p : sort_items ) cnt[ ((p.first >> shift) & 255) + 1 ]++;
+        for( int i=0; i<256; i++ ) cnt[i+1] += cnt[i];
+        for( auto & p : sort_items ) sort_items_tmp[ cnt[ (p.first >> shift) & 255 ]++ ] = p;
+        swap( sort_items, sort_items_tmp );
+    }
+
+    for( int i=0; i<n; i++ ) candidates[i] = sort_items[i].second;
+}
+
 
 pair<VI,VI> Solver::localSearch(int iter_cnt) {
     if(Global::checkTle()) return createPartitionsForGivenState(*st);
@@ -1534,6 +1562,7 @@ void Solver::createKnownSolutionsUsingRunFast() {
 
         { // running run_fast()
             Solver solver(V, partition, *cnf, 0);
+            if( cnf->neg_threads > 1 ) solver.setNegPool( getNegPool() );
             solver.run_fast();
 
             compareToBestSolutionAndUpdate(solver.best_partition);
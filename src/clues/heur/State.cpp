@@ -11,9 +11,10 @@
 #include "CollectionOperators.h"
 #include "clues/heur/State.h"
 
-State::State(ClusterGraph &clg, StateInitializationType init_type) {
+State::State(ClusterGraph &clg, StateInitializationType init_type, Workspace & ws) {
     this->clg = &clg;
     this->N = clg.N;
+    this->ws = &ws;
     initializeStateData(init_type);
     createClNeighGraph();
 
@@ -27,27 +28,27 @@ State::State(ClusterGraph &clg, StateInitializationType init_type) {
 
 void State::clearState(){
     fill(ALL(inCl), -1); fill(ALL(degInCl),0); fill(ALL(idInCl),-1);
-    fill(ALL(was),false); fill(ALL(was2),false); fill(ALL(was2),false);
-    fill(ALL(marker),0);
-//    for( int i=0; i<N; i++ ) VI().swap(marker2[i]);
+    ws->reserve(N,true);
     clusters.clear(); cl_neigh_graph.clear();
 }
 
 
 void State::applySwap( VPII & to_swap ) {
-    for( auto & cl : clusters ){
-        for( int d : cl.g.nodes ) marker[d] = cl.id;
-    }
+    const int old_empty = getIdOfEmptyCluster();
+    int first_empty = old_empty;
+
+    VI & new_cl = ws->marker; // new_cl[v] is the id of the cluster to which node v is moved
+    VB & moved = ws->was;
+    VI moved_nodes;
 
     /**
      * If i >= getIdOfEmptyCluster() then empty_cl_mapper[i] is the id of the newly created cluster
      * empty_cl_mapper[i] is the i
      */
-    unordered_map<int,int> empty_cl_mapper;
-    int first_empty = getIdOfEmptyCluster();
+    unordered_map<int,int> & empty_cl_mapper = ws->int_map;
     for( PII & p : to_swap ){
-        if( p.second < getIdOfEmptyCluster() ) marker[p.first] = p.second;
-        else{
+        int trg = p.second;
+        if( trg >= old_empty ){
             auto it = empty_cl_mapper.find( p.second );
             if( it == empty_cl_mapper.end() ){ // cluster p.second is NOT present - creating it
                 if( first_empty == N ){
@@ -61,40 +62,132 @@ void State::applySwap( VPII & to_swap ) {
                     continue;
                 }
                 empty_cl_mapper[p.second] = first_empty;
-                marker[p.first] = first_empty;
-                first_empty++;
-            }else{ // cluster p.second is PRESENT, with id empty_cl_mapper[p.second]
-                marker[p.first] = empty_cl_mapper[p.second];
+                trg = first_empty++;
+            }else trg = it->second; // cluster p.second is PRESENT, with id empty_cl_mapper[p.second]
+        }
+
+        if( !moved[p.first] ){
+            moved[p.first] = true;
+            moved_nodes.push_back(p.first);
+        }
+        new_cl[p.first] = trg;
+    }
+    empty_cl_mapper.clear();
+
+    { // removing nodes that stay in their clusters
+        int cnt = 0;
+        for( int v : moved_nodes ){
+            if( new_cl[v] == inCl[v] ) moved[v] = false;
+            else moved_nodes[cnt++] = v;
+        }
+        moved_nodes.resize(cnt);
+    }
+
+    // clusters from which nodes are moved and to which nodes are moved. Only those clusters are rebuilt
+    VB & is_affected = ws->was2;
+    VI affected;
+    for( int v : moved_nodes ){
+        for( int c : { inCl[v], new_cl[v] } ){
+            if( !is_affected[c] ){
+                is_affected[c] = true;
+                affected.push_back(c);
+            }
+        }
+    }
+
+    VVI new_nodes( affected.size() );
+    {
+        unordered_map<int,int> & index_in_affected = ws->int_map;
+        for( int i=0; i<affected.size(); i++ ){
+            int c = affected[i];
+            index_in_affected[c] = i;
+            if( c < old_empty ) for( int d : clusters[c].g.nodes ) if( !moved[d] ) new_nodes[i].push_back(d);
+        }
+        for( int v : moved_nodes ) new_nodes[ index_in_affected[ new_cl[v] ] ].push_back(v);
+        index_in_affected.clear();
+    }
+
+    if( !cl_neigh_graph.empty() ){
+        // Nodes are moved one by one. Entries of neighbors of a moved node change only for its old and new cluster
+        for( int v : moved_nodes ){
+            int a = inCl[v], b = new_cl[v];
+            inCl[v] = b;
+            for( auto & [u,w] : clg->V[v] ){
+                if( inCl[u] != a ) updateClNeighGraphEntry( u, a, -w );
+                if( inCl[u] != b ) updateClNeighGraphEntry( u, b, w );
             }
+            updateClNeighGraphForNode(v);
         }
     }
 
-    VI first_occurrence(N,-1); // the first node that is to be in cluster i is at position first_occurence[i]
+    clusters.pop_back(); // removing empty cluster, it will be added at the end
+    clusters.resize( first_empty ); // making place for new clusters
 
+    for( int i=0; i<affected.size(); i++ ){
+        int c = affected[i];
+        sort( ALL(new_nodes[i]) );
+        clusters[c] = Cluster( *clg, new_nodes[i], c, *ws );
 
-    VPII to_merge;
-    to_merge.reserve(N);
-    for( int i=0; i<N; i++ ){
-        if( first_occurrence[ marker[i] ] == -1 ) first_occurrence[marker[i]] = i;
-        else{
-            to_merge.emplace_back( first_occurrence[marker[i]], i );
+        for( int j=0; j<clusters[c].g.nodes.size(); j++ ){
+            int d = clusters[c].g.nodes[j];
+            inCl[d] = c;
+            idInCl[ d ] = j;
+            degInCl[d] = 0;
+            for( auto& [p,w] : clusters[c].g.V[j] ) degInCl[d] += w;
         }
     }
 
-//    DEBUG(empty_cl_mapper);
-//    DEBUG(first_occurrence);
-//    DEBUG(to_merge);
+    // new clusters that did not get any node (e.g. if a node was moved there, and then in [to_swap] moved again)
+    for( int c = old_empty; c < first_empty; c++ ){
+        if( !is_affected[c] ){
+            is_affected[c] = true;
+            affected.push_back(c);
+        }
+    }
 
-    initializeStateData(SINGLE_NODES); // this resets all arrays. Now node i is in cluster i.
-    mergeClusters(to_merge);
+    // Clusters that became empty are removed - the last cluster is moved to its place. Processing in decreasing order
+    // of ids guarantees, that the last cluster is never an empty one.
+    sort( ALL(affected), greater<int>() );
+    for( int c : affected ){
+        is_affected[c] = false;
+        if( clusters[c].size() > 0 ) continue;
+
+        int last = (int)clusters.size()-1;
+        if( c != last ){
+            swap( clusters[c], clusters.back() );
+            clusters[c].id = c;
+            for( int d : clusters[c].g.nodes ) inCl[d] = c;
+
+            if( !cl_neigh_graph.empty() ){
+                VB & was = ws->was3;
+                VI neighbors;
+                for( int d : clusters[c].g.nodes ){
+                    for( auto & [u,w] : clg->V[d] ){
+                        if( inCl[u] != c && !was[u] ){
+                            was[u] = true;
+                            neighbors.push_back(u);
+                        }
+                    }
+                }
+                for( int u : neighbors ){
+                    was[u] = false;
+                    renameClusterInClNeighGraph( u, last, c );
+                }
+            }
+        }
+        clusters.pop_back();
+    }
+
+    clusters.emplace_back( *clg, VI(), clusters.size(), *ws ); // adding empty cluster
+
+    for( int v : moved_nodes ) moved[v] = false;
 }
 
 void State::initializeStateData(StateInitializationType init_type) {
     vector<Cluster>().swap(clusters);
+    VVPII().swap(cl_neigh_graph); // it is no longer valid
 
-    was = was2 = was3 = VB(2*N,false); // creating helper arrays
-    marker = VI(N,false);
-//    marker2 = VVI(N);
+    ws->reserve(N); // making sure helper arrays are large enough
 
     inCl = VI(N, 0);
     idInCl = VI(N,0);
@@ -104,7 +197,7 @@ void State::initializeStateData(StateInitializationType init_type) {
     if(init_type == SINGLE_NODES) {
         for (int c = 0; c < N; c++) {
             inCl[c] = cnt;
-            clusters.emplace_back(*clg, VI({c}), cnt);
+            clusters.emplace_back( *clg, VI({c}), cnt, *ws );
             cnt++;
         }
     }else if(init_type == RANDOM_MATCHING){
@@ -142,7 +235,7 @@ void State::initializeStateData(StateInitializationType init_type) {
             if( !was[a] && !was[b] ){
                 was[a] = was[b] = true;
                 inCl[a] = inCl[b] = cnt;
-                clusters.emplace_back(*clg, VI({a,b}), cnt);
+                clusters.emplace_back( *clg, VI({a,b}), cnt, *ws );
                 if( clusters.back().g.nodes[0] == a){ idInCl[a] = 0; idInCl[b] = 1; }
                 else{
                     // this 'else' should not happen, unless inducing method is changed (now it preserves order of nodes
@@ -157,11 +250,12 @@ void State::initializeStateData(StateInitializationType init_type) {
         for( int i=0; i<N; i++ ){
             if(was[i]) continue;
             inCl[i] = cnt;
-            clusters.emplace_back(*clg, VI({i}), cnt);
+            clusters.emplace_back( *clg, VI({i}), cnt, *ws );
             cnt++;
         }
     }else if( init_type == SQRT_RANDOM ){
         clog << "SQRT RANDOM not tested yet" << endl;
+        VB & was = ws->was;
         UniformIntGenerator rnd(0,1e9);
         VI perm = CombinatoricUtils::getRandomPermutation(N, rnd.rand());
         int sq = ceil(sqrt(N));
@@ -169,7 +263,7 @@ void State::initializeStateData(StateInitializationType init_type) {
         VI current;
 
         auto add_current = [&](){
-            clusters.emplace_back(*clg, current, cnt);
+            clusters.emplace_back( *clg, current, cnt, *ws );
             for( int d : current ) was[d] = true;
             for(int d : current){
                 inCl[d] = cnt;
@@ -263,12 +357,12 @@ void State::initializeStateData(StateInitializationType init_type) {
             for( auto & [v,w] : clg->V[u] ) e_to_cl[ inCl[v] ] = 0; // clearing
         }
 
-        for( int i=0; i<cl_nodes.size(); i++ ) clusters.emplace_back( *clg, cl_nodes[i],i );
+        for( int i=0; i<cl_nodes.size(); i++ ) clusters.emplace_back( *clg, cl_nodes[i],i, *ws );
     }
     else if( init_type == LEAF_TRIMMING ) sparseGraphTrimming();
     else if( init_type == EXPANSION_ORDER ){
         VI nodes(N); iota(ALL(nodes),0);
-        Cluster cl( *clg, nodes,0 );
+        Cluster cl( *clg, nodes,0, *ws );
         ComponentExpansion ce(cl);
         ce.terminate_on_cluster_violator = true;
 
@@ -285,7 +379,7 @@ void State::initializeStateData(StateInitializationType init_type) {
             auto ord = ce.getExpansionOrder( {v}, true, 1e9 );
 //            DEBUG( ord.ord.size() );
 
-            clusters.emplace_back( *clg, ord.ord, cnt );
+            clusters.emplace_back( *clg, ord.ord, cnt, *ws );
             int cnt2 = 0;
             for( int d : ord.ord ){
                 was[d] = true;
@@ -306,7 +400,7 @@ void State::initializeStateData(StateInitializationType init_type) {
         }
     }
 
-    clusters.emplace_back( *clg, VI(), cnt++ ); // adding empty cluster
+    clusters.emplace_back( *clg, VI(), cnt++, *ws ); // adding empty cluster
 
 }
 
@@ -341,7 +435,7 @@ void State::mergeClusters(VPII &part) {
         if(!newSets[i].empty()){
             sort(ALL(newSets[i]));
 //            newClusters.emplace_back( *clg, newSets[i], invalid_id );
-            newClusters.emplace_back( *clg, newSets[i], invalid_id );
+            newClusters.emplace_back( *clg, newSets[i], invalid_id, *ws );
         }
     }
 
@@ -363,13 +457,13 @@ void State::mergeClusters(VPII &part) {
         }
     }
 
-    clusters.emplace_back( *clg, VI(), clusters.size() ); // adding empty cluster
+    clusters.emplace_back( *clg, VI(), clusters.size(), *ws ); // adding empty cluster
 
     int zero_node_clusters = 0;
     for( auto & cl : clusters ) if(cl.g.nodes.empty()) zero_node_clusters++;
     assert(zero_node_clusters == 1);
 
-    VVPII().swap(cl_neigh_graph);
+    VVPII().swap(cl_neigh_graph); // ids of all clusters could change, it will be created from scratch when needed
 }
 
 void State::mergeClusters(VVI to_merge) {
@@ -430,6 +524,66 @@ void State::createClNeighGraph() {
     }
 }
 
+void State::updateClNeighGraphForNode(int v) {
+    VI & weight = ws->edges_to_cluster;
+    VPII & neigh = cl_neigh_graph[v];
+    neigh.clear();
+
+    for( auto & [p,w] : clg->V[v] ){
+        int c = inCl[p];
+        if( c == inCl[v] ) continue;
+        if( weight[c] == 0 ) neigh.emplace_back(c,0);
+        weight[c] += w;
+    }
+
+    for( auto & [c,w] : neigh ){
+        w = weight[c];
+        weight[c] = 0;
+    }
+
+    sort(ALL(neigh), []( auto & a, auto & b ){
+        if( a.second != b.second ) return a.second > b.second;
+        else return a.first < b.first;
+    });
+}
+
+/**
+ * Moves element neigh[i] to its proper position, so that pairs are sorted by non-increasing weight (and by increasing
+ * cluster id for equal weights, the same as in createClNeighGraph()).
+ */
+static void restoreClNeighOrder( VPII & neigh, int i ){
+    auto before = []( PII & a, PII & b ){
+        if( a.second != b.second ) return a.second > b.second;
+        else return a.first < b.first;
+    };
+
+    while( i > 0 && before( neigh[i], neigh[i-1] ) ){ swap( neigh[i], neigh[i-1] ); i--; }
+    while( i+1 < neigh.size() && before( neigh[i+1], neigh[i] ) ){ swap( neigh[i], neigh[i+1] ); i++; }
+}
+
+void State::updateClNeighGraphEntry(int v, int c, int dw) {
+    VPII & neigh = cl_neigh_graph[v];
+    int i = 0;
+    while( i < neigh.size() && neigh[i].first != c ) i++;
+
+    if( i == neigh.size() ) neigh.emplace_back(c,0);
+    neigh[i].second += dw;
+
+    if( neigh[i].second == 0 ) neigh.erase( neigh.begin() + i );
+    else restoreClNeighOrder( neigh, i );
+}
+
+void State::renameClusterInClNeighGraph(int v, int old_id, int new_id) {
+    VPII & neigh = cl_neigh_graph[v];
+    for( int i=0; i<neigh.size(); i++ ){
+        if( neigh[i].first == old_id ){
+            neigh[i].first = new_id;
+            restoreClNeighOrder( neigh, i );
+            return;
+        }
+    }
+}
+
 int State::calculateResultForState() {
     int res = 0;
     for( auto & cl : clusters ){
@@ -457,7 +611,7 @@ void State::applyPartition(VI &part) {
 void State::sparseGraphTrimming() {
 
     VI deg(N,0);
-    was = VB(N,false);
+    VB was(N,false);
     deque<int> deg1_nodes;
 
     for(int i=0; i<N; i++){
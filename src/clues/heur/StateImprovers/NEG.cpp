@@ -8,19 +8,23 @@
 
 #include <combinatorics/CombinatoricUtils.h>
 #include <clues/heur/PaceUtils.h>
-#include <clues/heur/ConvexHullTrickDynamic.h>
 #include <clues/heur/Global.h>
 #include <clues/heur/SwapCandidates/ComponentExpansionRepulsion.h>
+#include <clues/heur/SwapValueKernels.h>
 #include <graphs/GraphUtils.h>
 #include "StandardUtils.h"
 #include "clues/heur/StateImprovers/NEG.h"
 
-NEG::NEG(State &st) : N(st.N), rnd(UniformIntGenerator(0,1e9)){
+NEG::NEG(State &st, Workspace & ws) : N(st.N), rnd(UniformIntGenerator(0,1e9)), ws(&ws), helper(ws.helper),
+    helper2(ws.helper2), helper_was(ws.helper_was), helper_was2(ws.helper_was2), helper_was3(ws.helper_was3){
     clg = st.clg;
 }
 
 
 void NEG::initializeIndependentData(State & st){
+    if( clg->csr_valid ) clgV = clg->csr; // copying arrays is faster than converting VVPII
+    else clgV = CSRGraph<PII>(clg->V);
+
     cluster_weights = VI( st.clusters.size() + 1 );
     for( auto & cl : st.clusters ){
         for(int d : cl.g.nodes) cluster_weights[cl.id] += clg->node_weights[d];
@@ -54,11 +58,7 @@ void NEG::initializeIndependentData(State & st){
 
     best_partition = PaceUtils::properlyRemapPartition(inCl);
 
-    helper = VI(2*N,0);
-    helper2 = VI(2*N,0);
-    helper_was = VB(2*N,0);
-    helper_was2 = VB(2*N,0);
-    helper_was3 = VB(2*N,0);
+    ws->reserve(N,true); // helper arrays are reused, but they are cleared
 
     min_w2_to_cluster_of_given_weight = VI( clg->origV->size()+1, 0);
 
@@ -70,12 +70,18 @@ void NEG::initializeIndependentData(State & st){
         edges_to_cluster_triangle = weight_ac_triangle = VI(2*N,0);
     }
 
+    node_move_cache = vector<NodeMoveCacheEntry>(N, {-1,0,0,0,0,-1});
+    node_move_ver = VI(N,0);
+    cluster_move_ver = VI(cluster_weights.size(),0);
+    node_move_cache_epoch = 0;
+
     nonempty_clusters_cnt = countNonemptyClusters();
 }
 
 void NEG::shuffleClg(){
     for( int i=0; i<clg->N; i++ ){
-        localShuffle( clg->V[i] );
+        auto row = clgV[i];
+        localShuffle( row );
     }
 };
 
@@ -115,8 +121,8 @@ void NEG::improve() {
     int JOIN_CLUSTERS_FREQUENCY = join_clusters_frequency;
 
     {
-        double E = GraphUtils::countEdges(clg->V);
-        double avg_deg = 2*E / clg->V.size();
+        double E = clgV.countEdges();
+        double avg_deg = 2*E / clgV.size();
 
         int MIN_DENSITY = 30; // #TEST!! originally this scaling was present!! - original value 30
         while( avg_deg > MIN_DENSITY ){
@@ -127,7 +133,7 @@ void NEG::improve() {
         }
 
 
-	avg_deg = 2*E / clg->V.size();
+	avg_deg = 2*E / clgV.size();
 		if(avg_deg > 0.1 * N ){
 			use_edge_swaps = false;
 			use_triangle_swaps = false;
@@ -152,6 +158,12 @@ void NEG::improve() {
         iter++;
         iters_since_last_perturbation++;
 
+        // the last iteration before a perturbation or termination is done without cached node moves
+        if( nn_iter == max_nonnegative_iters-1 ){
+            clearNodeMoveCache();
+            gain_buckets_filled = false; // keys may also be outdated
+        }
+
         if(debug){
             clog << endl << "\t***********************iter: " << iter << ", nn_iter: " << nn_iter << ", best: "
                  << best_result << " current: " << current_result << endl;
@@ -167,15 +179,48 @@ void NEG::improve() {
             queue.clear();
             localShuffle(perm);
             if(debug){ DEBUG(perm);DEBUG(*clg); }
-            for (int d : perm){ in_queue[d] = true; }
 
-            const double PERM_FRACTION = perm_fraction;
-            queue.assign( perm.begin(), perm.begin() + ( PERM_FRACTION * N) );
+            if( pool != nullptr && makeParallelNodeMoves(perm) ) improved = true;
+
+            if( use_gain_buckets ) startGainBucketsIteration(perm); // perm is used only to break ties randomly
+            else{
+                for (int d : perm){ in_queue[d] = true; }
+
+                const double PERM_FRACTION = perm_fraction;
+                queue.assign( perm.begin(), perm.begin() + ( PERM_FRACTION * N) );
+            }
         }
 
         int step = move_frequency;
 
-        while( !queue.empty() ){
+        bool use_edges_swaps_in_iteration =
+                use_edge_swaps &&
+                //                    ((nn_iter == last_nn_iter-2) ||
+                ((nn_iter == min(max(1,last_nn_iter-2), 3)) || // #TEST - early edge swaps
+                 ((iters_since_last_perturbation % EDGE_SWAPS_FREQUENCY) == EDGE_SWAPS_FREQUENCY-1));
+        // #TEST - using edges swaps every 20 node swap iterations
+
+        bool use_triangle_swaps_in_iteration =
+                (use_triangle_swaps > 0) &&
+                //                    ((nn_iter == last_nn_iter) ||
+                ((nn_iter == min(max(3,last_nn_iter-1), 5)) || // #TEST
+                 ((iters_since_last_perturbation % TRIANGLE_SWAPS_FREQUENCY) == TRIANGLE_SWAPS_FREQUENCY-1));
+        // #TEST - using triangle swaps
+
+        bool use_node_interchanging_in_iteration =
+                use_node_interchanging &&
+                //                    ((nn_iter == last_nn_iter)||
+                ((nn_iter == min(max(2, last_nn_iter - 2), 5)) || // #TEST
+                 ((iters_since_last_perturbation % NODE_INTERCHANING_FREQUENCY) == NODE_INTERCHANING_FREQUENCY - 1));
+
+        /**
+         * If only node moves are checked in this iteration, then nodes from gain buckets with positive swap values
+         * need not be checked at all.
+         */
+        const bool only_node_moves_in_iteration = !use_edges_swaps_in_iteration && !use_triangle_swaps_in_iteration &&
+                !(use_node_interchanging_in_inner_loop && use_node_interchanging_in_iteration);
+
+        while( !queue.empty() || (use_gain_buckets && !gain_buckets.empty()) ){
             if(Global::checkTle()){
                 if( current_result <= best_result ){
                     best_result = current_result;
@@ -185,6 +230,18 @@ void NEG::improve() {
             }
 
             iter_nodes_to_check.clear();
+            if( use_gain_buckets ){
+                if( only_node_moves_in_iteration && gain_buckets.minKey() > perturb_swp_thr ) break;
+
+                while( !gain_buckets.empty() && iter_nodes_to_check.size() < move_frequency ){
+                    int d = gain_buckets.pop();
+                    if( !gain_taken[d] ){
+                        gain_taken[d] = true;
+                        gain_taken_nodes.push_back(d);
+                    }
+                    iter_nodes_to_check.push_back(d);
+                }
+            }
             while( !queue.empty() && iter_nodes_to_check.size() < move_frequency ){
                 int d = queue.front();
                 queue.pop_front();
@@ -217,12 +274,6 @@ void NEG::improve() {
             }
 
             //*****************  EDGE MOVE
-            bool use_edges_swaps_in_iteration =
-                    use_edge_swaps &&
-                    //                    ((nn_iter == last_nn_iter-2) ||
-                    ((nn_iter == min(max(1,last_nn_iter-2), 3)) || // #TEST - early edge swaps
-                     ((iters_since_last_perturbation % EDGE_SWAPS_FREQUENCY) == EDGE_SWAPS_FREQUENCY-1));
-            // #TEST - using edges swaps every 20 node swap iterations
             /**
              * using edge swaps only if we are in nonnegative iterations, because it is rather slow
              * compared to node moves
@@ -251,12 +302,6 @@ void NEG::improve() {
             }
 
             //*****************  TRIANGLE MOVE
-            bool use_triangle_swaps_in_iteration =
-                    (use_triangle_swaps > 0) &&
-                    //                    ((nn_iter == last_nn_iter) ||
-                    ((nn_iter == min(max(3,last_nn_iter-1), 5)) || // #TEST
-                     ((iters_since_last_perturbation % TRIANGLE_SWAPS_FREQUENCY) == TRIANGLE_SWAPS_FREQUENCY-1));
-            // #TEST - using triangle swaps
             if(use_triangle_swaps_in_iteration){
                 auto best = getBestTriangleDiffClToMove(iter_nodes_to_check, a,b);
                 if( best.swpVal() < 0 ){
@@ -282,11 +327,6 @@ void NEG::improve() {
 
 //            //*****************  NODE INTERCHANGING
             if(use_node_interchanging_in_inner_loop){ // this should happen only in NEG_map
-                bool use_node_interchanging_in_iteration =
-                        use_node_interchanging &&
-                        //                    ((nn_iter == last_nn_iter)||
-                        ((nn_iter == min(max(2, last_nn_iter - 2), 5)) || // #TEST
-                         ((iters_since_last_perturbation % NODE_INTERCHANING_FREQUENCY) == NODE_INTERCHANING_FREQUENCY - 1));
                 if (use_node_interchanging_in_iteration) {
 
                     auto best = getBestInterchangeNodePairForInterval(iter_nodes_to_check, a, b);
@@ -310,6 +350,8 @@ void NEG::improve() {
                     }
                 }
             }
+
+            if( use_gain_buckets ) updateGainBuckets();
         }
         // *********************************************************  end of queue
 
@@ -453,67 +495,188 @@ tuple<int,int,int> NEG::getBestNodeMoveForRange(VI &perm, int a, int b) {
     int best_v = -1;
     int best_to = -1;
 
-
     best_node_move_results.clear();
 
+    // nodes are not moved here, so the same empty cluster is considered as target for all of them
+    const int empty_cl = *first_free_cluster.begin();
+    resizeStructuresForEmptyCluster(empty_cl);
+
     for( int i=a; i<=b; i++ ){
         int d = perm[i];
-        int cl_d = inCl[d];
-        int nw_d = clg->node_weights[d];
-
-        int w_0 = findEdgesToCluster(d,cl_d);
-
-        int tot_cld_possible_edges = (cluster_weights[cl_d] - clg->node_weights[d]) * clg->node_weights[d];
 
-        VPII etocld = getEdgesToCluster(d);
-        for( auto & [c,w] : etocld ){
-            if( c == cl_d ) continue;
-            int swpval = swapValueForNode(d, c, w_0, tot_cld_possible_edges, w);
+        int to, swpval;
+        getBestNodeMove( d, empty_cl, to, swpval, &node_move_ties, best_swpval );
+        if( use_gain_buckets && gain_buckets_filled ) gain_key[d] = swpval; // 1e9 if d cannot be moved
 
+        if( to != -1 ){
             if(swpval < best_swpval){
                 best_swpval = swpval;
                 best_v = d;
-                best_to = c;
+                best_to = to;
 
                 best_node_move_results.clear(); // #TEST
             }
 
-            if( swpval <= best_swpval ) best_node_move_results.emplace_back( d,c,swpval ); // #TEST
+            if( swpval <= best_swpval ){ // #TEST - all moves of d with the best swap value
+                for( int c : node_move_ties ) best_node_move_results.emplace_back( d,c,swpval );
+            }
         }
 
+        if(return_on_first_negative_swap && best_swpval < 0) break;
+    }
+
+    const bool USE_RANDOM_BEST_MOVE = true; // #TEST - getting random one of all best possible moves // originally false
+    if(USE_RANDOM_BEST_MOVE && !best_node_move_results.empty()){
+        auto get_clw_sum = [&](tuple<int,int,int > & a){
+            int to_a = get<1>(a);
+            return cluster_weights[to_a] + cluster_weights[to_a];
+        };
+
+        if( prefer_cluster_mode != 0 ){
+            localShuffle(best_node_move_results);
+            sort(ALL(best_node_move_results), [&]( auto& a, auto& b ){ return get_clw_sum(a) < get_clw_sum(b); });
+            if( prefer_cluster_mode == 2 ) reverse(ALL(best_node_move_results));
+
+            for( int i=1; i<best_node_move_results.size(); i++ ){
+                if( get_clw_sum( best_node_move_results[i] ) != get_clw_sum(best_node_move_results[i-1]) ){
+                    best_node_move_results.resize(i);
+                    break;
+                }
+            }
+        }
 
-        if( cluster_weights[cl_d] != nw_d ){
-            // if there is more than one node in cluster contatinig d, then we try to move it to an empty cluster
-            int c = *first_free_cluster.begin();
-            int w = 0;
-            resizeStructuresForEmptyCluster(c);
+        int ind = shuffle_seq[shuffle_ind++] % best_node_move_results.size();
+        if(shuffle_ind == shuffle_seq.size()) shuffle_ind = 0;
+        return best_node_move_results[ind];
+    }
 
-            int swpval = swapValueForNode(d, c, w_0, tot_cld_possible_edges, w);
+    return { best_v, best_to, best_swpval };
+}
 
-            if(swpval < best_swpval){
-                best_swpval = swpval;
-                best_v = d;
-                best_to = c;
+void NEG::evaluateNodeMove(int v, int empty_cl, int &to, int &val, VI *ties, int ties_max_val) {
+    VPII etocl = getEdgesToCluster(v);
+    evaluateNodeMoveToClusters( v, etocl.data(), etocl.size(), empty_cl, to, val, ties, ties_max_val );
+}
 
-                best_node_move_results.clear(); // #TEST
+void NEG::evaluateNodeMoveToClusters(int v, const PII *items, int n, int empty_cl, int &to, int &val, VI *ties,
+                                     int ties_max_val) {
+    int cl_v = inCl[v];
+    int nw_v = clg->node_weights[v];
+    int w_0 = findEdgesToCluster(v,cl_v);
+    int tot_clv_possible_edges = (cluster_weights[cl_v] - nw_v) * nw_v;
+
+    to = -1;
+    val = 1e9;
+    if(ties != nullptr) ties->clear();
+
+    if( n >= SwapValueKernels::MIN_SIMD_SIZE ){
+        int min_val;
+        int ind = SwapValueKernels::argminMoveValuePairs( items, n, cluster_weights.data(), cl_v, nw_v, min_val );
+        if( ind != -1 ){
+            to = items[ind].first;
+            val = min_val + 2*w_0 - tot_clv_possible_edges; // the same as swapValueForNode()
+
+            if( ties != nullptr && val <= ties_max_val ){ // all moves of v with the best swap value
+                for( int i=ind; i<n; i++ ){
+                    auto [c,w] = items[i];
+                    if( c != cl_v && nw_v * cluster_weights[c] - 2*w == min_val ) ties->push_back(c);
+                }
             }
+        }
+    }else{
+        const int base = 2*w_0 - tot_clv_possible_edges;
+        for( int i=0; i<n; i++ ){
+            auto [c,w] = items[i];
+            if( c == cl_v ) continue;
+            int swpval = nw_v * cluster_weights[c] - 2*w + base; // the same as swapValueForNode()
+            if( swpval < val ){
+                val = swpval;
+                to = c;
+                if(ties != nullptr) ties->clear();
+            }
+            if( ties != nullptr && swpval == val ) ties->push_back(c);
+        }
+    }
 
-            if( swpval <= best_swpval ) best_node_move_results.emplace_back( d,c,swpval ); // #TEST
-
-            if(return_on_first_negative_swap && best_swpval < 0) break;
+    if( cluster_weights[cl_v] != nw_v ){
+        // if there is more than one node in cluster contatinig v, then we try to move it to an empty cluster
+        int swpval = swapValueForNode(v, empty_cl, w_0, tot_clv_possible_edges, 0);
+        if( swpval < val ){
+            val = swpval;
+            to = empty_cl;
+            if(ties != nullptr) ties->clear();
         }
+        if( ties != nullptr && swpval == val ) ties->push_back(empty_cl);
+    }
+}
 
-        if(return_on_first_negative_swap && best_swpval < 0) break;
+void NEG::getBestNodeMove(int v, int empty_cl, int &to, int &val, VI *ties, int ties_max_val) {
+    const bool use_cache = use_node_move_cache && clgV[v].size() >= node_move_cache_min_size;
+
+    if( use_cache && getCachedNodeMove(v, to, val) ){ // nothing changed around v since its best move was found
+        if( ties != nullptr ){
+            ties->clear();
+            if( to != -1 ) ties->push_back(to);
+        }
+        return;
     }
 
-    const bool USE_RANDOM_BEST_MOVE = true; // #TEST - getting random one of all best possible moves // originally false
-    if(USE_RANDOM_BEST_MOVE && !best_node_move_results.empty()){
-        int ind = (perm[0] + perm.back()) % best_node_move_results.size();
+    evaluateNodeMove(v, empty_cl, to, val, ties, ties_max_val);
+    if( use_cache ) cacheNodeMove( v, to, val );
+}
 
-        return best_node_move_results[ind];
+bool NEG::makeParallelNodeMoves(VI &perm) {
+    if(!use_node_swaps) return false;
+    bool improved = false;
+
+    const int B = parallel_batch_size;
+    batch_to.resize(B);
+    batch_val.resize(B);
+
+    for( int a=0; a<perm.size(); a += B ){
+        if( Global::checkTle() ) break;
+        int cnt = min( (int)perm.size() - a, B );
+
+        const int empty_cl = *first_free_cluster.begin();
+        resizeStructuresForEmptyCluster(empty_cl);
+
+        // read-only phase - nothing but node_move_cache entries of nodes in the batch is modified
+        pool->parallelFor( cnt, [&]( int i ){
+            getBestNodeMove( perm[a+i], empty_cl, batch_to[i], batch_val[i] );
+        } );
+
+        // sequential phase - applying cluster-disjoint moves, starting from the best ones
+        batch_order.clear();
+        for( int i=0; i<cnt; i++ ) if( batch_to[i] != -1 && batch_val[i] < 0 ) batch_order.push_back(i);
+        stable_sort( ALL(batch_order), [&]( int x, int y ){ return batch_val[x] < batch_val[y]; } );
+
+        batch_id++;
+        for( int i : batch_order ){
+            int v = perm[a+i];
+            int from = inCl[v];
+            int to = batch_to[i];
+
+            // all moves to an empty cluster were evaluated for [empty_cl], but the swap value is the same for any
+            // empty cluster - each such move gets its own empty cluster, not touched in this batch, so that such moves
+            // do not conflict
+            if( to == empty_cl ){
+                auto it = first_free_cluster.begin();
+                while( *it < cluster_batch.size() && cluster_batch[*it] == batch_id ) it++;
+                to = *it;
+            }
+            resizeStructuresForEmptyCluster(to);
+
+            if( cluster_batch.size() < cluster_weights.size() ) cluster_batch.resize( cluster_weights.size(), 0 );
+            if( cluster_batch[from] == batch_id || cluster_batch[to] == batch_id ) continue;
+            cluster_batch[from] = cluster_batch[to] = batch_id;
+
+            moveNodeTo(v, to);
+            current_result += batch_val[i];
+            improved = true;
+        }
     }
 
-    return { best_v, best_to, best_swpval };
+    return improved;
 }
 
 int NEG::swapValueForNode(int v, int trg_cl, int edges_clv, int tot_clv_possible_edges, int edges_trg) {
@@ -551,7 +714,8 @@ tuple<PII, PII, int> NEG::getBestEdgeMoveForRange(VI &perm, int a, int b) {
             DEBUG(u); DEBUG(cl_u); DEBUG(nw_u);
         }
 
-        ConvexHullTrickDynamic hull(false); // minimizing
+        ConvexHullTrickStatic & hull = edge_swap_hull; // minimizing
+        hull.clear();
         const int empty_cluster = *first_free_cluster.begin();
 
         createEdgesToCluster(u);
@@ -583,7 +747,7 @@ tuple<PII, PII, int> NEG::getBestEdgeMoveForRange(VI &perm, int a, int b) {
 
         int etc_u_clu = findEdgesToCluster(u,cl_u);
 
-        for( auto & [v,w0] : clg->V[u] ){
+        for( auto & [v,w0] : clgV[u] ){
             createEdgesToCluster(v);
             auto etoclv = getEdgesToCluster(v);
 
@@ -839,6 +1003,9 @@ void NEG::setConfigurations(Config &cnf) {
     use_edge_swaps = cnf.neg_use_edge_swaps;
     use_triangle_swaps = cnf.neg_use_triangle_swaps;
     use_queue_propagation = cnf.neg_use_queue_propagation;
+    use_node_move_cache = cnf.neg_use_node_move_cache;
+    use_gain_buckets = cnf.neg_use_gain_buckets;
+    parallel_batch_size = cnf.neg_parallel_batch_size;
     use_node_interchanging = cnf.neg_use_node_interchange;
     use_join_clusters = cnf.neg_use_join_clusters;
     use_chain2_swaps = cnf.neg_use_chain2_swaps;
@@ -858,9 +1025,129 @@ void NEG::setConfigurations(Config &cnf) {
     use_triangle_swaps_to_other_clusters = cnf.neg_use_triangle_swaps_to_other_clusters;
 }
 
+bool NEG::getCachedNodeMove(int v, int &to, int &val) {
+    auto & e = node_move_cache[v];
+    if( e.epoch != node_move_cache_epoch || e.node_ver != node_move_ver[v] ) return false;
+    if( e.cl_ver != cluster_move_ver[ inCl[v] ] ) return false;
+    if( e.to != -1 && e.to_ver != cluster_move_ver[e.to] ) return false;
+
+    to = e.to;
+    val = e.val;
+    return true;
+}
+
+void NEG::cacheNodeMove(int v, int to, int val) {
+    node_move_cache[v] = { to, val, node_move_ver[v], cluster_move_ver[ inCl[v] ],
+                           (to == -1) ? 0 : cluster_move_ver[to], node_move_cache_epoch };
+}
+
+void NEG::invalidateNodeMoveCache(int v, int from, int to) {
+    node_move_ver[v]++;
+    for( auto & [p,w] : clgV[v] ) node_move_ver[p]++;
+    cluster_move_ver[from]++;
+    cluster_move_ver[to]++;
+}
+
+void NEG::startGainBucketsIteration(VI &perm) {
+    if( gain_buckets.bucket.size() != N ){
+        int max_key = 1;
+        for( int v=0; v<N; v++ ){
+            int s = 0;
+            for( auto & [p,w] : clgV[v] ) s += w;
+            max_key = max( max_key, 2*s );
+        }
+        gain_buckets = GainBuckets( N, max_key );
+        gain_key = gain_stamp = VI(N,0);
+        gain_taken = VB(N,false);
+        gain_buckets_filled = false;
+    }
+
+    for( int v : gain_taken_nodes ) gain_taken[v] = false;
+    gain_taken_nodes.clear();
+
+    if( !gain_buckets_filled ){
+        gain_buckets.clear();
+        gain_moved_nodes.clear();
+
+        const int empty_cl = *first_free_cluster.begin();
+        resizeStructuresForEmptyCluster(empty_cl);
+
+        // nodes are inserted in reverse order of perm, so that nodes with equal keys are taken in the order of perm
+        for( int i=(int)perm.size()-1; i>=0; i-- ){
+            int v = perm[i], to;
+            getBestNodeMove( v, empty_cl, to, gain_key[v] );
+            gain_buckets.update( v, gain_key[v] ); // gain_key[v] is 1e9 if v cannot be moved
+        }
+        gain_evaluations += N;
+        gain_buckets_filled = true;
+    }else{
+        updateGainBuckets(); // nodes moved e.g. by perturbation or chain2 swaps
+        for( int i=(int)perm.size()-1; i>=0; i-- ){
+            int v = perm[i];
+            if( !gain_buckets.contains(v) ) gain_buckets.update( v, gain_key[v] );
+        }
+    }
+}
+
+void NEG::scheduleNodeInGainBuckets(int v) {
+    const int empty_cl = *first_free_cluster.begin();
+    resizeStructuresForEmptyCluster(empty_cl);
+
+    int to;
+    getBestNodeMove( v, empty_cl, to, gain_key[v] );
+    gain_evaluations++;
+
+    if( gain_buckets.contains(v) || gain_key[v] < 0 ) gain_buckets.update( v, gain_key[v] );
+}
+
+void NEG::updateGainBuckets() {
+    if( gain_moved_nodes.empty() ) return;
+
+    gain_stamp_id++;
+    auto schedule = [&]( int v ){
+        if( gain_stamp[v] == gain_stamp_id ) return;
+        gain_stamp[v] = gain_stamp_id;
+        scheduleNodeInGainBuckets(v);
+    };
+
+    for( auto [v,from,to] : gain_moved_nodes ) schedule(v);
+
+    for( auto [v,from,to] : gain_moved_nodes ){
+        if( from == to ) continue;
+        int nv = clg->node_weights[v];
+
+        for( auto & [p,w] : clgV[v] ){
+            if( gain_stamp[p] == gain_stamp_id ) continue; // key is already exact
+            if( !gain_buckets.contains(p) ){
+                if( gain_taken[p] ) schedule(p);
+                continue;
+            }
+
+            int np = clg->node_weights[p];
+            int cl_p = inCl[p]; // p was not moved, so it was in that cluster during the move of v
+            int dec;
+            if( cl_p == from ) dec = max( 2*w - np*nv, 4*w - 2*np*nv );
+            else if( cl_p == to ) dec = max( 2*np*nv - 4*w, np*nv - 2*w );
+            else dec = abs( np*nv - 2*w );
+
+            if( dec > 0 ){
+                gain_key[p] -= dec;
+                gain_buckets.update( p, gain_key[p] );
+            }
+        }
+    }
+    gain_moved_nodes.clear();
+}
+
 void NEG::addClusterNodesToQueue(int cl_id) {
     if(!use_queue_propagation) return; // do not use queue propagation
 
+    if( use_gain_buckets ){
+        // indices are used, because cluster_nodes may be resized when nodes are evaluated
+        for( int i=0; i<cluster_nodes[cl_id].size(); i++ ) scheduleNodeInGainBuckets( cluster_nodes[cl_id][i] );
+        return;
+    }
+
     for( int v : cluster_nodes[cl_id] ){
         if( !in_queue[v] ){
             in_queue[v] = true;
@@ -961,7 +1248,7 @@ SwapCandidateAdapter NEG::getBestInterchangeNodePair(int v) {
     int e_v_tocl_v = findEdgesToCluster(v,cl_v);
     int nw_v = clg->node_weights[v];
 
-    for( auto & [u,w] : clg->V[v] ) { // checking all edges
+    for( auto & [u,w] : clgV[v] ) { // checking all edges
         int cl_u = inCl[u];
         if(cl_u == cl_v) continue;
         int clw_u = cluster_weights[cl_u];
@@ -1021,7 +1308,7 @@ SwapCandidateAdapter NEG::getBestInterchangeNodePair(int v) {
 
     }
 
-    for( auto & [u,w] : clg->V[v] ) checked_for_v[u] = false;
+    for( auto & [u,w] : clgV[v] ) checked_for_v[u] = false;
 
     if(debug){
         clog << "best interchaning pair: " << best.getNodesToSwap() << ", swpval: " << best.swpVal() << endl;
@@ -1322,7 +1609,7 @@ bool NEG::makeChain2Swaps() {
                 DEBUG(affected_clusters);
             }
 
-            for( auto & [v,w] : clg->V[u] ) weight_to_node[v] = w;
+            for( auto & [v,w] : clgV[u] ) weight_to_node[v] = w;
             for( auto & [c,val] : possible_swaps[u] ) swpval_to_cluster[c] = val;
 
             if(debug) DEBUG(swpval_to_cluster);
@@ -1419,7 +1706,7 @@ bool NEG::makeChain2Swaps() {
             }
 
             for( auto & [c,val] : possible_swaps[u] ) swpval_to_cluster[c] = 0; // clearing
-            for( auto & [v,w] : clg->V[u] ){
+            for( auto & [v,w] : clgV[u] ){
                 weight_to_node[v] = 0; // clearing
             }
         }
@@ -1483,6 +1770,7 @@ void NEG::resizeStructuresForEmptyCluster(int empty_cl) {
     while( cluster_weights.size() <= empty_cl ){
         cluster_weights.push_back(0);
         cluster_nodes.push_back( {} );
+        cluster_move_ver.push_back(0);
     }
 }
 
@@ -4,14 +4,13 @@
 
 #include <combinatorics/CombinatoricUtils.h>
 #include <clues/heur/PaceUtils.h>
-#include <clues/heur/ConvexHullTrickDynamic.h>
 #include <clues/heur/Global.h>
 #include <clues/heur/SwapCandidates/ComponentExpansionRepulsion.h>
 #include <graphs/GraphUtils.h>
 #include "StandardUtils.h"
 #include "clues/heur/StateImprovers/NodeEdgeGreedy.h"
 
-NodeEdgeGreedy::NodeEdgeGreedy(State &st) : NEG(st){
+NodeEdgeGreedy::NodeEdgeGreedy(State &st, Workspace & ws) : NEG(st, ws){
     initializeForState(st);
 }
 
@@ -19,14 +18,14 @@ void NodeEdgeGreedy::initializeForState(State &st) {
     {
         VI v; localShuffle(v); // initializing shuffle_seq
 
-//        edges_to_cluster = vector<unordered_map<int,int>>(N);
-        edges_to_cluster = vector<unordered_map<int,int,quick_hash>>(N);
-//        edges_to_cluster = vector<map<int,int>>(N);
+        edges_to_cluster = vector<AdaptiveIntMap<>>(N);
 
-        cluster_nodes = vector<unordered_set<int>> ( st.clusters.size()+1 );
+        cluster_nodes = VVI( st.clusters.size()+1 );
+        pos_in_cluster = VI(N,-1);
         for( auto & cl : st.clusters ){
-            cluster_nodes[cl.id].insert(ALL(cl.g.nodes));
+            for( int d : cl.g.nodes ) addToCluster(d, cl.id);
         }
+        cluster_nodes_valid = true;
 
         if(st.cl_neigh_graph.empty()) st.createClNeighGraph();
         for( int i=0; i<st.N; i++ ){
@@ -50,102 +49,12 @@ void NodeEdgeGreedy::improve(){
     NEG::improve();
 }
 
-tuple<int,int,int> NodeEdgeGreedy::getBestNodeMoveForRange(VI &perm, int a, int b) {
-    if(!use_node_swaps) return {-1,-1,1e9};
-    const bool debug = false;
-
-    if(debug){
-        clog << "Checking moves of nodes from range perm[" << a << ":" << b << "] = "
-             << StandardUtils::getSubarray(perm,a,b-1) << endl;
-    }
-
-    int best_swpval = 1e9;
-    int best_v = -1;
-    int best_to = -1;
-
-    best_node_move_results.clear();
-
-    for( int i=a; i<=b; i++ ){
-        int d = perm[i];
-        int cl_d = inCl[d];
-        int nw_d = clg->node_weights[d];
-
-        int w_0 = findEdgesToCluster(d,cl_d);
-
-        int tot_cld_possible_edges = (cluster_weights[cl_d] - clg->node_weights[d]) * clg->node_weights[d];
-
-        for( auto & [c,w] : edges_to_cluster[d] ){
-            if( c == cl_d ) continue;
-            int swpval = swapValueForNode(d, c, w_0, tot_cld_possible_edges, w);
-
-            if(swpval < best_swpval){
-                best_swpval = swpval;
-                best_v = d;
-                best_to = c;
-
-                best_node_move_results.clear(); // #TEST
-            }
-
-            if( swpval <= best_swpval ) best_node_move_results.emplace_back( d,c,swpval ); // #TEST
-        }
-
-
-        if( cluster_weights[cl_d] != nw_d ){
-            // if there is more than one node in cluster contatinig d, then we try to move it to an empty cluster
-            int c = *first_free_cluster.begin();
-            int w = 0;
-//            while(cluster_weights.size() <= c){ cluster_weights.push_back(0);cluster_nodes.push_back( {} ); }
-            resizeStructuresForEmptyCluster(c);
-
-            int swpval = swapValueForNode(d, c, w_0, tot_cld_possible_edges, w);
-
-            if(swpval < best_swpval){
-                best_swpval = swpval;
-                best_v = d;
-                best_to = c;
-
-                best_node_move_results.clear(); // #TEST
-            }
-
-            if( swpval <= best_swpval ) best_node_move_results.emplace_back( d,c,swpval ); // #TEST
-
-            if(return_on_first_negative_swap && best_swpval < 0) break;
-        }
-
-        if(return_on_first_negative_swap && best_swpval < 0) break;
-    }
-
-    const bool USE_RANDOM_BEST_MOVE = true; // #TEST - getting random one of all best possible moves // originally false
-    if(USE_RANDOM_BEST_MOVE && !best_node_move_results.empty()){
-        auto get_clw_sum = [&](tuple<int,int,int > & a){
-            int to_a = get<1>(a);
-            return cluster_weights[to_a] + cluster_weights[to_a];
-        };
-
-        if( prefer_cluster_mode != 0 ){
-            localShuffle(best_node_move_results);
-            sort(ALL(best_node_move_results), [&]( auto& a, auto& b ){ return get_clw_sum(a) < get_clw_sum(b); });
-            if( prefer_cluster_mode == 2 ) reverse(ALL(best_node_move_results));
-
-            for( int i=1; i<best_node_move_results.size(); i++ ){
-                if( get_clw_sum( best_node_move_results[i] ) != get_clw_sum(best_node_move_results[i-1]) ){
-                    best_node_move_results.resize(i);
-                    break;
-                }
-            }
-        }
-
-
-
-        int ind = shuffle_seq[shuffle_ind++] % best_node_move_results.size();
-        if(shuffle_ind == shuffle_seq.size()) shuffle_ind = 0;
-        return best_node_move_results[ind];
-    }
-
-    return { best_v, best_to, best_swpval };
+void NodeEdgeGreedy::evaluateNodeMove(int d, int empty_cl, int &to, int &val, VI *ties, int ties_max_val) {
+    // pairs are read directly from the map, without copying them as getEdgesToCluster() does
+    evaluateNodeMoveToClusters( d, edges_to_cluster[d].begin(), edges_to_cluster[d].size(), empty_cl, to, val, ties,
+                                ties_max_val );
 }
 
-
 tuple< PII, PII,int > NodeEdgeGreedy::getBestEdgeMoveForRange(VI &perm, int a, int b) {
     if(!use_edge_swaps) return {{-1,-1},{-1,-1},(int)1e9};
 
@@ -200,7 +109,8 @@ tuple< PII, PII,int > NodeEdgeGreedy::getBestEdgeMoveForRange(VI &perm, int a, i
                                        swapValueForNode(u, empty_cluster, etc_u_clu, (cluster_weights[cl_u] - nw_u) * nw_u, 0) );
         }
 
-        ConvexHullTrickDynamic hull(false); // minimizing
+        ConvexHullTrickStatic & hull = edge_swap_hull; // minimizing
+        hull.clear();
 
         if(USE_HULL_TRICK_IN_EDGE_SWAPS){ // insert to hull
             hull.insert_line(0,0, empty_cluster);
@@ -238,7 +148,7 @@ tuple< PII, PII,int > NodeEdgeGreedy::getBestEdgeMoveForRange(VI &perm, int a, i
             }
         }
 
-        for( auto & [v,w0] : clg->V[u] ){
+        for( auto & [v,w0] : clgV[u] ){
 
             // this 2* factor is just to increase variability whilst preserving good complexity
             // selecting FACTOR 1.5 or 2 should be ok
@@ -395,8 +305,7 @@ void NodeEdgeGreedy::moveNodeTo(int v, int to) {
     int cl_v = inCl[v];
     int nw_v = clg->node_weights[v];
     cluster_weights[cl_v] -= nw_v;
-    cluster_nodes[cl_v].erase(v);
-    if(cluster_nodes[cl_v].empty()) nonempty_clusters_cnt--;
+    if(cluster_weights[cl_v] == 0) nonempty_clusters_cnt--;
 
     if( is_empty_cluster[to] ){
         first_free_cluster.erase(to);
@@ -409,16 +318,8 @@ void NodeEdgeGreedy::moveNodeTo(int v, int to) {
     }
 
     degInCl[v] = 0;
-    for( auto & [p,w] : clg->V[v] ){
-        edges_to_cluster[p][to] += w;
-
-        { // new version, perhaps a bit faster
-            auto it = edges_to_cluster[p].find(cl_v);
-            assert(it != edges_to_cluster[p].end());
-            it->second -= w;
-            assert(it->second >= 0);
-            if(it->second == 0) edges_to_cluster[p].erase(it);
-        }
+    for( auto & [p,w] : clgV[v] ){
+        edges_to_cluster[p].transfer(cl_v, to, w);
 
         if( inCl[p] == cl_v ) degInCl[p] -= w;
 
@@ -431,13 +332,60 @@ void NodeEdgeGreedy::moveNodeTo(int v, int to) {
     inCl[v] = to;
 
     resizeStructuresForEmptyCluster(to);
+    if( use_node_move_cache ) invalidateNodeMoveCache(v, cl_v, to);
+    if( use_gain_buckets ) gain_moved_nodes.emplace_back(v, cl_v, to);
     cluster_weights[to] += nw_v;
     if( cluster_weights[to] == nw_v ) nonempty_clusters_cnt++;
 
-    cluster_nodes[to].insert(v);
+    if( cluster_nodes_valid && use_queue_propagation ){
+        removeFromCluster(v,cl_v);
+        addToCluster(v,to);
+    }
+    else cluster_nodes_valid = false;
+}
+
+void NodeEdgeGreedy::addClusterNodesToQueue(int cl_id) {
+    if(!use_queue_propagation) return;
+
+    // NEG::cluster_nodes is not kept up to date here, so we need to use our own cluster_nodes
+    updateClusterNodes();
+    if( use_gain_buckets ){
+        for( int i=0; i<cluster_nodes[cl_id].size(); i++ ) scheduleNodeInGainBuckets( cluster_nodes[cl_id][i] );
+        return;
+    }
+
+    for( int v : cluster_nodes[cl_id] ){
+        if( !in_queue[v] ){
+            in_queue[v] = true;
+            queue.push_front(v);
+        }
+    }
+}
+
+void NodeEdgeGreedy::addToCluster(int v, int c) {
+    pos_in_cluster[v] = cluster_nodes[c].size();
+    cluster_nodes[c].push_back(v);
+}
+
+void NodeEdgeGreedy::updateClusterNodes() {
+    if( cluster_nodes_valid ) return;
+    for( auto & nodes : cluster_nodes ) nodes.clear();
+    for( int v=0; v<N; v++ ) addToCluster(v, inCl[v]);
+    cluster_nodes_valid = true;
+}
+
+void NodeEdgeGreedy::removeFromCluster(int v, int c) {
+    auto & nodes = cluster_nodes[c];
+    int p = pos_in_cluster[v];
+    assert( nodes[p] == v );
+    nodes[p] = nodes.back();
+    pos_in_cluster[ nodes[p] ] = p;
+    nodes.pop_back();
+    pos_in_cluster[v] = -1;
 }
 
 int NodeEdgeGreedy::countNonemptyClusters() {
+    updateClusterNodes();
     int cnt = 0;
     for( auto & zb : cluster_nodes ) if(!zb.empty()) cnt++;
     return cnt;
@@ -499,12 +447,12 @@ SwapCandidateAdapter NodeEdgeGreedy::getBestTriangleAll(int v) {
         if( Global::checkTle() ) continue;
 
         int in_cl_a = inCl[a];
-        int deg_in_cl_a = findEdgesToCluster(a,in_cl_a);
+        int deg_in_cl_a = degInCl[a];
 
         int nw_a = clg->node_weights[a];
         int clw_a = cluster_weights[in_cl_a];
 
-        for( auto & [d,w] : clg->V[a] ){ helper_was[d] = true; weight_ac_triangle[d] = w; }
+        for( auto & [d,w] : clgV[a] ){ helper_was[d] = true; weight_ac_triangle[d] = w; }
 
         if(!only_empty_cluster){
             neigh_a.clear();
@@ -519,12 +467,12 @@ SwapCandidateAdapter NodeEdgeGreedy::getBestTriangleAll(int v) {
         }
 
 
-        for( auto & [b,wab] : clg->V[a] ){
+        for( auto & [b,wab] : clgV[a] ){
             if( Global::checkTle() ) continue;
-            if( clg->V[b].size() > FACTOR * clg->V[a].size() + ADD ) continue; // #TEST
+            if( clgV[b].size() > FACTOR * clgV[a].size() + ADD ) continue; // #TEST
 
             int in_cl_b = inCl[b];
-            int deg_in_cl_b = findEdgesToCluster(b,in_cl_b);
+            int deg_in_cl_b = degInCl[b];
 
             int nw_b = clg->node_weights[b];
             int clw_b = cluster_weights[in_cl_b];
@@ -541,11 +489,11 @@ SwapCandidateAdapter NodeEdgeGreedy::getBestTriangleAll(int v) {
                 }
             }
 
-            for(auto & [c,wbc] : clg->V[b]){
+            for(auto & [c,wbc] : clgV[b]){
                 if( c == a ) continue;
 
-                if( clg->V[c].size() > FACTOR * clg->V[a].size() + ADD  ||
-                 clg->V[c].size() > FACTOR * clg->V[b].size() + ADD ){
+                if( clgV[c].size() > FACTOR * clgV[a].size() + ADD  ||
+                 clgV[c].size() > FACTOR * clgV[b].size() + ADD ){
                     continue; // #TEST
                 }
 
@@ -553,7 +501,7 @@ SwapCandidateAdapter NodeEdgeGreedy::getBestTriangleAll(int v) {
                 int wac = weight_ac_triangle[c];
 
                 int in_cl_c = inCl[c];
-                int deg_in_cl_c = findEdgesToCluster(c,in_cl_c);
+                int deg_in_cl_c = degInCl[c];
 
                 int nw_c = clg->node_weights[c];
                 int clw_c = cluster_weights[in_cl_c];
@@ -598,8 +546,9 @@ SwapCandidateAdapter NodeEdgeGreedy::getBestTriangleAll(int v) {
                 neigh_abc.clear();
                 neigh_abc.push_back(empty_cluster_id);
 
-                bool ADD_CLUSTERS = (!only_empty_cluster);
-                if(helper_was[c] && ADD_CLUSTERS) ADD_CLUSTERS = (b<c);// we do not need to consider b>c, since (a,b,c) is a triangle
+                // only triangles are moved to other clusters, paths a,b,c are moved only to an empty cluster - otherwise
+                // on dense graphs most of the time was spent here
+                const bool ADD_CLUSTERS = (!only_empty_cluster) && helper_was[c] && (b<c); // we do not need to consider b>c, since (a,b,c) is a triangle
 
                 if( ADD_CLUSTERS ) {
                     assert(best_clusters.size() <= MAX_BEST_CL_SIZE);
@@ -657,13 +606,14 @@ SwapCandidateAdapter NodeEdgeGreedy::getBestTriangleAll(int v) {
             for( int d : neigh_a ) helper_was2[d] = false; // clearing those clusters, to which node a is incident
         }
 
-        for( auto & [d,w] : clg->V[a] ){ helper_was[d] = false; weight_ac_triangle[d] = 0; /* clearing*/ }
+        for( auto & [d,w] : clgV[a] ){ helper_was[d] = false; weight_ac_triangle[d] = 0; /* clearing*/ }
     }
 
     return res;
 }
 
 int NodeEdgeGreedy::countClusterNumerationGaps() {
+    updateClusterNodes();
     int empty_cnt = 0;
     int res = 0;
 
@@ -683,9 +633,7 @@ int NodeEdgeGreedy::findEdgesToCluster(int v, int cl) {
     if( cl == inCl[v] ) return degInCl[v];
     if(is_empty_cluster[cl]) return 0;
 
-    auto it = edges_to_cluster[v].find(cl);
-    if( it == edges_to_cluster[v].end() ) return 0;
-    else return it->second;
+    return edges_to_cluster[v].get(cl);
 }
 
 VPII NodeEdgeGreedy::getEdgesToCluster(int v) {
@@ -694,17 +642,20 @@ VPII NodeEdgeGreedy::getEdgesToCluster(int v) {
 
 void NodeEdgeGreedy::createClusterNodes() {
 //    NEG::cluster_nodes = VVI(cluster_nodes.size() );
+    updateClusterNodes();
     NEG::cluster_nodes = VVI(cluster_nodes.size() + 5); // CAUTION adding space for some 'uninitialized empty clusters'
     for( int i=0; i<cluster_nodes.size(); i++ ){
-        if(!cluster_nodes[i].empty()) NEG::cluster_nodes[i] = VI( ALL(cluster_nodes[i]) );
+        if(!cluster_nodes[i].empty()) NEG::cluster_nodes[i] = cluster_nodes[i];
     }
 }
 
 VI NodeEdgeGreedy::getClusterNodes(int c) {
-    return VI(ALL(cluster_nodes[c]));
+    updateClusterNodes();
+    return cluster_nodes[c];
 }
 
 int NodeEdgeGreedy::maxClusterId() {
+    updateClusterNodes();
     for( int i=(int)cluster_nodes.size()-1; i>=0; i-- ){
         if(!cluster_nodes[i].empty()) return i;
     }
@@ -50,9 +50,14 @@ ComponentExpansionAttraction::ComponentExpansionAttraction(State &st) {
 
     int max_node_weight = 0;
     for( int nw : clg->node_weights ) max_node_weight = max(max_node_weight, nw);
-    cluster_cores.resize( max_node_weight + 1 );
+    cluster_cores.resize( min<int>( cluster_cores.size(), max_node_weight + 1 ) );
+    while( cluster_cores.size() < max_node_weight + 1 ) cluster_cores.emplace_back( &heap_pos, CoreCmp{this} );
+    nw_count = VI( max_node_weight + 1, 0 );
+    nw_pos = VI( max_node_weight + 1, -1 );
 
     edges_in_cl = VI(N,0);
+    free_val = VI(N,0);
+    heap_pos = VI(N,-1);
 }
 
 void ComponentExpansionAttraction::initialize() {
@@ -61,7 +66,7 @@ void ComponentExpansionAttraction::initialize() {
 
     { // some initialization
         S.clear();
-        S.insert(ALL(cl->g.nodes));
+        S.insert( S.end(), ALL(cl->g.nodes) );
         for(int d : S) inS[d] = true;
         sumNWinS = 0;
 
@@ -86,13 +91,7 @@ void ComponentExpansionAttraction::initialize() {
 
             for( int d : st->clusters[c].g.nodes ){
                 edges_in_cl[d] = st->degInCl[d]; // initially that is the number of edges of node d in its cluster
-
-                int nw_d =  clg->node_weights[d];
-
-                int free_value = getFreeValue(d);
-                cluster_cores[nw_d].insert( PII( free_value,d ) );
-
-                node_neigh_weights[nw_d]++;
+                addToClusterCores(d);
             }
         }
 
@@ -124,9 +123,13 @@ ComponentExpansionAttraction::createSwapCandidates(Cluster& cl){
 
     auto debug_all = [&](){
         DEBUG(S); DEBUG(sumNWinS); DEBUG(eToS);
-        DEBUG(cl_neigh); DEBUG(cluster_weights); //DEBUG(cluster_cores);
-        DEBUG(edges_in_cl); DEBUG(node_neigh_weights);
-        for( auto [c,cnt] : node_neigh_weights ) clog << "******   cluster_cores[" << c << "]: " << endl << cluster_cores[c] << endl;
+        DEBUG(cl_neigh); DEBUG(cluster_weights);
+        DEBUG(edges_in_cl); DEBUG(nw_list);
+        for( int x : nw_list ){
+            clog << "******   cluster_cores[" << x << "]: ";
+            for( int d : cluster_cores[x].h ) clog << "(" << free_val[d] << "," << d << ") ";
+            clog << endl;
+        }
     };
 
     initialize();
@@ -142,7 +145,8 @@ ComponentExpansionAttraction::createSwapCandidates(Cluster& cl){
         clog << endl << "***************************  Proceeding to iterations  ***********" << endl;
     }
 
-    VI ord, swpvals;
+    ord.clear();
+    swpvals.clear();
     int total_swpval = 0;
 
 
@@ -156,39 +160,23 @@ ComponentExpansionAttraction::createSwapCandidates(Cluster& cl){
     while( S.size() < total_size ){
         if( debug ){ // just an assertion
             // checking whether swap values and equal to those of nw_d * sumNWinS + free_value
-            for( auto & zb : cluster_cores ){
-                for( PII p : zb ){
-                    int d = p.second;
-                    int free_val = p.first;
-                    assert( free_val == getFreeValue(d) );
-                }
-            }
+            for( int x : nw_list ) for( int d : cluster_cores[x].h ) assert( free_val[d] == getFreeValue(d) );
         }
 
         if(debug) clog << "---> NEXT ITERATION" << endl;
 
         int node_to_move = getNodeToMove();
-        if(debug){
-            DEBUG(node_to_move);
-//            DEBUG(getFreeValue(node_to_move));
-        }
+        if(debug) DEBUG(node_to_move);
 
-        int swpval = clg->node_weights[node_to_move] * sumNWinS + getFreeValue(node_to_move);
+        int swpval = clg->node_weights[node_to_move] * sumNWinS + free_val[node_to_move];
         if(debug) DEBUG(swpval);
 
         total_swpval += swpval;
         if(debug) DEBUG(total_swpval);
 
-        modifyNodeEntryInClusterCores(node_to_move,false);
-
-        if(debug){
-            clog << "After removing neighbors and cluster-mates of " << node_to_move << ":" << endl;
-            for( int c : cl_neigh ) clog << "******   cluster_cores[" << c << "]: " << endl << cluster_cores[c] << endl;
-        }
-
+        cluster_cores[ clg->node_weights[node_to_move] ].remove(node_to_move);
         moveNodeToS(node_to_move);
-
-        modifyNodeEntryInClusterCores(node_to_move,true);
+        updateClusterCores(node_to_move);
 
         {
             ord.push_back(node_to_move);
@@ -208,7 +196,7 @@ ComponentExpansionAttraction::createSwapCandidates(Cluster& cl){
 
     pair<ExpansionOrderAttraction*, vector<SwpCndEOAttraction> > res;
     {
-        ExpansionOrderAttraction *eoa = new ExpansionOrderAttraction(cl, ord);
+        ExpansionOrderAttraction *eoa = (arena != nullptr) ? arena->create(cl, ord) : new ExpansionOrderAttraction(cl, ord);
         res.first = eoa;
         res.second.reserve(ord.size());
         for (int i = 0; i < ord.size(); i++) {
@@ -222,11 +210,14 @@ ComponentExpansionAttraction::createSwapCandidates(Cluster& cl){
 
     { // clearing section
         sumNWinS = 0;
-        S.clear();
-        S.insert(ALL(cl.g.nodes));
-        for( auto & [nw,cnt] : node_neigh_weights ) set<PII>().swap(cluster_cores[nw]);
-        node_neigh_weights.clear();
-        for( int d : S ){
+        for( int x : nw_list ){
+            cluster_cores[x].clear();
+            nw_count[x] = 0;
+            nw_pos[x] = -1;
+        }
+        nw_list.clear();
+
+        for( int d : cl.g.nodes ){
             inS[d] = false;
             eToS[d] = 0;
         }
@@ -249,46 +240,36 @@ ComponentExpansionAttraction::createSwapCandidates(Cluster& cl){
     return res;
 }
 
-void ComponentExpansionAttraction::modifyNodeEntryInClusterCores( int node_to_move, bool insert ){
-    for( auto & [d,w] : clg->V[node_to_move] ){
-        int cl = st->inCl[d];
-
-        // if node d is in some cluster from cl_neigh and it is not in S nor in the same cluster as node_to_move,
-        // then it was not moved yet to S, so its 'free value' needs to be updated - inserted/erased into/from
-        // [cluster_cores]
-        if( was[cl] && !inS[d] && cl != st->inCl[node_to_move] ){
-            int nw_d = clg->node_weights[d];
-            int free_value = getFreeValue(d);
+void ComponentExpansionAttraction::addToClusterCores(int d) {
+    int nw_d = clg->node_weights[d];
+    free_val[d] = getFreeValue(d);
+    cluster_cores[nw_d].push(d);
 
-            if(insert){
-                cluster_cores[nw_d].insert( PII( free_value,d ) );
-            }
-            else{
-                cluster_cores[nw_d].erase( PII( free_value,d ) );
-            }
-        }
+    if( nw_count[nw_d]++ == 0 ){
+        nw_pos[nw_d] = nw_list.size();
+        nw_list.push_back(nw_d);
     }
+}
 
-    // for each node in the cluster that contains/contained node_to_move
-    for( int d : st->clusters[ st->inCl[node_to_move] ].g.nodes ){
-        if( d == node_to_move ) continue;
-        if( !inS[d] ){
-            int nw_d = clg->node_weights[d];
-            int free_value = getFreeValue(d);
+void ComponentExpansionAttraction::updateClusterCores( int moved ){
+    auto update = [&]( int d ){
+        free_val[d] = getFreeValue(d);
+        cluster_cores[ clg->node_weights[d] ].update(d);
+    };
 
-            if(insert){
-                cluster_cores[nw_d].insert( PII( free_value,d ) );
-            }
-            else{
-                cluster_cores[nw_d].erase( PII( free_value,d ) );
-            }
-        }
-    }
+    for( auto & [d,w] : clg->V[moved] ){
+        int cl = st->inCl[d];
 
-    if(!insert){ // removing node_to_move from cluster_cores
-        cluster_cores[ clg->node_weights[node_to_move] ].erase( PII( getFreeValue(node_to_move), node_to_move ) );
+        // if node d is in some cluster from cl_neigh and it is not in S nor in the same cluster as [moved],
+        // then it was not moved yet to S, so its 'free value' needs to be updated. Nodes in the same cluster are
+        // updated below.
+        if( was[cl] && !inS[d] && cl != st->inCl[moved] ) update(d);
     }
 
+    // for each node in the cluster that contains/contained [moved]
+    for( int d : st->clusters[ st->inCl[moved] ].g.nodes ){
+        if( !inS[d] ) update(d);
+    }
 }
 
 int ComponentExpansionAttraction::getNodeToMove() {
@@ -296,11 +277,9 @@ int ComponentExpansionAttraction::getNodeToMove() {
     int best_u = -1;
     int best_val = Constants::INF;
 
-    for( auto & [n_w,cnt] : node_neigh_weights ){
-        auto it = cluster_cores[n_w].begin();
-        int d = it->second;
-        int free_val = it->first;
-        int swpval = n_w * sumNWinS + free_val;
+    for( int n_w : nw_list ){
+        int d = cluster_cores[n_w].top();
+        int swpval = n_w * sumNWinS + free_val[d];
 
         if(debug){
             clog << "n_w: " << n_w << ", d: " << d << ", swpval: " << swpval << endl;
@@ -318,15 +297,18 @@ void ComponentExpansionAttraction::moveNodeToS(int u) {
     int nw_u = clg->node_weights[u];
     cluster_weights[ st->inCl[u] ] -= nw_u;
     sumNWinS += nw_u;
-    S.insert(u);
+    S.push_back(u);
     inS[u] = true;
 
-    { // modifying node_neigh_weights
-        auto it = node_neigh_weights.find(nw_u);
-        assert(it != node_neigh_weights.end());
-
-        it->second--;
-        if (it->second == 0) node_neigh_weights.erase(it);
+    { // modifying nw_count and nw_list
+        assert( nw_count[nw_u] > 0 );
+        if( --nw_count[nw_u] == 0 ){
+            int p = nw_pos[nw_u];
+            nw_list[p] = nw_list.back();
+            nw_pos[ nw_list[p] ] = p;
+            nw_list.pop_back();
+            nw_pos[nw_u] = -1;
+        }
     }
 
     for( auto & [d,w] : clg->V[u] ){
@@ -355,6 +337,3 @@ int ComponentExpansionAttraction::getFreeValue(int d) {
 
     return free_value;
 }
-
-
-
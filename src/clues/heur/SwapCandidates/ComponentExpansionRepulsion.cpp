@@ -65,15 +65,11 @@ ComponentExpansionRepulsion::ComponentExpansionRepulsion( State & st ){
 
     inS = VB(N,false);
     sumNWinS = 0;
-
-    was = was2 = was3 = VB(2*N,false);
+    entry_of = VI(N,-1);
 
     // we need to have more possible cluster to move to, since many nodes may be moved to 'new empty clusters'
     cluster_weights = VI(2*N ,0);
-
-    edges_to_cluster.resize( N );
-    cluster_sets.resize(N);
-    swpval_core_for_node.resize(N);
+    cl_local = VI(2*N, -1);
 }
 
 pair<vector<ExpansionOrderRepulsion *>, vector<SwpCndEORepulsion>> ComponentExpansionRepulsion::createSwapCandidates() {
@@ -100,54 +96,41 @@ ComponentExpansionRepulsion::createSwapCandidates(Cluster &cl) {
 
     assert( !cl.g.nodes.empty() );
 
-    // cl_neigh denotes the ids of clusters that are neighbors of cluster [cl]. [was] marks this property.
-    cl_neigh = VI(1, st->getIdOfEmptyCluster());
-    was[cl_neigh[0]] = true;
-
     auto debug_all = [&](){
         DEBUG(S); DEBUG(sumNWinS); DEBUG(eInS);
-        DEBUG(cl_neigh); DEBUG(cluster_weights); DEBUG(edges_to_cluster);
-        DEBUG(swpval_core_for_node);
-        clog << "Cluster sets: " << endl;
-        for( int i=0; i<cluster_sets.size(); i++ ){
-            if( !cluster_sets[i].empty() ) clog << "cluster_sets[" << i << "]: " << cluster_sets[i] << endl;
+        DEBUG(cl_neigh); DEBUG(cluster_weights);
+        clog << "Entries (v,c,E,core): " << endl;
+        for( int u : S ){
+            clog << "node " << u << ":";
+            for( int e : heaps[ st->idInCl[u] ].h ) clog << " (" << u << "," << ent_cl[e] << "," << ent_E[e] << ","
+                                                          << ent_core[e] << ")";
+            clog << endl;
         }
     };
 
-    if(debug) debug_all();
-
     if(st->cl_neigh_graph.empty()) st->createClNeighGraph();
 
+    // cl_neigh denotes the ids of clusters that are neighbors of cluster [cl]. [cl_local] marks this property.
+    addNeighborCluster( st->getIdOfEmptyCluster() );
+
+    while( heaps.size() < cl.size() ) heaps.emplace_back( &ent_pos, EntryCmp{this} );
+
     { // initializing some
         sumNWinS = cl.cluster_weight;
 
-        S.insert(ALL(cl.g.nodes));
-        for( int d : S ){
-            inS[d] = true;
-            eInS[d] = st->degInCl[d];
-        }
-
         // S, inS, sumEW, cluster_weights, eInS
         // should be already cleared - clearing at the end of each call to createSwapCandidates
-
         for( int d : cl.g.nodes ){
-            edges_to_cluster[d].insert(ALL(st->cl_neigh_graph[d]));
-            for( auto & [c,w] : st->cl_neigh_graph[d] ){
-                if(!was[c]){
-                    was[c] = true; // [was] marks cluster neighbors of nodes from [cl]
-                    cl_neigh.push_back(c);
-                }
-            }
+            S.push_back(d);
+            inS[d] = true;
+            eInS[d] = st->degInCl[d];
+            for( auto & [c,w] : st->cl_neigh_graph[d] ) addNeighborCluster(c);
         }
-        for( int c : cl_neigh ) cluster_weights[c] = st->clusters[c].cluster_weight;
-
-        if(debug) debug_all();
 
         for( int d : S ){
-            updateSwpValCoreForNode(d, st->getIdOfEmptyCluster());
-            for( auto [c,w] : st->cl_neigh_graph[d] ){
-                updateSwpValCoreForNode(d, c);
-            }
+            auto & heap = heaps[ st->idInCl[d] ];
+            heap.push( addEntry( d, st->getIdOfEmptyCluster(), 0 ) );
+            for( auto & [c,w] : st->cl_neigh_graph[d] ) heap.push( addEntry(d,c,w) );
         }
     }
 
@@ -162,9 +145,10 @@ ComponentExpansionRepulsion::createSwapCandidates(Cluster &cl) {
     while( !S.empty() ){
         if(debug) clog << endl << "NEXT ITERATION" << endl;
 
-        PII choice = getNodeToMove();
-        int node_to_move = choice.first;
-        int to = choice.second;
+        int e = getNodeToMove();
+        int node_to_move = ent_node[e];
+        int to = ent_cl[e];
+        int Ec = ent_E[e];
 
         if( to == st->getIdOfEmptyCluster() ){
             // if a node should be moved to an empty cluster, a new one is created instead and node is moved to the new one
@@ -174,30 +158,29 @@ ComponentExpansionRepulsion::createSwapCandidates(Cluster &cl) {
                     << first_left_empty_cluster << " instead" << endl;
             }
 
-            assert( !was[first_left_empty_cluster] );
-            was[first_left_empty_cluster] = true;
-            cl_neigh.push_back(first_left_empty_cluster);
+            assert( cl_local[first_left_empty_cluster] == -1 );
+            addNeighborCluster(first_left_empty_cluster);
             to = first_left_empty_cluster;
+            Ec = 0;
 
             first_left_empty_cluster++;
         }
 
-        swpval += calculateSwpVal(node_to_move, to);
+        int val = calculateSwpVal(node_to_move, to, Ec);
+        swpval += val;
         swpvals.push_back(swpval);
 
         ord.push_back(node_to_move);
 
         if(debug){
-            clog << "Moving node " << node_to_move << " to cluster " << to << " with swpval " << calculateSwpVal(
-                    node_to_move, to)
+            clog << "Moving node " << node_to_move << " to cluster " << to << " with swpval " << val
                  << ". Total swpval: " << swpval << endl;
         }
 
         move_to.push_back(to);
 
         moveNodeTo( node_to_move, to );
-        if(debug) debug_all();
-        for( int u : S ) updateSwpValCoreForNode(u, to);
+        updateSwpValCores(to);
 
         if(debug){
             debug_all();
@@ -207,7 +190,8 @@ ComponentExpansionRepulsion::createSwapCandidates(Cluster &cl) {
 
     pair<ExpansionOrderRepulsion*, vector<SwpCndEORepulsion> > res;
     { // creating expansion order and swap candidates
-        ExpansionOrderRepulsion* eor = new ExpansionOrderRepulsion( cl, ord, move_to );
+        ExpansionOrderRepulsion* eor = (arena != nullptr) ? arena->create( cl, ord, move_to )
+                                                          : new ExpansionOrderRepulsion( cl, ord, move_to );
         res.first = eor;
         assert( ord.size() == swpvals.size() );
         assert( ord.size() == move_to.size() );
@@ -237,18 +221,18 @@ ComponentExpansionRepulsion::createSwapCandidates(Cluster &cl) {
 
     assert(S.empty());
 
-    S.insert(ALL(cl.g.nodes));
     { // clearing section
-        for (int c : cl_neigh) was[c] = false;
-        for (int d : S){
-            eInS[d] = 0;
-            inS[d] = false;
-            unordered_map<int,int>().swap(edges_to_cluster[d]); // clearing edges_to_cluster
-            unordered_map<int,int>().swap(swpval_core_for_node[d]); // clearing edges_to_cluster
-            set<ClusterSet>().swap(cluster_sets[d]); // clearing edges_to_cluster
+        for( int i=0; i<cl_neigh.size(); i++ ){
+            int c = cl_neigh[i];
+            cl_local[c] = -1;
+            cluster_weights[c] = 0;
+            cl_entries[i].clear();
         }
-        for( int c : cl_neigh ) cluster_weights[c] = 0;
-        S.clear();
+        ent_node.clear();
+        ent_cl.clear();
+        ent_E.clear();
+        ent_core.clear();
+        ent_pos.clear();
         sumNWinS = 0;
         cl_neigh.clear();
     }
@@ -256,31 +240,49 @@ ComponentExpansionRepulsion::createSwapCandidates(Cluster &cl) {
     return res;
 }
 
-PII ComponentExpansionRepulsion::getNodeToMove() {
+void ComponentExpansionRepulsion::addNeighborCluster(int c) {
+    if( cl_local[c] != -1 ) return;
+    cl_local[c] = cl_neigh.size();
+    cl_neigh.push_back(c);
+    if( cl_entries.size() < cl_neigh.size() ) cl_entries.emplace_back();
+    cluster_weights[c] = ( c < st->clusters.size() ) ? st->clusters[c].cluster_weight : 0;
+}
+
+int ComponentExpansionRepulsion::addEntry(int u, int c, int E) {
+    int e = ent_node.size();
+    ent_node.push_back(u);
+    ent_cl.push_back(c);
+    ent_E.push_back(E);
+    ent_core.push_back( clg->node_weights[u] * cluster_weights[c] - (E << 1) );
+    ent_pos.push_back(-1);
+    cl_entries[ cl_local[c] ].push_back(e);
+    return e;
+}
+
+int ComponentExpansionRepulsion::getNodeToMove() {
     const bool debug = false;
     int best_swpval = 1e9;
-    int best_v = -1, best_c = -1;
-    for( int u : S ){
-        int c = cluster_sets[u].begin()->c;
-
-        int val = calculateSwpVal(u, c);
+    int best_e = -1;
+    for( int i=(int)S.size()-1; i>=0; i-- ){ // in case of ties, nodes later in cl->g.nodes are preferred
+        int u = S[i];
+        int e = heaps[ st->idInCl[u] ].top();
+        int val = calculateSwpVal(u, ent_cl[e], ent_E[e]);
 
         if(debug){
-            clog << "Best choice for node u: " << u << ": (cluster " << c << ", core: " << swpval_core_for_node[u][c]
+            clog << "Best choice for node u: " << u << ": (cluster " << ent_cl[e] << ", core: " << ent_core[e]
                  << ", swpval: " << val << ")" << endl;
         }
 
         if(val < best_swpval){
             best_swpval = val;
-            best_v = u;
-            best_c = c;
+            best_e = e;
         }
     }
 
     if(debug) clog << endl;
 
-    assert(best_c != -1);
-    return { best_v, best_c };
+    assert(best_e != -1);
+    return best_e;
 }
 
 
@@ -288,76 +290,48 @@ void ComponentExpansionRepulsion::moveNodeTo(int v, int c) {
     cluster_weights[c] += clg->node_weights[v];
     sumNWinS -= clg->node_weights[v];
     inS[v] = false;
-    S.erase(v);
-//    for( auto [d,w] : cl->g.V[v] ){ // old buggy version
-    for( auto [d,w] : cl->g.V[ st->idInCl[v] ] ){ // new, probably correct version
+
+    S.erase( find( ALL(S), v ) ); // O(S), the same as updating cores of all nodes in S, but keeps the order of nodes
+
+    heaps[ st->idInCl[v] ].clear(); // we do not need entries of v anymore
+    eInS[v] = 0; // we can clear that now, it will not be needed anymore
+
+    for( int e : cl_entries[ cl_local[c] ] ) if( inS[ ent_node[e] ] ) entry_of[ ent_node[e] ] = e;
+
+    for( auto [d,w] : cl->g.V[ st->idInCl[v] ] ){
         d = cl->g.nodes[d];
         if( inS[d] ){
             eInS[d] -= w;
-            edges_to_cluster[d][c] += w;
+            if( entry_of[d] == -1 ) entry_of[d] = addEntry(d,c,0);
+            ent_E[ entry_of[d] ] += w;
         }
     }
-
-    eInS[v] = 0; // we can clear that now, it will not be needed anymore
-    edges_to_cluster[v].clear(); // we do not need that either
-    swpval_core_for_node[v].clear(); // we do not need that either
-    cluster_sets[v].clear();  // we do not need that either
 }
 
-
-void ComponentExpansionRepulsion::updateSwpValCoreForNode(int u, int c) {
-    const bool debug = false;
-    if(debug){
-        clog << "u: " << u << ", c: " << c << endl;
-        clog << "Before update, swpval_core_for_node[u][c]: " << swpval_core_for_node[u][c] << endl;
-    }
-
-    if(debug){
-        clog << "erasing (u,c) from cluster_sets[u]:" << cluster_sets[u] << endl;
-    }
-    cluster_sets[u].erase( ClusterSet( this,u,c ) );
-
-
-    if(debug) clog << "after erasing  cluster_sets[u]:" << cluster_sets[u] << endl;
-
-    int nw_u = clg->node_weights[u];
-    int Ec = edges_to_cluster[u][c];
+void ComponentExpansionRepulsion::updateSwpValCores(int c) {
     int cl_weight = cluster_weights[c];
-    int core_value = nw_u * cl_weight - (Ec << 1);
-
-    if(debug) clog << "core_value: " << core_value << endl;
 
-    swpval_core_for_node[u][c] = core_value;
+    for( int u : S ){
+        int e = entry_of[u];
+        if( e == -1 ) e = addEntry(u,c,0);
+        entry_of[u] = -1;
 
-    cluster_sets[u].insert(ClusterSet( this,u,c ));
+        ent_core[e] = clg->node_weights[u] * cl_weight - ( ent_E[e] << 1 );
 
-    if(debug){
-        clog << "After update, swpval_core_for_node[u][c]: " << swpval_core_for_node[u][c] << " and calculateSwpVal: "
-             << calculateSwpVal(u, c) << endl;
+        auto & heap = heaps[ st->idInCl[u] ];
+        if( heap.contains(e) ) heap.update(e);
+        else heap.push(e);
     }
 }
 
-int ComponentExpansionRepulsion::calculateSwpVal(int u, int c) {
-    const bool debug = false;
-
+int ComponentExpansionRepulsion::calculateSwpVal(int u, int c, int Ec) {
     int nw_u = clg->node_weights[u];
     int nw_S = sumNWinS;
     int eu = eInS[u];
-    auto it = edges_to_cluster[u].find(c);
-    int Ec = ( (it == edges_to_cluster[u].end()) ? 0 : it->second  );
     int cl_weight = cluster_weights[c];
 
     int before = nw_u * ( nw_S - nw_u ) - eu + Ec;
     int after = nw_u * cl_weight - Ec + eu;
 
-    if(debug) clog << " (bef:" << before <<",aft:" << after << ") ";
-    int swpval = after - before;
-
-    return swpval;
+    return after - before;
 }
-
-ostream& operator<<(ostream& str, ComponentExpansionRepulsion::ClusterSet& cs){
-    str << "(v,c,core): " << "(" << cs.v << "," << cs.c << ","
-         << cs.cer->swpval_core_for_node[cs.v][cs.c] << ")";
-    return str;
-}
\ No newline at end of file
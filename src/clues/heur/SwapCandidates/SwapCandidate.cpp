@@ -59,13 +59,12 @@ void SwapCandidate::test() {
     clog << "SwapCandidate getAffectedClusters test passed" << endl;
 }
 
-SwapCandidateCreatorAdapter::SwapCandidateCreatorAdapter(State &s) {
+SwapCandidateCreatorAdapter::SwapCandidateCreatorAdapter(State &s, Workspace & ws) :
+        ws(&ws), edges_to_cluster(ws.edges_to_cluster), was(ws.was), was2(ws.was2), was3(ws.was3) {
     state = &s;
     clg = state->clg;
-    edges_to_cluster = VI(state->clusters.size()+1, 0);
-    was = VB(2*s.N,false);
-    was2 = VB(2*s.N,false);
-    was3 = VB(2*s.N,false);
+    // no allocation if helper arrays are large enough, the used prefix is cleared (see Workspace)
+    ws.reserve( max( s.N, (int)state->clusters.size() ), true );
 }
 
 void SwapCandidateCreatorAdapter::updateEdgesInNeighboringClustersForNode(int d, int in_cl_d, VI &neigh) {
@@ -37,7 +37,7 @@ LL SwpCndEO::swpVal() {
 
 //*********************************   SwpCndEOCreator   *************************************
 
-SwpCndEOCreator::SwpCndEOCreator(State & s) : SwapCandidateCreatorAdapter(s) {
+SwpCndEOCreator::SwpCndEOCreator(State & s, Workspace & ws) : SwapCandidateCreatorAdapter(s, ws) {
 //    min_b_coef_for_cluster_size = VI(clg->N+1,0);
     min_b_coef_for_cluster_size = VI(clg->origV->size()+1,0); // weights of clusters
     createHashes();
@@ -218,17 +218,41 @@ vector<SwpCndEO> SwpCndEOCreator::createSwapCandidates(vector<ExpansionOrder*> &
 }
 
 vector<ExpansionOrder> SwpCndEOCreator::createExpansionOrders( function<VVI(Cluster*)> fun ) {
-    vector<ExpansionOrder> orders;
+    int C = state->clusters.size();
+
+    VI seeds(C);
+    {
+        UniformIntGenerator rnd(0, 1'000'000'000);
+        for( int i=0; i<C; i++ ) seeds[i] = rnd.rand();
+    }
+
+    VI to_process; // ids of nonempty clusters
+    for( int i=0; i<C; i++ ) if( state->clusters[i].size() > 0 ) to_process.push_back(i); // do not process empty cluster
+
+    if( pool != nullptr ){
+        // Creating an order for a cluster of size s takes O(s^2) time per initial set, and cluster sizes are very
+        // skewed. Largest clusters are processed first, then smaller ones fill up the gaps
+        stable_sort( ALL(to_process), [&]( int a, int b ){
+            return state->clusters[a].size() > state->clusters[b].size();
+        } );
+    }
 
-    UniformIntGenerator rnd(0,100);
+    vector<vector<ExpansionOrder>> cl_orders(C);
+    vector<ComponentExpansion> ces( pool == nullptr ? 1 : pool->size() );
 
-    for( auto & cl : state->clusters ){
-        if( cl.size() == 0 ) continue; // do not process empty cluster
+    auto processCluster = [&]( int i, int thread_id ){
+        if(Global::checkTle()) return;
+
+        Cluster & cl = state->clusters[ to_process[i] ];
+        UniformIntGenerator::lastSeed = seeds[ to_process[i] ]; // [fun] may use generators with default seed
         VVI sets = fun(&cl);
-        ComponentExpansion ce( cl );
 
+        ComponentExpansion & ce = ces[thread_id];
+        ce.setCluster(cl);
+
+        UniformIntGenerator rnd(0,100);
         for( auto & A : sets ){
-            if(Global::checkTle()) return orders;
+            if(Global::checkTle()) return;
 
 //            int cnt = 0; // original version
             int cnt = rnd.nextInt(5); // #TEST - checking different expansion orders cmp rules
@@ -241,10 +265,15 @@ vector<ExpansionOrder> SwpCndEOCreator::createExpansionOrders( function<VVI(Clus
             else if(cnt == 4) ce.setCmpRules( VI({ 1,2,10 }) );
 
             auto ord = ce.getExpansionOrder(A,false); // do not use heap - we use CE for cluster
-            orders.push_back(ord);
+            cl_orders[ to_process[i] ].push_back(ord);
         }
-    }
+    };
 
+    if( pool == nullptr ) for( int i=0; i<to_process.size(); i++ ) processCluster(i,0);
+    else pool->parallelForWithThreadId( to_process.size(), processCluster );
+
+    vector<ExpansionOrder> orders;
+    for( auto & v : cl_orders ) for( auto & ord : v ) orders.push_back( move(ord) );
 
     return orders;
 }
@@ -8,7 +8,7 @@
 #include "clues/heur/SwapCandidates/SwpCndEdge.h"
 #include "CollectionOperators.h"
 
-SwpCndEdgeCreator::SwpCndEdgeCreator(State &s) : SwapCandidateCreatorAdapter(s) {}
+SwpCndEdgeCreator::SwpCndEdgeCreator(State & s, Workspace & ws) : SwapCandidateCreatorAdapter(s, ws) {}
 
 SwpCndEdge::SwpCndEdge( int swpval, int u, int v, int trg_cl ){
     swap_value = swpval;
@@ -84,7 +84,7 @@ ostream& operator<<(ostream& str, SwpCndNode& cnd){
     return str;
 }
 
-SwpCndNodeCreator::SwpCndNodeCreator(State &s) : SwapCandidateCreatorAdapter(s) {}
+SwpCndNodeCreator::SwpCndNodeCreator(State & s, Workspace & ws) : SwapCandidateCreatorAdapter(s, ws) {}
 
 SwpCndNode::SwpCndNode(int swpval, int v, int trg_cl) {
     swap_value = swpval;
@@ -14,7 +14,7 @@ SwpCndTriangle::SwpCndTriangle( int swpval, int u, int v, int w, int trg_cl ){
     move_node_to = {trg_cl, trg_cl, trg_cl};
 }
 
-SwpCndTriangleCreator::SwpCndTriangleCreator(State &s) : SwapCandidateCreatorAdapter(s) {}
+SwpCndTriangleCreator::SwpCndTriangleCreator(State & s, Workspace & ws) : SwapCandidateCreatorAdapter(s, ws) {}
 
 vector<SwpCndTriangle> SwpCndTriangleCreator::createSwapCandidates() {
     return vector<SwpCndTriangle>();
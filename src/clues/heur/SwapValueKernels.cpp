@@ -0,0 +1,287 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#include "clues/heur/SwapValueKernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SWAP_VALUE_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace SwapValueKernels{
+
+    SimdLevel detectedSimdLevel(){
+        static const SimdLevel level = [](){
+#ifdef SWAP_VALUE_KERNELS_X86
+            __builtin_cpu_init();
+            if( __builtin_cpu_supports("avx2") ) return AVX2;
+            if( __builtin_cpu_supports("sse4.1") ) return SSE41;
+#endif
+            return SCALAR;
+        }();
+        return level;
+    }
+
+    SimdLevel simd_level = detectedSimdLevel();
+
+    int argminMoveValue( const int* edge_w, const int* cl_w, int n, int nw, int & min_val ){
+        if( n >= MIN_SIMD_SIZE ){
+            if( simd_level == AVX2 ) return argminMoveValueAVX2( edge_w, cl_w, n, nw, min_val );
+            if( simd_level == SSE41 ) return argminMoveValueSSE41( edge_w, cl_w, n, nw, min_val );
+        }
+        return argminMoveValueScalar( edge_w, cl_w, n, nw, min_val );
+    }
+
+    /**
+     * Scalar loop over elements [from, n). Updates [best] and [min_val] only if a strictly smaller value is found.
+     */
+    static void scanTail( const int* edge_w, const int* cl_w, int from, int n, int nw, int & best, int & min_val ){
+        for( int i=from; i<n; i++ ){
+            int val = nw * cl_w[i] - 2 * edge_w[i];
+            if( best == -1 || val < min_val ){
+                min_val = val;
+                best = i;
+            }
+        }
+    }
+
+    int argminMoveValueScalar( const int* edge_w, const int* cl_w, int n, int nw, int & min_val ){
+        int best = -1;
+        scanTail( edge_w, cl_w, 0, n, nw, best, min_val );
+        return best;
+    }
+
+    int argminMoveValuePairs( const PII* items, int n, const int* cluster_weights, int skip_id, int nw, int & min_val ){
+        if( n >= MIN_SIMD_SIZE ){
+            if( simd_level == AVX2 ) return argminMoveValuePairsAVX2( items, n, cluster_weights, skip_id, nw, min_val );
+            if( simd_level == SSE41 ) return argminMoveValuePairsSSE41( items, n, cluster_weights, skip_id, nw, min_val );
+        }
+        return argminMoveValuePairsScalar( items, n, cluster_weights, skip_id, nw, min_val );
+    }
+
+    static void scanPairsTail( const PII* items, int from, int n, const int* cluster_weights, int skip_id, int nw,
+                               int & best, int & min_val ){
+        for( int i=from; i<n; i++ ){
+            if( items[i].first == skip_id ) continue;
+            int val = nw * cluster_weights[ items[i].first ] - 2 * items[i].second;
+            if( best == -1 || val < min_val ){
+                min_val = val;
+                best = i;
+            }
+        }
+    }
+
+    int argminMoveValuePairsScalar( const PII* items, int n, const int* cluster_weights, int skip_id, int nw,
+                                    int & min_val ){
+        int best = -1;
+        scanPairsTail( items, 0, n, cluster_weights, skip_id, nw, best, min_val );
+        return best;
+    }
+
+#ifdef SWAP_VALUE_KERNELS_X86
+
+    /**
+     * Each lane keeps the minimal value and the first index at which it occurred. Lanes are reduced at the end - the
+     * smallest index among lanes with minimal value is the first index overall.
+     */
+    static int reduceLanes( const int* vals, const int* inds, int lanes, int & min_val ){
+        int best = -1;
+        for( int l=0; l<lanes; l++ ){
+            if( best == -1 || vals[l] < min_val || ( vals[l] == min_val && inds[l] < best ) ){
+                min_val = vals[l];
+                best = inds[l];
+            }
+        }
+        return best;
+    }
+
+    /**
+     * @return values nw * cl_w[j] - 2 * edge_w[j] for j in [i,i+4)
+     */
+    __attribute__((target("sse4.1")))
+    static inline __m128i moveValues4( const int* edge_w, const int* cl_w, int i, __m128i vnw ){
+        __m128i e = _mm_loadu_si128( (const __m128i*)(edge_w + i) );
+        __m128i w = _mm_loadu_si128( (const __m128i*)(cl_w + i) );
+        return _mm_sub_epi32( _mm_mullo_epi32(vnw, w), _mm_slli_epi32(e, 1) );
+    }
+
+    /**
+     * Lanes of skipped clusters get value INT_MAX and index INT_MAX, so they are never chosen in [reduceLanes], unless
+     * all lanes are skipped - then the returned index is INT_MAX.
+     */
+    static int reducePairLanes( const int* vals, const int* inds, int lanes, int & min_val ){
+        int best = reduceLanes( vals, inds, lanes, min_val );
+        return best == numeric_limits<int>::max() ? -1 : best;
+    }
+
+    __attribute__((target("sse4.1")))
+    int argminMoveValuePairsSSE41( const PII* items, int n, const int* cluster_weights, int skip_id, int nw,
+                                   int & min_val ){
+        static_assert( sizeof(PII) == 2*sizeof(int), "pairs must be packed" );
+        const int* p = (const int*)items;
+
+        const __m128i vnw = _mm_set1_epi32(nw);
+        const __m128i vskip = _mm_set1_epi32(skip_id);
+        const __m128i vmax = _mm_set1_epi32( numeric_limits<int>::max() );
+        const __m128i step = _mm_set1_epi32(4);
+        __m128i ind = _mm_setr_epi32(0,1,2,3);
+        __m128i best_val = vmax, best_ind = vmax;
+
+        int i = 0;
+        for( ; i+4 <= n; i += 4 ){
+            __m128 a = _mm_castsi128_ps( _mm_loadu_si128( (const __m128i*)(p + 2*i) ) ); // k0 v0 k1 v1
+            __m128 b = _mm_castsi128_ps( _mm_loadu_si128( (const __m128i*)(p + 2*i + 4) ) ); // k2 v2 k3 v3
+            __m128i keys = _mm_castps_si128( _mm_shuffle_ps( a, b, _MM_SHUFFLE(2,0,2,0) ) );
+            __m128i e = _mm_castps_si128( _mm_shuffle_ps( a, b, _MM_SHUFFLE(3,1,3,1) ) );
+            __m128i w = _mm_setr_epi32( cluster_weights[ items[i].first ], cluster_weights[ items[i+1].first ],
+                                        cluster_weights[ items[i+2].first ], cluster_weights[ items[i+3].first ] );
+
+            __m128i val = _mm_sub_epi32( _mm_mullo_epi32(vnw, w), _mm_slli_epi32(e, 1) );
+            __m128i valid = _mm_andnot_si128( _mm_cmpeq_epi32(keys, vskip), _mm_set1_epi32(-1) );
+            __m128i better = _mm_and_si128( valid, _mm_or_si128( _mm_cmplt_epi32(val, best_val),
+                                                                 _mm_cmpeq_epi32(best_ind, vmax) ) );
+            best_val = _mm_blendv_epi8( best_val, val, better );
+            best_ind = _mm_blendv_epi8( best_ind, ind, better );
+            ind = _mm_add_epi32( ind, step );
+        }
+
+        alignas(16) int vals[4], inds[4];
+        _mm_store_si128( (__m128i*)vals, best_val );
+        _mm_store_si128( (__m128i*)inds, best_ind );
+
+        int best = reducePairLanes( vals, inds, 4, min_val );
+        scanPairsTail( items, i, n, cluster_weights, skip_id, nw, best, min_val );
+        return best;
+    }
+
+    __attribute__((target("avx2")))
+    int argminMoveValuePairsAVX2( const PII* items, int n, const int* cluster_weights, int skip_id, int nw,
+                                  int & min_val ){
+        static_assert( sizeof(PII) == 2*sizeof(int), "pairs must be packed" );
+        const int* p = (const int*)items;
+
+        const __m256i vnw = _mm256_set1_epi32(nw);
+        const __m256i vskip = _mm256_set1_epi32(skip_id);
+        const __m256i vmax = _mm256_set1_epi32( numeric_limits<int>::max() );
+        const __m256i step = _mm256_set1_epi32(8);
+        const __m256i deinterleave = _mm256_setr_epi32(0,2,4,6,1,3,5,7);
+        __m256i ind = _mm256_setr_epi32(0,1,2,3,4,5,6,7);
+        __m256i best_val = vmax, best_ind = vmax;
+
+        int i = 0;
+        for( ; i+8 <= n; i += 8 ){
+            // a = k0 k1 k2 k3 v0 v1 v2 v3,  b = k4 k5 k6 k7 v4 v5 v6 v7
+            __m256i a = _mm256_permutevar8x32_epi32( _mm256_loadu_si256( (const __m256i*)(p + 2*i) ), deinterleave );
+            __m256i b = _mm256_permutevar8x32_epi32( _mm256_loadu_si256( (const __m256i*)(p + 2*i + 8) ), deinterleave );
+            __m256i keys = _mm256_permute2x128_si256( a, b, 0x20 );
+            __m256i e = _mm256_permute2x128_si256( a, b, 0x31 );
+            __m256i w = _mm256_i32gather_epi32( cluster_weights, keys, 4 );
+
+            __m256i val = _mm256_sub_epi32( _mm256_mullo_epi32(vnw, w), _mm256_slli_epi32(e, 1) );
+            __m256i skipped = _mm256_cmpeq_epi32( keys, vskip );
+            __m256i better = _mm256_andnot_si256( skipped, _mm256_or_si256( _mm256_cmpgt_epi32(best_val, val),
+                                                                           _mm256_cmpeq_epi32(best_ind, vmax) ) );
+            best_val = _mm256_blendv_epi8( best_val, val, better );
+            best_ind = _mm256_blendv_epi8( best_ind, ind, better );
+            ind = _mm256_add_epi32( ind, step );
+        }
+
+        alignas(32) int vals[8], inds[8];
+        _mm256_store_si256( (__m256i*)vals, best_val );
+        _mm256_store_si256( (__m256i*)inds, best_ind );
+
+        int best = reducePairLanes( vals, inds, 8, min_val );
+        scanPairsTail( items, i, n, cluster_weights, skip_id, nw, best, min_val );
+        return best;
+    }
+
+    __attribute__((target("sse4.1")))
+    int argminMoveValueSSE41( const int* edge_w, const int* cl_w, int n, int nw, int & min_val ){
+        if( n < 4 ) return argminMoveValueScalar( edge_w, cl_w, n, nw, min_val );
+
+        const __m128i vnw = _mm_set1_epi32(nw);
+        const __m128i step = _mm_set1_epi32(4);
+        __m128i best_ind = _mm_setr_epi32(0,1,2,3);
+        __m128i best_val = moveValues4( edge_w, cl_w, 0, vnw );
+        __m128i ind = _mm_add_epi32( best_ind, step );
+
+        int i = 4;
+        for( ; i+4 <= n; i += 4 ){
+            __m128i val = moveValues4( edge_w, cl_w, i, vnw );
+            __m128i better = _mm_cmplt_epi32( val, best_val );
+            best_val = _mm_blendv_epi8( best_val, val, better );
+            best_ind = _mm_blendv_epi8( best_ind, ind, better );
+            ind = _mm_add_epi32( ind, step );
+        }
+
+        alignas(16) int vals[4], inds[4];
+        _mm_store_si128( (__m128i*)vals, best_val );
+        _mm_store_si128( (__m128i*)inds, best_ind );
+
+        int best = reduceLanes( vals, inds, 4, min_val );
+        scanTail( edge_w, cl_w, i, n, nw, best, min_val );
+        return best;
+    }
+
+    /**
+     * @return values nw * cl_w[j] - 2 * edge_w[j] for j in [i,i+8)
+     */
+    __attribute__((target("avx2")))
+    static inline __m256i moveValues8( const int* edge_w, const int* cl_w, int i, __m256i vnw ){
+        __m256i e = _mm256_loadu_si256( (const __m256i*)(edge_w + i) );
+        __m256i w = _mm256_loadu_si256( (const __m256i*)(cl_w + i) );
+        return _mm256_sub_epi32( _mm256_mullo_epi32(vnw, w), _mm256_slli_epi32(e, 1) );
+    }
+
+    __attribute__((target("avx2")))
+    int argminMoveValueAVX2( const int* edge_w, const int* cl_w, int n, int nw, int & min_val ){
+        if( n < 8 ) return argminMoveValueScalar( edge_w, cl_w, n, nw, min_val );
+
+        const __m256i vnw = _mm256_set1_epi32(nw);
+        const __m256i step = _mm256_set1_epi32(8);
+        __m256i best_ind = _mm256_setr_epi32(0,1,2,3,4,5,6,7);
+        __m256i best_val = moveValues8( edge_w, cl_w, 0, vnw );
+        __m256i ind = _mm256_add_epi32( best_ind, step );
+
+        int i = 8;
+        for( ; i+8 <= n; i += 8 ){
+            __m256i val = moveValues8( edge_w, cl_w, i, vnw );
+            __m256i better = _mm256_cmpgt_epi32( best_val, val );
+            best_val = _mm256_blendv_epi8( best_val, val, better );
+            best_ind = _mm256_blendv_epi8( best_ind, ind, better );
+            ind = _mm256_add_epi32( ind, step );
+        }
+
+        alignas(32) int vals[8], inds[8];
+        _mm256_store_si256( (__m256i*)vals, best_val );
+        _mm256_store_si256( (__m256i*)inds, best_ind );
+
+        int best = reduceLanes( vals, inds, 8, min_val );
+        scanTail( edge_w, cl_w, i, n, nw, best, min_val );
+        return best;
+    }
+
+#else
+
+    int argminMoveValuePairsSSE41( const PII* items, int n, const int* cluster_weights, int skip_id, int nw,
+                                   int & min_val ){
+        return argminMoveValuePairsScalar( items, n, cluster_weights, skip_id, nw, min_val );
+    }
+
+    int argminMoveValuePairsAVX2( const PII* items, int n, const int* cluster_weights, int skip_id, int nw,
+                                  int & min_val ){
+        return argminMoveValuePairsScalar( items, n, cluster_weights, skip_id, nw, min_val );
+    }
+
+    int argminMoveValueSSE41( const int* edge_w, const int* cl_w, int n, int nw, int & min_val ){
+        return argminMoveValueScalar( edge_w, cl_w, n, nw, min_val );
+    }
+
+    int argminMoveValueAVX2( const int* edge_w, const int* cl_w, int n, int nw, int & min_val ){
+        return argminMoveValueScalar( edge_w, cl_w, n, nw, min_val );
+    }
+
+#endif
+
+}
@@ -0,0 +1,28 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#include "clues/heur/Workspace.h"
+
+void Workspace::reserve(int N, bool clear) {
+    int S = 2*N;
+
+    auto prepare = [&]( auto & v, auto val ){
+        if( v.size() < S ) v.resize(S, val);
+        if(clear) fill( v.begin(), v.begin() + S, val ); // arrays may be much larger, only the used prefix is cleared
+    };
+
+    prepare(induce_helper, -1);
+    prepare(was, false); prepare(was2, false); prepare(was3, false);
+    prepare(marker, 0);
+    prepare(edges_to_cluster, 0);
+    prepare(helper, 0); prepare(helper2, 0);
+    prepare(helper_was, false); prepare(helper_was2, false); prepare(helper_was3, false);
+
+    if( clear && !int_map.empty() ) int_map.clear(); // clear() takes time proportional to the number of buckets
+}
+
+Workspace &Workspace::local() {
+    static thread_local Workspace ws;
+    return ws;
+}
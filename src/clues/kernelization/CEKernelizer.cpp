@@ -29,6 +29,17 @@ CEKernelizer::CEKernelizer(VVI &V, unsigned seed) :
     inV = VB(N,true);
 
     helper1 = VB(N,false);
+    helper2 = helper3 = helper4 = VB(N,false);
+    helper_int = VI(N,0);
+    cc_of_node = VI(N,-1);
+    affected_stamp = visit_stamp = VI(N,0);
+    is_changed = VB(N,false);
+    nbh_stamp = VI(N,0);
+
+    closed_hashes = HashBuckets(N);
+    for( int i=0; i<N; i++ ) closed_hashes.set( i, closedNeighborhoodHash(i) );
+    pending = VVI(LOCAL_RULES_CNT);
+    is_pending = vector<VB>(LOCAL_RULES_CNT, VB(N,false));
     ruleAppliedCnt = VI(MAX_RULES+MAX_HEUR_RULES+2,0);
     disabled_rules = VB(MAX_RULES+1,false);
     disabled_heur_rules = VB(MAX_HEUR_RULES+1,false);
@@ -43,40 +54,117 @@ void CEKernelizer::createHashes() {
 }
 
 void CEKernelizer::markInClVector() {
+    if( defer_in_cl_update ) return;
     for(int i=0; i<N; i++) inCl[i] = fau.Find(i);
 }
 
+LL CEKernelizer::closedNeighborhoodHash(int v) {
+    LL h = hashes[v];
+    for( int w : V[v] ) h ^= hashes[w];
+    return h;
+}
+
+void CEKernelizer::markChanged(int v) {
+    if( is_changed[v] ) return;
+    is_changed[v] = true;
+    changed_nodes.push_back(v);
+}
+
+void CEKernelizer::removeEdgesFromGraph(VPII &edges) {
+    for( auto [a,b] : edges ){
+        markChanged(a);
+        markChanged(b);
+        closed_hashes.toggle( a, hashes[b] );
+        closed_hashes.toggle( b, hashes[a] );
+    }
+    GraphUtils::removeEdges( V, edges );
+}
+
+void CEKernelizer::addEdgeToGraph(int a, int b) {
+    markChanged(a);
+    markChanged(b);
+    closed_hashes.toggle( a, hashes[b] );
+    closed_hashes.toggle( b, hashes[a] );
+    GraphUtils::addEdge( V,a,b );
+}
+
+bool CEKernelizer::sameClosedNeighborhood(int a, int b) {
+    if( V[a].size() != V[b].size() ) return false;
+    if( nbh_marked != a ){ // marking N[a]
+        nbh_epoch++;
+        nbh_marked = a;
+        nbh_stamp[a] = nbh_epoch;
+        for( int w : V[a] ) nbh_stamp[w] = nbh_epoch;
+    }
+    if( nbh_stamp[b] != nbh_epoch ) return false;
+    for( int w : V[b] ) if( w != a && nbh_stamp[w] != nbh_epoch ) return false;
+    return true;
+}
+
+VVI CEKernelizer::splitBucket(const VI &bucket) {
+    if( bucket.size() == 1 ) return { bucket };
+    nbh_marked = -1; // V might have changed since the last call
+    return HashBuckets::split( bucket, [&]( int a, int b ){ return sameClosedNeighborhood(a,b); } );
+}
+
+void CEKernelizer::processChangedNodes() {
+    for( int v : changed_nodes ){
+        is_changed[v] = false;
+        for( int r=0; r<LOCAL_RULES_CNT; r++ ){
+            if( !is_pending[r][v] ){
+                is_pending[r][v] = true;
+                pending[r].push_back(v);
+            }
+        }
+    }
+    changed_nodes.clear();
+}
+
 vector<CriticalClique> CEKernelizer::createCriticalCliques(VI nodes) {
     TimeMeasurer::startMeasurement("CriticalCliques");
-    if( nodes.empty() ){
-        nodes.reserve(N);
-        for(int i=0; i<N; i++) if(inV[i]) nodes.push_back(i);
-    }
 
-    unordered_map<LL, VI, fib_hash> cc; // should be reproducible after changing fib_hash to deterministic
-//    map<LL, VI> cc;
+    VVI cc;
+    auto addBucket = [&]( const VI & bucket ){
+        VI nodes_in_v;
+        nodes_in_v.reserve( bucket.size() );
+        for( int i : bucket ){
+            if( !inV[i] ) continue;
+            if( V[i].empty() ){ inV[i] = false; continue; }
+            nodes_in_v.push_back(i);
+        }
+        if( nodes_in_v.empty() ) return;
+        for( VI & c : splitBucket(nodes_in_v) ) cc.push_back( move(c) );
+    };
 
-    for( int i : nodes ){
-        if( V[i].empty() ){ inV[i] = false; continue; }
-        LL h = hashes[i];
-        for( int w : V[i] ) h ^= hashes[w];
-        cc[h].push_back(i);
+    if( nodes.empty() ){ // [closed_hashes] already groups all nodes
+        for( auto & [h,bucket] : closed_hashes.buckets ) addBucket(bucket);
+    }else{
+        unordered_map<LL, VI, fib_hash> buckets; // should be reproducible after changing fib_hash to deterministic
+        for( int i : nodes ) buckets[ closed_hashes.hash(i) ].push_back(i);
+        for( auto & [h,bucket] : buckets ) addBucket(bucket);
     }
 
     vector<CriticalClique> res; //(cc.size());
     res.reserve( cc.size() );
     int cnt = 0;
-    for( auto & p : cc ) res.emplace_back( V, p.second, cnt++ );
+    for( VI & c : cc ) res.emplace_back( V, move(c), cnt++ );
 
     for( auto& cc : res ) for( int i=0; i<cc.nodes.size(); i++ ) fau.Union( cc.nodes[0], cc.nodes[i] );
     markInClVector();
 
-    StandardUtils::shuffle(res,drng);
-
    /* for( int i=0; i<res.size(); i++ ) res[i].id = i; // random_shuffling res and changing ids
     sort( ALL(res), []( auto& c1, auto& c2 ){
         if( c1.size() != c2.size() ) return c1.size() > c2.size(); else return c1.id < c2.id;
     });*/
+    shuffleAndSortBySize(res);
+
+    TimeMeasurer::stopMeasurement("CriticalCliques");
+    return res;
+}
+
+void CEKernelizer::shuffleAndSortBySize(vector<CriticalClique> &res) {
+    StandardUtils::shuffle(res,drng);
+
     { // count sort
         int M = 0;
         for( auto& c : res ) M = max(M,c.size());
@@ -94,6 +182,54 @@ vector<CriticalClique> CEKernelizer::createCriticalCliques(VI nodes) {
     }
 
     for( int i=0; i<res.size(); i++ ) res[i].id = i; // assigning ids after change
+}
+
+vector<CriticalClique> CEKernelizer::createLocalCriticalCliques(VI &region) {
+    TimeMeasurer::startMeasurement("CriticalCliques");
+
+    visit_epoch++;
+    VI nodes;
+    auto visit = [&]( int v ){
+        if( inV[v] && visit_stamp[v] != visit_epoch ){
+            visit_stamp[v] = visit_epoch;
+            nodes.push_back(v);
+        }
+    };
+
+    for( int v : region ) visit(v);
+    for( int dst = 0, beg = 0; dst < 2; dst++ ){ // nodes within distance 2 from [region]
+        int end = nodes.size();
+        for( int i=beg; i<end; i++ ) for( int w : V[ nodes[i] ] ) visit(w);
+        beg = end;
+    }
+
+    // each critical clique is a whole bucket of [closed_hashes] (up to collisions), so nodes of critical cliques
+    // further than 2 from [region] are also taken
+    visit_epoch++; // from now on visit_stamp[v] == visit_epoch means that the critical clique of v was created
+    VVI cc;
+    for( int v : nodes ){
+        if( visit_stamp[v] == visit_epoch ) continue;
+        if( V[v].empty() ){ inV[v] = false; continue; }
+
+        VI bucket;
+        for( int w : closed_hashes.bucketOf(v) ){
+            if( inV[w] && visit_stamp[w] != visit_epoch && !V[w].empty() ){
+                visit_stamp[w] = visit_epoch;
+                bucket.push_back(w);
+            }
+        }
+        for( VI & c : splitBucket(bucket) ) cc.push_back( move(c) );
+    }
+
+    vector<CriticalClique> res;
+    res.reserve( cc.size() );
+    int cnt = 0;
+    for( VI & c : cc ) res.emplace_back( V, move(c), cnt++ );
+
+    for( auto& c : res ) for( int i=0; i<c.nodes.size(); i++ ) fau.Union( c.nodes[0], c.nodes[i] );
+    markInClVector();
+
+    shuffleAndSortBySize(res);
 
     TimeMeasurer::stopMeasurement("CriticalCliques");
     return res;
@@ -125,28 +261,11 @@ vector<CriticalClique> CEKernelizer::createCriticalCliques(VVI &V, VI nodes) {
     int cnt = 0;
     for( auto & p : cc ) res.emplace_back( V, p.second, cnt++ );
 
-    StandardUtils::shuffle(res,drng);
-
 //    for( int i=0; i<res.size(); i++ ) res[i].id = i; // assigning ids - no need in case of count-sort
 //    sort( ALL(res), []( auto& c1, auto& c2 ){
 //        if( c1.size() != c2.size() ) return c1.size() > c2.size();  else return c1.id < c2.id;
 //    });
-    { // count sort
-        int M = 0;
-        for( auto& c : res ) M = max(M,c.size());
-        vector<vector<CriticalClique*>> v( 1 + M );
-        for( int i=0; i<res.size(); i++ ) v[res[i].size()].push_back( &res[i] );
-
-        vector<CriticalClique> res2(res.size());
-        int cnt = 0;
-        for( int i=M; i>=1; i-- ){
-            for( auto* c : v[i] ){
-                res2[cnt++] = move(*c);
-            }
-        }
-        swap(res,res2);
-    }
-    for( int i=0; i<res.size(); i++ ) res[i].id = i; // random_shuffling res
+    shuffleAndSortBySize(res);
 
     TimeMeasurer::stopMeasurement("CriticalCliques_2");
     return res;
@@ -179,6 +298,15 @@ VI CEKernelizer::getNeighborhood(VI &nodes, int dst) {
 }
 
 void CEKernelizer::makeCliqueAndRemoveFromGraph(VI nodes) {
+    for( int d : nodes ){
+        markChanged(d);
+        for( int w : V[d] ){
+            markChanged(w);
+            closed_hashes.toggle( w, hashes[d] );
+        }
+    }
+    for( int d : nodes ) closed_hashes.set( d, hashes[d] ); // N[d] = {d} after removal
+
     for( int i=0; i<nodes.size(); i++ ){
         inCl[ nodes[i] ] = inCl[nodes[0]];
         inV[nodes[i]] = false;
@@ -288,14 +416,13 @@ bool CEKernelizer::rule2() {
         ccs = createCriticalCliques();
     bool changes = false;
 
-    VB affected(N,false);
+    affected_epoch++; // clears [affected_stamp]
 
     VI temp_neigh;
-    temp_neigh.reserve(N);
 
     for( auto& cc : ccs ){
         bool checkCC = true;
-        for( int d : cc.nodes ) if(affected[d]){ checkCC = false;break; }
+        for( int d : cc.nodes ) if(isAffected(d)){ checkCC = false;break; }
         if(!checkCC) continue;
 
         auto K = cc.nodes;
@@ -333,7 +460,7 @@ bool CEKernelizer::rule2() {
             ruleAppliedCnt[2]++;
 
             // all nodes from this set are affected, cc's in N1 may become incorporated into K+N1
-            for( int d : K+N1 ) affected[d] = true;
+            for( int d : K+N1 ) setAffected(d);
         }
     }
 
@@ -353,9 +480,9 @@ bool CEKernelizer::rule3() {
     if(ccs.empty())
         ccs = createCriticalCliques();
     bool changes = false;
-    VB affected(N,false);
+    affected_epoch++; // clears [affected_stamp]
 
-    VI inCC(N,-1); // id of the CC that contains node d
+    VI & inCC = cc_of_node; // id of the CC that contains node d, -1 if the CC of d is not in ccs
     for( auto& cc : ccs ){
         for( int d : cc.nodes ){
             inCC[d] = cc.id;
@@ -369,13 +496,13 @@ bool CEKernelizer::rule3() {
      */
     VI cc_inters(ccs.size(),0);
 
-    VB inN1(N,false);
-    VB inN2(N,false);
-    VB inKp(N,false);
+    VB & inN1 = helper2;
+    VB & inN2 = helper3;
+    VB & inKp = helper4;
 
     for( auto& cc : ccs ){
         bool checkCC = true;
-        for( int d : cc.nodes ) if(affected[d]){ checkCC = false;break; }
+        for( int d : cc.nodes ) if(isAffected(d)){ checkCC = false;break; }
         if(!checkCC) continue;
 
 
@@ -397,6 +524,7 @@ bool CEKernelizer::rule3() {
 
         for( int d : N1 ){
             int cc_id = inCC[d];
+            if( cc_id == -1 ) continue; // ccs contain only critical cliques close to changed nodes
             cc_inters[cc_id]++;
 
             if(cc_inters[cc_id] == ccs[cc_id].nodes.size()){
@@ -407,7 +535,7 @@ bool CEKernelizer::rule3() {
         // clearing cc_inters
         for( int d : N1 ){
             int cc_id = inCC[d];
-            cc_inters[cc_id]--;
+            if( cc_id != -1 ) cc_inters[cc_id]--;
         }
 
         if( ccs2.empty() ) continue;
@@ -467,11 +595,11 @@ bool CEKernelizer::rule3() {
                     clog << "Removing edges: " << edges_to_remove << endl;
                 }
 
-                GraphUtils::removeEdges(V, edges_to_remove );
+                removeEdgesFromGraph( edges_to_remove );
 
                 changes = true;
                 ruleAppliedCnt[3]++;
-                for( PII e : edges_to_remove ) affected[e.first] = affected[e.second] = true;
+                for( PII e : edges_to_remove ){ setAffected(e.first); setAffected(e.second); }
                 { // making union of K and Kp
                     fau.Union( K[0], Kp[0] ); // this will make it, since K and Kp are critical cliques
                 }
@@ -490,6 +618,8 @@ bool CEKernelizer::rule3() {
         if(debug) clog << endl;
     }
 
+    for( auto& cc : ccs ) for( int d : cc.nodes ) inCC[d] = -1; // clearing
+
     if(changes) ccs.clear();
 
     markInClVector();
@@ -508,11 +638,11 @@ bool CEKernelizer::rule4() {
         ccs = createCriticalCliques();
     bool changes = false;
 
-    VB affected(N,false);
+    affected_epoch++; // clears [affected_stamp]
 
     for( auto& cc : ccs ){
         bool checkCC = true;
-        for( int d : cc.nodes ) if(affected[d]){ checkCC = false;break; }
+        for( int d : cc.nodes ) if(isAffected(d)){ checkCC = false;break; }
         if(!checkCC) continue;
 
 
@@ -531,7 +661,7 @@ bool CEKernelizer::rule4() {
             makeCliqueAndRemoveFromGraph(K+N1);
             changes = true;
             ruleAppliedCnt[4]++;
-            for( int d : K+N1 ) affected[d] = true;
+            for( int d : K+N1 ) setAffected(d);
         }
     }
 
@@ -553,15 +683,15 @@ bool CEKernelizer::rule6_lemma3() {
         ccs = createCriticalCliques();
     bool changes = false;
 
-    VB affected(N,false);
-    VB inK(N,false), inN1(N,false);
+    affected_epoch++; // clears [affected_stamp]
+    VB & inK = helper2, & inN1 = helper3;
 
     if(debug)
         DEBUG(ccs);
 
     for( auto& cc : ccs ){
         bool checkCC = true;
-        for( int d : cc.nodes ) if(affected[d]){ checkCC = false;break; }
+        for( int d : cc.nodes ) if(isAffected(d)){ checkCC = false;break; }
         if(!checkCC) continue;
 
 
@@ -602,7 +732,7 @@ bool CEKernelizer::rule6_lemma3() {
             }
 
             makeCliqueAndRemoveFromGraph(K+N1);
-            for(int d : K+N1) affected[d] = true;
+            for(int d : K+N1) setAffected(d);
 
             ruleAppliedCnt[6]++;
             changes = true;
@@ -632,15 +762,15 @@ bool CEKernelizer::rule7() {
         ccs = createCriticalCliques();
     bool changes = false;
 
-    VB affected(N,false);
-    VB inK(N,false), inN1(N,false);
-    VI uDegs(N,0);
+    affected_epoch++; // clears [affected_stamp]
+    VB & inK = helper2, & inN1 = helper3;
+    VI & uDegs = helper_int;
 
     if(debug) DEBUG(ccs);
 
     for( auto& cc : ccs ){
         bool checkCC = true;
-        for( int d : cc.nodes ) if(affected[d]){ checkCC = false;break; }
+        for( int d : cc.nodes ) if(isAffected(d)){ checkCC = false;break; }
         if(!checkCC) continue;
 
         auto K = cc.nodes;
@@ -706,7 +836,7 @@ bool CEKernelizer::rule7() {
             makeCliqueAndRemoveFromGraph(K+N1);
             ruleAppliedCnt[7]++;
             changes = true;
-            for(int d : K+N1) affected[d] = true;
+            for(int d : K+N1) setAffected(d);
         }
         else{
             if(debug) clog << "Rule7 does not apply to K: " << K << "   N1: " << N1 <<
@@ -734,15 +864,15 @@ bool CEKernelizer::rule8() {
         ccs = createCriticalCliques();
     bool changes = false;
 
-    VB affected(N,false);
-    VB inK(N,false), inN1(N,false);
-    VI uDegs(N,0);
+    affected_epoch++; // clears [affected_stamp]
+    VB & inK = helper2, & inN1 = helper3;
+    VI & uDegs = helper_int;
 
     if(debug) DEBUG(ccs);
 
     for( auto& cc : ccs ){
         bool checkCC = true;
-        for( int d : cc.nodes ) if(affected[d]){ checkCC = false;break; }
+        for( int d : cc.nodes ) if(isAffected(d)){ checkCC = false;break; }
         if(!checkCC) continue;
 
 
@@ -820,11 +950,11 @@ bool CEKernelizer::rule8() {
                 DEBUG2(edges_to_remove, edges_to_add);
             }
 
-            GraphUtils::removeEdges( V, edges_to_remove );
-            for( auto [a,b] : edges_to_add ) GraphUtils::addEdge(V,a,b);
+            removeEdgesFromGraph( edges_to_remove );
+            for( auto [a,b] : edges_to_add ) addEdgeToGraph(a,b);
 
-            for(int d : K + N1) affected[d] = true;
-            for( auto [a,b] : edges_to_remove ) affected[a] = affected[b] = true;
+            for(int d : K + N1) setAffected(d);
+            for( auto [a,b] : edges_to_remove ){ setAffected(a); setAffected(b); }
             if( edges_to_add.size() > 0 || edges_to_remove.size() > 0 ){
                 changes = true;
                 ruleAppliedCnt[8]++;
@@ -856,8 +986,8 @@ bool CEKernelizer::rule9() {
         ccs = createCriticalCliques();
     bool changes = false;
 
-    VB affected(N,false);
-    VB inK(N,false), inN1(N,false);
+    affected_epoch++; // clears [affected_stamp]
+    VB & inK = helper2, & inN1 = helper3;
 
     unordered_set<LL,fib_hash> cc_hashes;
     for( auto& cc : ccs ){
@@ -870,7 +1000,7 @@ bool CEKernelizer::rule9() {
 
     for( auto& cc : ccs ){
         bool checkCC = true;
-        for( int d : cc.nodes ) if(affected[d]){ checkCC = false;break; }
+        for( int d : cc.nodes ) if(isAffected(d)){ checkCC = false;break; }
         if(!checkCC) continue;
 
 
@@ -938,7 +1068,7 @@ bool CEKernelizer::rule9() {
 
         ruleAppliedCnt[9]++;
         changes = true;
-        for(int d : K+N1) affected[d] = true;
+        for(int d : K+N1) setAffected(d);
     }
 
     if(changes) ccs.clear();
@@ -1022,7 +1152,7 @@ bool CEKernelizer::rule15() {
                 for( int j=i+1; j<cl.size(); j++ ){
                     int b = cl[j];
                     if( edges[a].count(b) == 0 ){ // edge (a,b) is not in the graph
-                        GraphUtils::addEdge( V,a,b );
+                        addEdgeToGraph(a,b);
                         if(debug)
                             clog << "In rule15, adding edge (" << a << "," << b << ")" << endl;
 //                        edges[a].insert(b); edges[b].insert(a); // no need in fact to add nodes a and b to [edges]
@@ -1455,7 +1585,7 @@ bool CEKernelizer::rule_heur_4(double perc, const bool add_edge) {
                 if (debug) clog << "Pairing nodes {" << u << "," << v << "}" << endl;
                 fau.Union(u, v);
                 rule_heur_4_paired_nodes.emplace_back(u,v);
-                if (add_edge) GraphUtils::addEdge(V, u, v);
+                if (add_edge) addEdgeToGraph(u, v);
                 changes = true;
                 ruleAppliedCnt[MAX_RULES+4]++;
             }
@@ -1740,6 +1870,56 @@ bool CEKernelizer::rule_heur_7(int max_out_deg_sum, int max_out_deg, int max_out
     return changes;
 }
 
+bool CEKernelizer::applyLocalRules() {
+    const bool debug = false;
+    bool any_changes = false;
+    defer_in_cl_update = true;
+
+    while( true ){
+        if(Global::checkTle()) break;
+
+        int r = 0;
+        while( r < LOCAL_RULES_CNT && pending[r].empty() ) r++;
+        if( r == LOCAL_RULES_CNT ) break;
+
+        int rule = LOCAL_RULES[r];
+        VI region;
+        swap( region, pending[r] );
+        for( int v : region ) is_pending[r][v] = false;
+
+        // if rule3 did not apply, then rule 6 will not either, so there is no need to check it
+        if( disabled_rules[rule] || ( rule == 6 && disabled_rules[3] ) ) continue;
+
+        ccs = createLocalCriticalCliques(region);
+        if( ccs.empty() ) continue; // otherwise rules would create critical cliques for the whole graph
+
+        bool changes = false;
+        switch(rule){
+            case 1: changes = rule1(); break;
+            case 2: changes = rule2(); break;
+            case 3: changes = rule3(); break;
+            case 4: changes = rule4(); break;
+            case 6: changes = rule6_lemma3(); break;
+            case 7: changes = rule7(); break;
+            case 8: changes = rule8(); break;
+            case 9: changes = rule9(); break;
+            default: assert(false);
+        }
+        ccs.clear(); // critical cliques of the region must not be used by other rules
+
+        if(changes){
+            if(debug) clog << "Rule " << rule << " applies, region size: " << region.size() << ", changed nodes: "
+                << changed_nodes.size() << endl;
+            any_changes = true;
+        }
+        processChangedNodes();
+    }
+
+    defer_in_cl_update = false;
+    markInClVector();
+    return any_changes;
+}
+
 void CEKernelizer::fullKernelization(bool use_heuristic_rules, int additional_randomized_iterations) {
     bool debug = true;
     bool debugRuleApplicationOnTheFly = false;
@@ -1754,6 +1934,15 @@ void CEKernelizer::fullKernelization(bool use_heuristic_rules, int additional_ra
 
     TimeMeasurer::startMeasurement("FullKernelization");
 
+    for( int v : changed_nodes ) is_changed[v] = false;
+    changed_nodes.clear();
+    for( int r=0; r<LOCAL_RULES_CNT; r++ ){
+        for( int v : pending[r] ) is_pending[r][v] = false;
+        pending[r].clear();
+    }
+    for( int i=0; i<N; i++ ) if( inV[i] ) markChanged(i); // initially all nodes need to be checked by all rules
+    processChangedNodes();
+
     bool changes = true;
     while( changes  ){
         if(Global::checkTle()) break;
@@ -1761,88 +1950,23 @@ void CEKernelizer::fullKernelization(bool use_heuristic_rules, int additional_ra
         changes = false;
 //        for(int i=0; i<N; i++) assert( helper1[i] == false );
 
-        if( rule1() ){
-            if(debugRuleApplicationOnTheFly) clog << "Rule 1 applies" << endl;
-            changes = true; continue;
-        }
-        if( rule2() ){
-            if(debugRuleApplicationOnTheFly) clog << "Rule 2 applies" << endl;
-            changes = true; continue;
-        }
+        if( applyLocalRules() && debugRuleApplicationOnTheFly ) clog << "Local rules applied" << endl;
+
         if( rule16(debugRuleApplicationOnTheFly) ){ // almost critical clique for C3, D3 and K4.
-            // This rule is very fast, hence it can be done before other rules are checked.
             if(debugRuleApplicationOnTheFly) clog << "Rule 16 applies" << endl;
-            changes = true; continue;
-        }
-        if( rule3() ){
-            if(debugRuleApplicationOnTheFly) clog << "Rule 3 applies" << endl;
-            changes = true; continue;
-        }
-        if( rule4() ){
-            if(debugRuleApplicationOnTheFly) clog << "Rule 4 applies" << endl;
-            changes = true; continue;
-        }
-        if(!disabled_rules[3] && rule6_lemma3() ){
-            // if rule3 did not apply, then rule 6 will not either, so there is no need to check it
-            if(debugRuleApplicationOnTheFly) clog << "Rule 6_lemma3 applies" << endl;
-            changes = true; continue;
-        }
-        if( rule7() ){
-            if(debugRuleApplicationOnTheFly) clog << "Rule 7 applies" << endl;
-            changes = true; continue;
-        }
-        if( rule8() ){
-            if(debugRuleApplicationOnTheFly) clog << "Rule 8 applies" << endl;
-            changes = true; continue;
-        }
-        if( rule9() ){
-            if(debugRuleApplicationOnTheFly) clog << "Rule 9 applies" << endl;
+            processChangedNodes();
             changes = true; continue;
         }
         if( rule15() ){
             if(debugRuleApplicationOnTheFly) clog << "Rule 15 applies" << endl;
+            processChangedNodes();
             changes = true; continue;
         }
-        if( rule16(debugRuleApplicationOnTheFly) ){ // almost critical clique for C3, D3 and K4.
-            if(debugRuleApplicationOnTheFly) clog << "Rule 16 applies" << endl;
-            changes = true; continue;
-        }
-
 
         // applying heuristic rules only if normal rules made no more progress
         if(use_heuristic_rules) {
-           /* if (rule_heur_1()) {
-                if (debugRuleApplicationOnTheFly) clog << "Rule heur_1 applies" << endl;
-                changes = true; continue;
-            }
-            if (rule_heur_2()) {
-                if (debugRuleApplicationOnTheFly) clog << "Rule heur_2 applies" << endl;
-                changes = true; continue;
-            }
-            if (iterative_rule_heur_3()) {
-                if (debugRuleApplicationOnTheFly) clog << "Rule heur_3 applies" << endl;
-                changes = true; continue;
-            }
-            if (rule_heur_4()) {
-                if (debugRuleApplicationOnTheFly) clog << "Rule heur_4 applies" << endl;
-                changes = true; continue;
-            }
-            if (rule_heur_5()) {
-                if (debugRuleApplicationOnTheFly) clog << "Rule heur_5 applies" << endl;
-                changes = true; continue;
-            }
-            if (rule_heur_6()) {
-                if (debugRuleApplicationOnTheFly) clog << "Rule heur_6 applies" << endl;
-                changes = true; continue;
-            }
-            if (rule_heur_7()) {
-                // default: max_out_deg_sum = 4, max_out_deg = 2, max_out_deg_to_merge = 1, enable_diamonds = true
-                // for harder kernelization use (6,3,2,true)
-                if (debugRuleApplicationOnTheFly) clog << "Rule heur_7 applies" << endl;
-                changes = true; continue;
-            }*/
-
            changes = applyHeuristicKernelization(debugRuleApplicationOnTheFly);
+           processChangedNodes();
         }
     }
 
@@ -2443,7 +2567,7 @@ bool CEKernelizer::fillMissingEdgesBetweenClusterNodes() {
             for( int j=i+1; j<cl.size(); j++ ){
                 int b = cl[j];
                 if( edges[a].count(b) == 0 ){ // edge (a,b) is not in the graph
-                    GraphUtils::addEdge( V,a,b );
+                    addEdgeToGraph(a,b);
                     edges_added++;
                     if(debug)
                         clog << "In rule15, adding edge (" << a << "," << b << ")" << endl;
@@ -3,10 +3,13 @@
 //
 
 #include <clues/heur/StateImprovers/NodeEdgeGreedy.h>
-#include <clues/heur/StateImprovers/NodeEdgeGreedyNomap.h>
 #include <clues/heur/StateImprovers/SparseGraphTrimmer.h>
 #include <clues/test_graphs.h>
-#include <clues/heur/StateImprovers/NodeEdgeGreedyW1.h>
+#include <graphs/GraphWriter.h>
+#include <clues/heur/SolutionWriter.h>
+#include <clues/heur/ComponentSolver.h>
+#include <sys/stat.h>
+#include <condition_variable>
 #include "clues/main_CE.h"
 
 void kernelizationCompare(){
@@ -95,8 +98,10 @@ void kernelizationCompare(){
     }
 }
 
-void main_CE(){
-    std::ios_base::sync_with_stdio(0);
+void main_CE(int threads, string cache_file, string anytime_file){
+    // unsynchronized streams must not be used from many threads, so we turn off synchronization only if single
+    // worker is used
+    if( threads <= 1 ) std::ios_base::sync_with_stdio(0);
     std::cin.tie(NULL);
 
     Global::startAlg();
@@ -138,12 +143,37 @@ void main_CE(){
 //        ifstream istr( "exact/exact" + case_string + ".gr" );
 
         V = GraphReader::readGraphDIMACSWunweighed(istr);
-    }else V = GraphReader::readGraphDIMACSWunweighed(cin);
+    }else if( cache_file.empty() ) V = GraphReader::readGraphDIMACSWunweighedCSR(0).toVVI(); // stdin
+    else{
+        // stdin redirected from a file is identified by its inode, size and modification time - if any of them changed,
+        // then the cache is not up to date
+        unsigned long long key = 0;
+        struct stat st;
+        if( fstat(0, &st) == 0 && S_ISREG(st.st_mode) ){
+            key = 14695981039346656037ull;
+            for( unsigned long long x : { (unsigned long long)st.st_dev, (unsigned long long)st.st_ino,
+                                          (unsigned long long)st.st_size, (unsigned long long)st.st_mtime } ){
+                key = (key ^ x) * 1099511628211ull;
+            }
+        }
+
+        CSRGraph<int> G;
+        unsigned long long cache_key = 0;
+        if( key != 0 && GraphReader::readGraphBinary( cache_file, G, nullptr, nullptr, &cache_key ) && cache_key == key ){
+            if(!Global::disable_all_logs) clog << "Graph loaded from " << cache_file << endl;
+        }else{
+            G = GraphReader::readGraphDIMACSWunweighedCSR(0);
+            if( key != 0 ) GraphWriter::writeGraphBinary( G, cache_file, nullptr, nullptr, key );
+        }
+
+        V = G.toVVI();
+    }
 
 
     if(!Global::disable_all_logs) GraphUtils::writeBasicGraphStatistics(V);
 
     Config cnf;
+    if( !cache_file.empty() ) cnf.kernel_cache_file = cache_file + ".kernel";
 //    cnf.swpCndCreatorsToUse = { exp_ord_attr};
 //    cnf.swpCndCreatorsToUse = {node, triangle, exp_ord, exp_ord_attr, exp_ord_rep };
 //    cnf.swpCndCreatorsToUse = {node, exp_ord, exp_ord_attr, exp_ord_rep, triangle }; // good order
@@ -249,30 +279,10 @@ void main_CE(){
             cnf.neg_use_triangle_swaps = true;
             cnf.neg_triangle_swaps_frequency = 70; // originally 70
 
-            cnf.neg_use_queue_propagation = true;
+            cnf.neg_use_queue_propagation = false; // originally true, but NEG_W1 used earlier for such graphs ignored it
         }
     }
 
-    {
-        if(!Global::disable_all_logs) clog << "Checking if NEG_nomap and NEG:W1 can be used" << endl;
-        VI part(V.size(),0); iota(ALL(part),0);
-        ClusterGraph clg(&V,part);
-        State st(clg, RANDOM_STATE_PERM);
-        NodeEdgeGreedyNomap nomap(st);
-        nomap.use_edge_swaps = nomap.use_triangle_swaps = nomap.use_node_interchanging = nomap.use_join_clusters =
-        nomap.use_chain2_swaps = false;
-        nomap.max_iterations_to_do = 3;
-        nomap.improve();
-        int clusters_cnt = nomap.countNonemptyClusters();
-
-        /**
-         * If there are few clusters compared to the number of nodes (that is graph is e.g. very dense or locally
-         * very dense), then we use 'map' version of NEG, as it is much faster on that instances.
-         */
-        const double THR = 3.5;
-        if( clusters_cnt < clg.V.size() / THR ) cnf.use_neg_map_version = true;
-    }
-
 
 	/*{
 		clog << "******************************************CAUTION! Enabling all swaps!" << endl << endl; 
@@ -309,8 +319,6 @@ void main_CE(){
         DEBUG(cnf.neg_use_queue_propagation);
         DEBUG(cnf.neg_use_join_clusters);
         DEBUG(cnf.neg_use_chain2_swaps);
-
-        DEBUG(cnf.use_neg_map_version);
     }
 
     const bool TEST = false;
@@ -324,9 +332,7 @@ void main_CE(){
                 DEBUG(st.clusters.size());
 
                 NEG* neg;
-//                neg = new NodeEdgeGreedy(st);
-                neg = new NodeEdgeGreedyNomap(st);
-//                neg = new NodeEdgeGreedyW1(st);
+                neg = new NodeEdgeGreedy(st);
 
                 neg->setConfigurations(cnf);
 
@@ -355,18 +361,33 @@ void main_CE(){
         }
 
     }else {
-        double E = GraphUtils::countEdges(V);
-        double avg_deg = 2.0 * E / V.size();
+        VPII best_mods;
+
+        /**
+         * Best result found so far by any of the workers. It is atomic, so that workers can cheaply check whether
+         * they improved the result without locking [best_mutex]. [best_mods] is updated only under [best_mutex].
+         */
+        atomic<int> best_result(1e9);
+        mutex best_mutex;
 
-        bool use_run_fast = true;
-        if(avg_deg < 4) use_run_fast = false;
+        unique_ptr<SolutionWriter> solution_writer;
+        if( !anytime_file.empty() ) solution_writer = make_unique<SolutionWriter>(anytime_file);
 
-        VPII best_mods; int best_result = 1e9;
+        /**
+         * Runs a single main iteration for graph [G] and returns the solver containing the best partition of [G] found
+         * in that iteration.
+         */
+        auto mainIteration = [&]( VVI & G, Config & cnf, bool & switcher, ThreadPool * neg_pool = nullptr ){
+            double E = GraphUtils::countEdges(G);
+            double avg_deg = 2.0 * E / G.size();
 
-        bool switcher = false;
+            bool use_run_fast = true;
+            if(avg_deg < 4) use_run_fast = false;
 
-        while( !Global::checkTle() ) {
-            Solver solver(V, init_part, cnf);
+            VI init_part(G.size());
+            iota(ALL(init_part),0);
+            auto solver = make_unique<Solver>(G, init_part, cnf);
+            if( neg_pool != nullptr ) solver->setNegPool(neg_pool);
 
             if(use_run_fast){
                 int old_cnf_use_only_fast_exact_kernelization = cnf.use_only_fast_exact_kernelization;
@@ -376,9 +397,9 @@ void main_CE(){
                     switcher = !switcher;
                 }
 
-                solver.run_fast(); // #TEST
-                auto [ part_oV, part_clg ] = solver.localSearch();
-                solver.compareToBestSolutionAndUpdate(part_oV);
+                solver->run_fast(); // #TEST
+                auto [ part_oV, part_clg ] = solver->localSearch();
+                solver->compareToBestSolutionAndUpdate(part_oV);
 
 //                cnf.use_kernelization = !cnf.use_kernelization; // changing to use / not to use kernelization in next iteration
                 //#TEST - do not use kernelization
@@ -386,11 +407,12 @@ void main_CE(){
                 cnf.use_only_fast_exact_kernelization = old_cnf_use_only_fast_exact_kernelization;
             }
             else{
-//                solver.run_recursive(); // original
-                ClusterGraph clg(&V,init_part);
+//                solver->run_recursive(); // original
+                ClusterGraph clg(&G,init_part);
                 State st(clg, RANDOM_MATCHING);
-                NEG* neg = new NodeEdgeGreedyW1(st);
+                NEG* neg = new NodeEdgeGreedy(st);
                 neg->setConfigurations(cnf);
+                neg->pool = neg_pool;
 
                 neg->perturb_mode = 0; // cluster joining instead of splitting
                 neg->allow_perturbations = true;
@@ -404,37 +426,184 @@ void main_CE(){
                 neg->improve();
 
                 { // CAUTION - setting values to unused solver
-                    solver.best_result = neg->best_result;
-                    solver.best_partition = neg->best_partition;
+                    solver->best_result = neg->best_result;
+                    solver->best_partition = neg->best_partition;
                 }
 
                 delete neg;
             }
 
-            if( solver.best_result < best_result ){
-                best_result = solver.best_result;
-                best_mods = solver.getModifications();
+            return solver;
+        };
+
+        /**
+         * Each thread needs to have different seeds - otherwise all workers would find the same solutions.
+         */
+        auto setSeeds = []( int id ){
+            UniformIntGenerator::lastSeed = ( 171'234'573 + 1'000'003 * id ) % 1'000'000'007;
+            UniformDoubleGenerator::lastSeed = ( 232 + 1'000'003 * id ) % 1'000'000'007;
+        };
+
+        /**
+         * Runs main iterations until time limit is reached. Each worker has its own copy of Config, its own Solver
+         * and its own sequence of seeds for random generators.
+         */
+        auto worker = [&]( int thread_id, Config cnf ){
+            if( thread_id > 0 ) setSeeds(thread_id);
+
+            bool switcher = ( (thread_id & 1) == 1 );
+
+            // a single pool is used by solvers in all iterations of this worker
+            unique_ptr<ThreadPool> neg_pool;
+            if( cnf.neg_threads > 1 ) neg_pool = make_unique<ThreadPool>( cnf.neg_threads );
+
+            while( !Global::checkTle() ) {
+                auto solver = mainIteration(V, cnf, switcher, neg_pool.get());
+
+                if( solver->best_result < best_result ){
+                    VPII mods = solver->getModifications(); // computed outside of the lock
+                    lock_guard<mutex> lock(best_mutex);
+                    if( solver->best_result < best_result ){ // another worker might have improved in the meantime
+                        best_result = solver->best_result;
+                        swap(best_mods, mods);
+
+                        if( solution_writer ){
+                            mods = best_mods;
+                            solution_writer->submit( mods, best_result );
+                        }
+                    }
+                }
+
+                if(!Global::disable_all_logs){
+                    lock_guard<mutex> lock(best_mutex);
+                    clog << "Creators: (calls,improvements):" << endl;
+                    for( auto & [s,p] : solver->local_search_creator_calls ){
+                        clog << s << " --> " << p << endl;
+                    }
+                    clog << endl << endl << endl << endl << "********************* NEXT MAIN ITERATION";
+                    if( threads > 1 ) clog << " (thread " << thread_id << ")";
+                    clog << ", current best: " << best_result << endl << endl;
+                }/*else{
+                    cerr << endl << endl << endl << endl << "********************* NEXT MAIN ITERATION, current best: "
+                         << best_result << endl << endl;
+                }*/
+            }
+        };
+
+        unique_ptr<ComponentSolver> comp_solver;
+        if( cnf.use_component_decomposition ) comp_solver = make_unique<ComponentSolver>(V, cnf);
+
+        // independent components should not compete for iterations of the same worker, but if there is only one
+        // large component, then it is better to run the portfolio of workers for it. It is decided before small
+        // components are solved, so that no time is spent on them if the decomposition is not used.
+        bool solve_components = comp_solver && comp_solver->components.size() > 1 &&
+                                ( comp_solver->countLargeComponents() > 1 || threads <= 1 );
+
+        if( solve_components ){
+            double exact_seconds = min<double>( cnf.component_exact_max_time_in_sec,
+                                                Global::max_runtime_in_seconds - Global::preciseSecondsFromStart() );
+            comp_solver->solveSmallComponents( threads, exact_seconds );
+
+            /**
+             * Set when the result of a component improved and the solution was not submitted to [solution_writer]
+             * yet. Stitching the partition of the whole graph is costly, so workers only set this flag and the
+             * solution is submitted by [submitter], at most once per second and without holding [best_mutex].
+             */
+            atomic<bool> solution_dirty(true); // partition found by the kernelizer and branch and bound
+
+            mutex submitter_mutex;
+            condition_variable submitter_cv;
+            bool components_solved = false;
+
+            thread submitter;
+            if( solution_writer ){
+                submitter = thread( [&](){
+                    unique_lock<mutex> lock(submitter_mutex);
+                    while( !components_solved ){
+                        submitter_cv.wait_for( lock, chrono::seconds(1) );
+                        if( !solution_dirty.exchange(false) ) continue;
+
+                        lock.unlock();
+                        int res;
+                        VI part = comp_solver->getPartition(&res);
+                        VPII mods = PaceUtils::getModifications(V, part);
+                        solution_writer->submit( mods, res );
+                        lock.lock();
+                    }
+                } );
             }
 
-            if(!Global::disable_all_logs){
-                clog << "Creators: (calls,improvements):" << endl;
-                for( auto & [s,p] : solver.local_search_creator_calls ){
-                    clog << s << " --> " << p << endl;
+            /**
+             * Runs main iterations for component [c] until its time budget is used.
+             */
+            auto component_worker = [&]( int c, int, double ){
+                setSeeds(c+1);
+                Config comp_cnf = cnf;
+                bool switcher = ( (c & 1) == 1 );
+                VVI & G = comp_solver->graphs[c];
+
+                // Global::checkTle() returns true after the deadline of the component, so also an iteration that is
+                // in progress stops at that time
+                while( !Global::checkTle() ){
+                    auto solver = mainIteration(G, comp_cnf, switcher);
+
+                    if( comp_solver->updateBestPartition( c, solver->best_partition ) ){
+                        // results of components only decrease, but another worker might have stored an older one
+                        int res = comp_solver->getResult();
+                        int cur = best_result;
+                        while( res < cur && !best_result.compare_exchange_weak(cur, res) );
+                        solution_dirty = true;
+                    }
                 }
-                clog << endl << endl << endl << endl << "********************* NEXT MAIN ITERATION, current best: "
-                                               << best_result << endl << endl;
-            }/*else{
-                cerr << endl << endl << endl << endl << "********************* NEXT MAIN ITERATION, current best: "
-                     << best_result << endl << endl;
-            }*/
+
+                if(!Global::disable_all_logs){
+                    lock_guard<mutex> lock(best_mutex);
+                    clog << "Component " << c << " (" << G.size() << " nodes) solved, current best: "
+                         << best_result << endl;
+                }
+            };
+
+            double seconds = Global::max_runtime_in_seconds - Global::preciseSecondsFromStart();
+            comp_solver->solveLargeComponents( threads, seconds, component_worker );
+
+            if( submitter.joinable() ){
+                {
+                    lock_guard<mutex> lock(submitter_mutex);
+                    components_solved = true;
+                }
+                submitter_cv.notify_all();
+                submitter.join();
+            }
+
+            VI part = comp_solver->getPartition();
+            best_result = comp_solver->getResult();
+            best_mods = PaceUtils::getModifications(V, part);
+            assert( best_result == PaceUtils::evaluateSolution(V, part) );
+            if( solution_writer ){
+                VPII mods = best_mods;
+                solution_writer->submit( mods, best_result );
+            }
+        }
+        else if( threads <= 1 ) worker(0, cnf);
+        else if( V.size() >= cnf.neg_parallel_min_nodes ){
+            // a single main iteration on such graph takes long, so threads are used inside NEG instead
+            if(!Global::disable_all_logs) clog << "Running single worker with " << threads << " NEG threads" << endl;
+            Config worker_cnf = cnf;
+            worker_cnf.neg_threads = threads;
+            worker(0, worker_cnf);
+        }
+        else{
+            if(!Global::disable_all_logs) clog << "Running portfolio of " << threads << " workers" << endl;
+            vector<thread> workers;
+            workers.reserve(threads);
+            for( int i=0; i<threads; i++ ) workers.emplace_back( worker, i, cnf );
+            for( auto & t : workers ) t.join();
         }
 
 //        bool write_mods = Global::CONTEST_MODE;
         bool write_mods = true; // #TEST
-        if (write_mods) {
-            VPII mods = best_mods;
-            for (auto e : mods) cout << e.first+1 << " " << e.second+1 << endl;
-        }
+        if (write_mods) cout << SolutionWriter::format(best_mods) << flush;
+        if( solution_writer ) solution_writer->flush();
 
         cerr << "Final result: " << best_result << endl;
         cerr << "Total real time: " << Global::secondsFromStart() << endl;
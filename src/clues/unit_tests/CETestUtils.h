@@ -0,0 +1,66 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#ifndef ALGORITHMSPROJECT_CETESTUTILS_H
+#define ALGORITHMSPROJECT_CETESTUTILS_H
+
+#include "Makros.h"
+#include <utils/RandomNumberGenerators.h>
+#include "clues/heur/PaceUtils.h"
+
+/**
+ * Helper functions shared by unit tests of exact and decomposition solvers.
+ */
+namespace CETestUtils{
+
+    /**
+     * @return optimal result for graph [G], found by checking all partitions of nodes without any pruning
+     */
+    inline int bruteForceResult( VVI & G ){
+        int n = G.size();
+        int best = numeric_limits<int>::max();
+        VI part(n,0);
+
+        function<void(int,int)> gen = [&]( int v, int max_id ){
+            if( v == n ){
+                best = min<int>( best, PaceUtils::evaluateSolution(G, part) );
+                return;
+            }
+            for( int k=0; k<=max_id+1; k++ ){
+                part[v] = k;
+                gen( v+1, max(max_id,k) );
+            }
+        };
+
+        gen(0,-1);
+        return best;
+    }
+
+    /**
+     * @return random graph with [n] nodes, each edge is present with probability [p]
+     */
+    inline VVI randomGraph( int n, double p, UniformIntGenerator & rnd ){
+        VVI G(n);
+        for( int a=0; a<n; a++ ) for( int b=a+1; b<n; b++ ){
+            if( rnd.nextInt(1000) < 1000 * p ){
+                G[a].push_back(b);
+                G[b].push_back(a);
+            }
+        }
+        return G;
+    }
+
+    /**
+     * Adds a copy of [G] to [V], as a new component - node i of G gets id V.size() + i.
+     */
+    inline void appendGraph( VVI & V, VVI & G ){
+        int offset = V.size();
+        for( VI & neigh : G ){
+            V.push_back(neigh);
+            for( int & d : V.back() ) d += offset;
+        }
+    }
+}
+
+#endif //ALGORITHMSPROJECT_CETESTUTILS_H
@@ -0,0 +1,88 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#include <utils/RandomNumberGenerators.h>
+#include "clues/exact/CEBranchAndBound.h"
+#include "clues/heur/PaceUtils.h"
+#include "clues/heur/Global.h"
+#include "graphs/GraphUtils.h"
+#include "gtest/gtest.h"
+#include "CETestUtils.h"
+
+using namespace CETestUtils;
+
+static VI singletons( int n ){
+    VI part(n);
+    iota( ALL(part), 0 );
+    return part;
+}
+
+TEST( CEBranchAndBound, test_random_small ){
+    Global::startAlg();
+    UniformIntGenerator rnd(0, 1'000'000'000, 59);
+
+    for( int rep = 0; rep < 300; rep++ ){
+        int n = 1 + rnd.nextInt(8);
+        double p = ( 1 + rnd.nextInt(9) ) / 10.0;
+        VVI G = randomGraph(n, p, rnd);
+        int opt = bruteForceResult(G);
+
+        CEBranchAndBound bb(G);
+        auto triples = PaceUtils::getInducedP2Paths(G);
+        ASSERT_LE( bb.lowerBound(triples), opt );
+
+        ASSERT_TRUE( bb.solve( singletons(n) ) );
+        ASSERT_EQ( bb.best_result, opt );
+        ASSERT_EQ( PaceUtils::evaluateSolution(G, bb.best_partition), opt );
+
+        // all marks are reverted after the search
+        ASSERT_EQ( bb.cost, 0 );
+        ASSERT_TRUE( bb.trail.empty() );
+        ASSERT_EQ( bb.adj, bb.orig_adj );
+    }
+}
+
+/**
+ * Cluster graphs with a few modifications - the optimal result is at most the number of modifications.
+ * If the limit of branches is too small, the best partition found must still be valid and not worse than the initial.
+ */
+TEST( CEBranchAndBound, test_planted_clusters ){
+    Global::startAlg();
+    UniformIntGenerator rnd(0, 1'000'000'000, 61);
+
+    for( int rep = 0; rep < 20; rep++ ){
+        int n = 20 + rnd.nextInt(20);
+        VI planted(n);
+        for( int & p : planted ) p = rnd.nextInt(5);
+
+        VVB adj( n, VB(n,false) );
+        for( int a=0; a<n; a++ ) for( int b=a+1; b<n; b++ ) adj[a][b] = adj[b][a] = ( planted[a] == planted[b] );
+
+        int mods = 2 + rnd.nextInt(6);
+        for( int i=0; i<mods; i++ ){
+            int a = rnd.nextInt(n), b = rnd.nextInt(n);
+            if( a != b ) adj[a][b] = adj[b][a] = !adj[a][b];
+        }
+
+        VVI G(n);
+        for( int a=0; a<n; a++ ) for( int b=0; b<n; b++ ) if( adj[a][b] ) G[a].push_back(b);
+
+        CEBranchAndBound bb(G);
+        ASSERT_TRUE( bb.solve( singletons(n) ) );
+        ASSERT_LE( bb.best_result, mods );
+        ASSERT_EQ( PaceUtils::evaluateSolution(G, bb.best_partition), bb.best_result );
+
+        // starting from the optimal partition, optimality should be proved
+        CEBranchAndBound bb2(G);
+        ASSERT_TRUE( bb2.solve( bb.best_partition ) );
+        ASSERT_EQ( bb2.best_result, bb.best_result );
+
+        CEBranchAndBound bb_limited(G);
+        bool optimal = bb_limited.solve( singletons(n), 1 );
+        int res = PaceUtils::evaluateSolution(G, bb_limited.best_partition);
+        ASSERT_EQ( res, bb_limited.best_result );
+        ASSERT_LE( res, GraphUtils::countEdges(G) );
+        if( optimal ) ASSERT_EQ( res, bb.best_result );
+    }
+}
@@ -4,6 +4,8 @@
 
 #include <clues/test_graphs.h>
 #include "clues/kernelization/CEKernelizer.h"
+#include "clues/heur/Global.h"
+#include <utils/RandomNumberGenerators.h>
 #include "gtest/gtest.h"
 
 
@@ -31,6 +33,24 @@ TEST(CEKernelizer, critical_cliques) {
     }
 }
 
+/**
+ * Critical cliques {0,1} and {2,3} get the same hash - they must not be merged.
+ */
+TEST(CEKernelizer, critical_cliques_hash_collisions) {
+    VVI V = { {1}, {0}, {3}, {2} };
+    CEKernelizer kern(V);
+    kern.hashes = {1,2,4,7}; // 1^2 == 4^7
+    for( int i=0; i<4; i++ ) kern.closed_hashes.set( i, kern.closedNeighborhoodHash(i) );
+    ASSERT_EQ( kern.closed_hashes.bucketOf(0).size(), 4 );
+
+    auto cc = kern.createCriticalCliques();
+    ASSERT_EQ( cc.size(), 2 );
+    for( auto & c : cc ){
+        sort( ALL(c.nodes) );
+        ASSERT_TRUE( c.nodes == VI({0,1}) || c.nodes == VI({2,3}) );
+    }
+}
+
 TEST(CEKernelizer, editing_degrees) {
 
     clog << "Testing editing degrees, CE_test_graphs::kern_ed" << endl;
@@ -676,4 +696,45 @@ TEST(CEKernelizer, rule_heur_7_test2) {
     ASSERT_EQ(kern.inCl[16], kern.inCl[19]);
     ASSERT_NE(kern.inCl[16], kern.inCl[15]);
 
-}
\ No newline at end of file
+}
+/**
+ * Local rules are applied only to critical cliques near modified nodes. After fullKernelization no rule applied to
+ * the whole graph should make any change.
+ */
+TEST(CEKernelizer, full_kernelization_local_rules) {
+    UniformIntGenerator rnd(0, 1'000'000'000, 31);
+    Global::startAlg();
+
+    for( int rep = 0; rep < 50; rep++ ){
+        int N = 50 + rnd.nextInt(300);
+        VVI V(N);
+        auto addEdge = [&]( int a, int b ){
+            if( a == b || find( ALL(V[a]), b ) != V[a].end() ) return;
+            V[a].push_back(b);
+            V[b].push_back(a);
+        };
+
+        for( int beg = 0, s; beg < N; beg += s ){ // clusters with some missing edges and some noise
+            s = 1 + rnd.nextInt(10);
+            for( int a = beg; a < min(N,beg+s); a++ ) for( int b = a+1; b < min(N,beg+s); b++ ){
+                if( rnd.nextInt(10) > 0 ) addEdge(a,b);
+            }
+        }
+        for( int i = 0; i < N/3; i++ ) addEdge( rnd.nextInt(N), rnd.nextInt(N) );
+
+        CEKernelizer kern(V);
+        kern.fullKernelization(false, 0);
+
+        for( int i=0; i<N; i++ ) ASSERT_EQ( kern.closed_hashes.hash(i), kern.closedNeighborhoodHash(i) );
+        for( int r=0; r<CEKernelizer::LOCAL_RULES_CNT; r++ ) ASSERT_TRUE( kern.pending[r].empty() );
+
+        ASSERT_FALSE( kern.rule1() );
+        ASSERT_FALSE( kern.rule2() );
+        ASSERT_FALSE( kern.rule3() );
+        ASSERT_FALSE( kern.rule4() );
+        ASSERT_FALSE( kern.rule6_lemma3() );
+        ASSERT_FALSE( kern.rule7() );
+        ASSERT_FALSE( kern.rule8() );
+        ASSERT_FALSE( kern.rule9() );
+    }
+}
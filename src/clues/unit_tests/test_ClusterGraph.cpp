@@ -0,0 +1,87 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#include <utils/RandomNumberGenerators.h>
+#include "clues/heur/ClusterGraph.h"
+#include "clues/test_graphs.h"
+#include "gtest/gtest.h"
+
+TEST( ClusterGraph, test_small ){
+    VVI V = CE_test_graphs::cluster_graph_test;
+    VI part = CE_test_graphs::cluster_graph_test_partition;
+
+    ClusterGraph g(&V,part);
+
+    VI part_id_mapper_test = { 0,1,1,2,3,3,4,4,4,5, -1, 6 };
+    ASSERT_EQ( g.partition, part_id_mapper_test );
+    ASSERT_EQ( g.N, 7 );
+    ASSERT_EQ( g.csr.toVV(), g.V );
+    ASSERT_TRUE( g.csr_valid );
+}
+
+TEST( ClusterGraph, test_set_graph ){
+    ClusterGraph g;
+    ASSERT_FALSE( g.csr_valid );
+
+    VVPII V = { { {1,2}, {2,1} }, { {0,2} }, { {0,1} } };
+    g.setGraph(V);
+    ASSERT_EQ( g.N, 3 );
+    ASSERT_EQ( g.V, V );
+    ASSERT_TRUE( g.csr_valid );
+    ASSERT_EQ( g.csr.toVV(), g.V );
+}
+
+/**
+ * Compares the graph with one created by aggregating edge weights in a map (the way cluster graphs were created
+ * before), sequentially and using a thread pool.
+ */
+TEST( ClusterGraph, test_random ){
+    UniformIntGenerator rnd(0, 1'000'000'000, 23);
+    ThreadPool pool(3);
+
+    for( int rep = 0; rep < 100; rep++ ){
+        int N = 1 + rnd.nextInt(200);
+        int C = 1 + rnd.nextInt(N);
+        int E = rnd.nextInt( 5*N );
+
+        VVI V(N);
+        for( int i=0; i<E; i++ ){
+            int a = rnd.nextInt(N), b = rnd.nextInt(N);
+            if( a == b || find( ALL(V[a]), b ) != V[a].end() ) continue;
+            V[a].push_back(b);
+            V[b].push_back(a);
+        }
+
+        VI partition(N);
+        for( int & p : partition ) p = (int)rnd.nextInt(C+1) - 1; // some nodes are not considered (partition -1)
+
+        ClusterGraph g(&V, partition);
+        ClusterGraph g_par(&V, partition, &pool);
+
+        map<PII,int> edge_weights;
+        VI nw(g.N);
+        for( int i=0; i<N; i++ ){
+            if( g.partition[i] < 0 ) continue;
+            nw[ g.partition[i] ]++;
+            for( int d : V[i] ){
+                int a = g.partition[i], b = g.partition[d];
+                if( i < d && b >= 0 && a != b ) edge_weights[ { min(a,b), max(a,b) } ]++;
+            }
+        }
+        VVPII exp(g.N);
+        for( auto & [e,w] : edge_weights ){
+            exp[e.first].emplace_back(e.second, w);
+            exp[e.second].emplace_back(e.first, w);
+        }
+        for( auto & row : exp ) sort( ALL(row) );
+
+        ASSERT_EQ( g.V, exp );
+        ASSERT_EQ( g.node_weights, nw );
+        ASSERT_EQ( g.csr.toVV(), g.V );
+
+        ASSERT_EQ( g_par.V, g.V );
+        ASSERT_EQ( g_par.csr.hash(), g.csr.hash() );
+        ASSERT_EQ( g_par.clusterNodes, g.clusterNodes );
+    }
+}
@@ -33,8 +33,7 @@ public:
 //        clog << "g created: " << g << endl;
         clg = new ClusterGraph();
         clg->node_weights = nw;
-        clg->V = g;
-        clg->N = clg->V.size();
+        clg->setGraph(g);
 //        clog << "Cluster graph created" << endl;
 
         VI nodes(clg->N);
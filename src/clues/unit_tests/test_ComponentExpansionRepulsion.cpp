@@ -75,7 +75,7 @@ TEST_F(ComponentExpansionRepulsionFixture, test1){
             delete res.first;
 
             int N = cer.N;
-            ASSERT_EQ( cer.was, VB(2*N,false) );
+            ASSERT_EQ( cer.cl_local, VI(2*N,-1) );
             ASSERT_EQ( cer.inS, VB(N,false) );
             ASSERT_EQ( cer.cluster_weights, VI(cer.cluster_weights.size(),0) );
             ASSERT_EQ( cer.eInS, VI(cer.eInS.size(),0) );
@@ -84,11 +84,10 @@ TEST_F(ComponentExpansionRepulsionFixture, test1){
             ASSERT_TRUE(cer.cl_neigh.empty());
             ASSERT_EQ(cer.sumNWinS ,0);
 
-            for( int i=0; i<N; i++ ){
-                ASSERT_TRUE(cer.edges_to_cluster[i].empty() );
-                ASSERT_TRUE(cer.swpval_core_for_node[i].empty() );
-                ASSERT_TRUE(cer.cluster_sets[i].empty() );
-            }
+            ASSERT_TRUE(cer.ent_node.empty());
+            ASSERT_EQ( cer.entry_of, VI(N,-1) );
+            for( auto & heap : cer.heaps ) ASSERT_TRUE(heap.empty());
+            for( auto & ent : cer.cl_entries ) ASSERT_TRUE(ent.empty());
         }
 
         {
@@ -0,0 +1,230 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#include <utils/RandomNumberGenerators.h>
+#include "clues/heur/ComponentSolver.h"
+#include "clues/exact/CEBranchAndBound.h"
+#include "clues/heur/PaceUtils.h"
+#include "clues/heur/Global.h"
+#include "graphs/GraphUtils.h"
+#include "gtest/gtest.h"
+#include "CETestUtils.h"
+
+using namespace CETestUtils;
+
+/**
+ * Graph consists of many small components, some of them joined by single edges. Components are solved exactly, so
+ * the stitched partition must be optimal.
+ */
+TEST( ComponentSolver, test_decomposition ){
+    Global::startAlg();
+    UniformIntGenerator rnd(0, 1'000'000'000, 43);
+
+    for( int rep = 0; rep < 20; rep++ ){
+        int C = 1 + rnd.nextInt(10);
+        VVI V;
+        int opt = 0;
+        for( int c=0; c<C; c++ ){
+            VVI G = randomGraph( 1 + rnd.nextInt(7), 0.6, rnd );
+            opt += bruteForceResult(G);
+
+            appendGraph(V, G);
+        }
+
+        for( bool use_kernelization : {false,true} ){
+            Config cnf;
+            cnf.component_decomposition_use_kernelization = use_kernelization;
+            cnf.component_exact_max_size = 7;
+
+            ComponentSolver cs(V, cnf);
+            ASSERT_EQ( cs.countLargeComponents(), 0 );
+            cs.solveSmallComponents( 2, 10 );
+            ASSERT_TRUE( cs.large_components.empty() );
+
+            VI part = cs.getPartition();
+            ASSERT_EQ( PaceUtils::evaluateSolution(V, part), cs.getResult() );
+            ASSERT_EQ( cs.getResult(), opt );
+        }
+    }
+}
+
+/**
+ * Large components are solved using given function - here each component is solved exactly by CEBranchAndBound.
+ */
+TEST( ComponentSolver, test_solve_large_components ){
+    Global::startAlg();
+    UniformIntGenerator rnd(0, 1'000'000'000, 47);
+
+    VVI V;
+    int opt = 0;
+    for( int c=0; c<6; c++ ){
+        VVI G = randomGraph( 7, 0.5, rnd );
+        opt += bruteForceResult(G);
+
+        appendGraph(V, G);
+    }
+
+    Config cnf;
+    cnf.component_decomposition_use_kernelization = false;
+    cnf.component_exact_max_size = 3;
+    cnf.component_min_group_weight = 0;
+
+    ComponentSolver cs(V, cnf);
+    ASSERT_GT( cs.countLargeComponents(), 0 );
+    cs.solveSmallComponents( 2, 10 );
+    ASSERT_FALSE( cs.large_components.empty() );
+
+    VB solved( cs.components.size(), false );
+    cs.solveLargeComponents( 3, 10, [&]( int c, int thread_id, double deadline ){
+        VI part( cs.graphs[c].size() );
+        iota( ALL(part), 0 );
+        CEBranchAndBound bb( cs.graphs[c] );
+        ASSERT_TRUE( bb.solve(part) );
+        cs.updateBestPartition( c, bb.best_partition );
+        solved[c] = true;
+    } );
+
+    for( int c : cs.large_components ) ASSERT_TRUE( solved[c] );
+    VI part = cs.getPartition();
+    ASSERT_EQ( PaceUtils::evaluateSolution(V, part), cs.getResult() );
+    ASSERT_EQ( cs.getResult(), opt );
+}
+
+/**
+ * Small components that are not solved exactly are packed into groups of given weight.
+ */
+TEST( ComponentSolver, test_grouping ){
+    Global::startAlg();
+    UniformIntGenerator rnd(0, 1'000'000'000, 53);
+
+    VVI V;
+    for( int c=0; c<30; c++ ){
+        VVI G = randomGraph( 5 + rnd.nextInt(10), 0.5, rnd );
+        appendGraph(V, G);
+    }
+
+    for( int min_weight : {0, 50, 1'000'000} ){
+        Config cnf;
+        cnf.component_decomposition_use_kernelization = false;
+        cnf.component_exact_max_size = 4;
+        cnf.component_min_group_weight = min_weight;
+
+        ComponentSolver cs(V, cnf);
+        cs.solveSmallComponents( 2, 10 );
+        if( min_weight == 1'000'000 ) ASSERT_EQ( cs.large_components.size(), 1 );
+
+        VI cnt( V.size(), 0 );
+        for( VI & comp : cs.components ) for( int d : comp ) cnt[d]++;
+        ASSERT_EQ( cnt, VI( V.size(), 1 ) );
+
+        for( int i=0; i+1 < cs.large_components.size(); i++ ){ // only the last group may be lighter than the limit
+            int c = cs.large_components[i];
+            ASSERT_GE( cs.components[c].size() + GraphUtils::countEdges( cs.graphs[c] ), min_weight );
+        }
+
+        VI part = cs.getPartition();
+        ASSERT_EQ( PaceUtils::evaluateSolution(V, part), cs.getResult() );
+        for( int c : cs.large_components ){ // groups are initialized with singletons
+            ASSERT_EQ( cs.best_results[c], GraphUtils::countEdges( cs.graphs[c] ) );
+        }
+    }
+}
+
+/**
+ * Budgets of components are hard - Global::checkTle() returns true after the deadline of a component, also if the
+ * solving function does not check the deadline itself. Noisy components get larger budgets.
+ */
+TEST( ComponentSolver, test_hard_budgets ){
+    Global::startAlg();
+    UniformIntGenerator rnd(0, 1'000'000'000, 67);
+
+    VVI V;
+    for( int c=0; c<4; c++ ){
+        VVI G = randomGraph( 60, 0.5, rnd );
+        if( c >= 2 ){ // six cliques joined into a path - almost a cluster graph
+            G = VVI(60);
+            for( int a=0; a<60; a++ ) for( int b=0; b<60; b++ ){
+                if( a != b && ( a/10 == b/10 || ( b == a+1 && b % 10 == 0 ) || ( a == b+1 && a % 10 == 0 ) ) ){
+                    G[a].push_back(b);
+                }
+            }
+        }
+        appendGraph(V, G);
+    }
+
+    Config cnf;
+    cnf.component_decomposition_use_kernelization = false;
+    cnf.component_exact_max_size = 3;
+    cnf.component_min_group_weight = 0;
+
+    ComponentSolver cs(V, cnf);
+    cs.solveSmallComponents( 2, 10 );
+    ASSERT_EQ( cs.large_components.size(), 4 );
+
+    VD budgets( cs.components.size(), 0 );
+    mutex m;
+    const double seconds = 0.4;
+    cs.solveLargeComponents( 2, seconds, [&]( int c, int, double deadline ){
+        double start = Global::preciseSecondsFromStart();
+        while( !Global::checkTle() ){}
+        lock_guard<mutex> lock(m);
+        budgets[c] = Global::preciseSecondsFromStart() - start;
+        ASSERT_LE( Global::preciseSecondsFromStart(), deadline + 0.05 );
+    } );
+
+    ASSERT_FALSE( Global::checkTle() ); // deadline of the calling thread is reset
+
+    double total = 0;
+    for( double b : budgets ) total += b;
+    ASSERT_LE( total, 2 * seconds + 0.1 );
+
+    // components with nodes 0..59 and 60..119 are random graphs, far from cluster graphs
+    for( int c : cs.large_components ){
+        if( cs.components[c][0] < 120 ) continue;
+        for( int d : cs.large_components ) if( cs.components[d][0] < 120 ) ASSERT_GT( budgets[d], budgets[c] );
+    }
+}
+
+TEST( ComponentSolver, test_edit_density ){
+    VVI G(6);
+    auto addEdge = [&]( int a, int b ){ G[a].push_back(b); G[b].push_back(a); };
+    addEdge(0,1); addEdge(1,2); addEdge(0,2); // triangle
+    addEdge(3,4);
+    ASSERT_EQ( ComponentSolver::editDensity(G), 0 );
+
+    addEdge(2,3);
+    ASSERT_GT( ComponentSolver::editDensity(G), 0 );
+}
+
+/**
+ * Small components are solved within the total time limit - if it is used up, the remaining components are solved by
+ * the heuristic, starting from the best partition found.
+ */
+TEST( ComponentSolver, test_exact_time_limit ){
+    Global::startAlg();
+    UniformIntGenerator rnd(0, 1'000'000'000, 71);
+
+    VVI V;
+    for( int c=0; c<8; c++ ){
+        VVI G = randomGraph( 12, 0.5, rnd );
+        appendGraph(V, G);
+    }
+
+    Config cnf;
+    cnf.component_decomposition_use_kernelization = false;
+    cnf.component_exact_max_size = 12;
+    cnf.component_min_group_weight = 0;
+
+    for( double seconds : {0.0, 10.0} ){
+        ComponentSolver cs(V, cnf);
+        ASSERT_EQ( cs.countLargeComponents(), 0 );
+        cs.solveSmallComponents( 2, seconds );
+
+        if( seconds == 0 ) ASSERT_FALSE( cs.large_components.empty() );
+        else ASSERT_TRUE( cs.large_components.empty() );
+
+        VI part = cs.getPartition();
+        ASSERT_EQ( PaceUtils::evaluateSolution(V, part), cs.getResult() );
+    }
+}
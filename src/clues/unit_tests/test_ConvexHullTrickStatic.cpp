@@ -0,0 +1,134 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#include <utils/RandomNumberGenerators.h>
+#include <utils/TimeMeasurer.h>
+#include "clues/heur/ConvexHullTrickStatic.h"
+#include "clues/heur/ConvexHullTrickDynamic.h"
+#include "gtest/gtest.h"
+
+TEST( ConvexHullTrickStatic, test_maximize_1 ){
+
+    bool maximize = true;
+    ConvexHullTrickStatic hull( maximize );
+    hull.insert_line( 3,-3,0 );
+    hull.insert_line( 0,0,1 );
+    hull.insert_line( -1,3,2 );
+
+    ASSERT_EQ( hull.get_line_id( -100 ), 2  );
+    ASSERT_EQ( hull.get_line_id( -1 ), 2  );
+    ASSERT_EQ( hull.get_line_id( 0 ), 2  );
+    ASSERT_EQ( hull.get_line_id( 1 ), 2  );
+    ASSERT_EQ( hull.get_line_id( 2 ), 0  );
+    ASSERT_EQ( hull.get_line_id( 3 ), 0  );
+    ASSERT_EQ( hull.get_line_id( 100 ), 0  );
+
+    ASSERT_EQ( hull.size(), 2 ); // line 1 is always below one of the other lines
+}
+
+TEST( ConvexHullTrickStatic, test_minimize_1 ){
+
+    bool maximize = false;
+    ConvexHullTrickStatic hull( maximize );
+    hull.insert_line( 3,-3,0 );
+    hull.insert_line( 0,0,1 );
+    hull.insert_line( -1,3,2 );
+
+    ASSERT_EQ( hull.get_line_id( -100 ), 0  );
+    ASSERT_EQ( hull.get_line_id( 0 ), 0  );
+    ASSERT_TRUE( hull.get_line_id( 1 ) == 0 || hull.get_line_id( 1 ) == 1 );
+    ASSERT_EQ( hull.get_line_id( 2 ), 1  );
+    ASSERT_TRUE( hull.get_line_id( 3 ) == 1 || hull.get_line_id( 3 ) == 2 );
+    ASSERT_EQ( hull.get_line_id( 4 ), 2  );
+    ASSERT_EQ( hull.get_line_id( 100 ), 2  );
+
+    hull.clear();
+    hull.insert_line( 5,0,7 );
+    hull.insert_line( 5,-1,8 );
+    hull.insert_line( 5,-1,9 ); // identical to line 8, the first one should be kept
+    ASSERT_EQ( hull.size(), 1 );
+    ASSERT_EQ( hull.get_line_id( 3 ), 8 );
+}
+
+/**
+ * Compares ConvexHullTrickStatic with ConvexHullTrickDynamic and brute force on random integer lines - as in edge
+ * swaps, slopes are weights of clusters and there are many lines with the same slope and many ties.
+ */
+TEST( ConvexHullTrickStatic, test_random ){
+    UniformIntGenerator rnd(0, 1'000'000'000, 17);
+
+    for( int rep = 0; rep < 500; rep++ ){
+        bool maximize = rep & 1;
+        int n = 1 + rnd.nextInt(60);
+        int M = 1 + rnd.nextInt(30);
+
+        vector<PII> lines(n);
+        for( auto & [m,b] : lines ){
+            m = rnd.nextInt(M);
+            b = -(int)rnd.nextInt(4*M);
+        }
+
+        ConvexHullTrickStatic hull(maximize), hull_walk(maximize);
+        ConvexHullTrickDynamic dyn(maximize);
+        for( int i=0; i<n; i++ ){
+            hull.insert_line( lines[i].first, lines[i].second, i );
+            hull_walk.insert_line( lines[i].first, lines[i].second, i );
+            dyn.insert_line( lines[i].first, lines[i].second, i );
+        }
+
+        ASSERT_EQ( hull.size(), dyn.size() );
+
+        for( int x = -10; x <= 3*M; x++ ){
+            LL opt = maximize ? numeric_limits<LL>::min() : numeric_limits<LL>::max();
+            for( auto & [m,b] : lines ){
+                LL val = 1ll * m * x + b;
+                opt = maximize ? max(opt,val) : min(opt,val);
+            }
+
+            int id = hull.get_line_id(x);
+            ASSERT_EQ( 1ll * lines[id].first * x + lines[id].second, opt );
+            ASSERT_EQ( id, dyn.get_line_id(x) );
+            ASSERT_EQ( hull_walk.get_line_id_nondecreasing(x), id );
+        }
+    }
+}
+
+/**
+ * Benchmark of building hulls and querying them as in edge swaps - for each node a hull of lines for its neighboring
+ * clusters is built and queried for each neighbor.
+ */
+TEST( ConvexHullTrickStatic, test_performance ){
+    UniformIntGenerator rnd(0, 1'000'000'000, 19);
+
+    const int REPS = 2'000, LINES = 100, QUERIES = 100;
+    vector<PII> lines(LINES);
+    VI queries(QUERIES);
+    ConvexHullTrickStatic hull;
+
+    LL sum_static = 0, sum_dynamic = 0;
+    for( int rep = 0; rep < REPS; rep++ ){
+        for( auto & [m,b] : lines ){
+            m = 1 + rnd.nextInt(1000);
+            b = -2 * (int)rnd.nextInt(1000);
+        }
+        for( int & x : queries ) x = 2 + rnd.nextInt(20);
+
+        TimeMeasurer::start("static hull");
+        hull.clear();
+        hull.insert_line(0,0,-1);
+        for( int i=0; i<LINES; i++ ) hull.insert_line( lines[i].first, lines[i].second, i );
+        for( int x : queries ) sum_static += hull.get_line_id(x);
+        TimeMeasurer::stop("static hull");
+
+        TimeMeasurer::start("dynamic hull");
+        ConvexHullTrickDynamic dyn;
+        dyn.insert_line(0,0,-1);
+        for( int i=0; i<LINES; i++ ) dyn.insert_line( lines[i].first, lines[i].second, i );
+        for( int x : queries ) sum_dynamic += dyn.get_line_id(x);
+        TimeMeasurer::stop("dynamic hull");
+    }
+
+    ASSERT_EQ( sum_static, sum_dynamic );
+    TimeMeasurer::writeAllMeasurements();
+}
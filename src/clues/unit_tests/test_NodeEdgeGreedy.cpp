@@ -6,6 +6,8 @@
 #include <clues/heur/PaceUtils.h>
 #include <clues/heur/SwapCandidates/SwpCndNode.h>
 #include <clues/heur/StateImprovers/NodeEdgeGreedy.h>
+#include <clues/heur/Global.h>
+#include <clues/heur/SwapValueKernels.h>
 #include "clues/test_graphs.h"
 #include "gtest/gtest.h"
 
@@ -37,6 +39,24 @@ public:
         clog.rdbuf(old_clog_buf );
     }
 
+    /**
+     * @return graph with [K] disjoint cliques of size [S] and [random_edges] random edges between them (some may be
+     * skipped if they are duplicates or join nodes of the same clique). Neighbors are sorted.
+     */
+    static VVI cliquesWithRandomEdges( int K, int S, int random_edges ){
+        VVI V(K*S);
+        for( int k=0; k<K; k++ ){
+            for( int a=0; a<S; a++ ) for( int b=a+1; b<S; b++ ) GraphUtils::addEdge( V, k*S+a, k*S+b );
+        }
+        UniformIntGenerator gen(0, K*S-1);
+        for( int j=0; j<random_edges; j++ ){
+            int a = gen.rand(), b = gen.rand();
+            if( a/S != b/S && !GraphUtils::containsEdge(V,a,b) ) GraphUtils::addEdge(V,a,b);
+        }
+        for( auto & neigh : V ) sort(ALL(neigh));
+        return V;
+    }
+
     static ClusterGraph *clg;
     static streambuf* old_clog_buf;
     static State* st;
@@ -210,4 +230,177 @@ TEST_F( NEGreedyFixture, test_chain2_swaps2 ){
 
 
     SUCCEED() << "THIS TEST HAS NO ASSERTIONS!!" << endl;
-}
\ No newline at end of file
+}
+TEST_F( NEGreedyFixture, test_node_move_cache ){
+    Global::startAlg(); // otherwise improve() terminates immediately due to time limit
+
+    for( int i=0; i<5; i++ ){
+        VVI V = cliquesWithRandomEdges( 12, 5, 12 );
+
+        VI partition(V.size());
+        iota(ALL(partition),0);
+        ClusterGraph clg(&V, partition);
+
+        State st(clg, SINGLE_NODES);
+
+        NodeEdgeGreedy neg(st);
+        neg.move_frequency = 2;
+        neg.use_edge_swaps = neg.use_triangle_swaps = neg.use_node_interchanging = neg.use_join_clusters =
+        neg.use_chain2_swaps = false;
+        neg.allow_perturbations = false;
+        neg.node_move_cache_min_size = 0; // nodes of such small graphs have few neighbors
+
+        neg.improve();
+        ASSERT_TRUE( neg.compareCurrentResultWithBruteResult() );
+
+        // each valid entry must keep the current swap value of its move
+        int moved = -1, moved_to = -1;
+        for( int v=0; v<neg.N; v++ ){
+            int to, val;
+            if( !neg.getCachedNodeMove(v, to, val) || to == -1 ) continue;
+
+            int cl_v = neg.inCl[v];
+            int nw_v = clg.node_weights[v];
+            int exact = neg.swapValueForNode( v, to, neg.findEdgesToCluster(v,cl_v),
+                                              (neg.cluster_weights[cl_v] - nw_v) * nw_v, neg.findEdgesToCluster(v,to) );
+            ASSERT_EQ( val, exact );
+            moved = v;
+            moved_to = to;
+        }
+        ASSERT_NE( moved, -1 );
+
+        // moving a node invalidates entries of that node and all its neighbors
+        neg.moveNodeTo( moved, moved_to );
+        int to, val;
+        ASSERT_FALSE( neg.getCachedNodeMove(moved, to, val) );
+        for( int p : V[moved] ) ASSERT_FALSE( neg.getCachedNodeMove(p, to, val) );
+
+        neg.clearNodeMoveCache();
+        for( int v=0; v<neg.N; v++ ) ASSERT_FALSE( neg.getCachedNodeMove(v, to, val) );
+    }
+}
+
+TEST_F( NEGreedyFixture, test_parallel_node_moves ){
+    Global::startAlg(); // otherwise improve() terminates immediately due to time limit
+
+    ThreadPool pool1(1), pool3(3);
+
+    for( int i=0; i<6; i++ ){
+        // every second graph is sparse - mostly single edges, each node has only a few neighboring clusters
+        VVI V = (i % 2 == 0) ? cliquesWithRandomEdges( 30, 6, 90 ) : cliquesWithRandomEdges( 150, 2, 150 );
+
+        VI partition(V.size());
+        iota(ALL(partition),0);
+        ClusterGraph clg(&V, partition);
+
+        VI results;
+        const int int_seed = UniformIntGenerator::lastSeed, double_seed = UniformDoubleGenerator::lastSeed;
+        for( ThreadPool* pool : {&pool1, &pool3} ){
+            // both runs use the same random choices - sparse graphs have many local optima
+            UniformIntGenerator::lastSeed = int_seed;
+            UniformDoubleGenerator::lastSeed = double_seed;
+            State st(clg, SINGLE_NODES);
+
+            NodeEdgeGreedy neg(st);
+            neg.pool = pool;
+            neg.parallel_batch_size = 16;
+            neg.allow_perturbations = false;
+
+            neg.improve();
+            ASSERT_TRUE( neg.compareCurrentResultWithBruteResult() );
+            ASSERT_LT( neg.current_result, neg.initial_result );
+            results.push_back( neg.current_result );
+        }
+
+        // moves applied in batches do not depend on the number of threads
+        ASSERT_EQ( results[0], results[1] );
+    }
+}
+
+TEST_F( NEGreedyFixture, test_evaluate_node_move ){
+    for( int i=0; i<5; i++ ){
+        VVI V = cliquesWithRandomEdges( 20, 12, 2500 );
+
+        VI partition(V.size());
+        iota(ALL(partition),0);
+        ClusterGraph clg(&V, partition);
+
+        State st(clg, SINGLE_NODES);
+        NodeEdgeGreedy neg(st);
+
+        UniformIntGenerator gen(0, 1e9);
+        for( int v=0; v<neg.N; v++ ){ // some clusters with different weights
+            int u = V[v][ gen.rand() % V[v].size() ];
+            if( gen.rand() % 2 ) neg.moveNodeTo( v, neg.inCl[u] );
+        }
+
+        const int empty_cl = *neg.first_free_cluster.begin();
+        neg.resizeStructuresForEmptyCluster(empty_cl);
+
+        // NodeEdgeGreedy version (reading edges_to_cluster directly) must give the same results as the one from NEG,
+        // and vectorized search for nodes with many neighboring clusters must give the same results as scalar one
+        for( int v=0; v<neg.N; v++ ){
+            int to, val, to_base, val_base, to_scalar, val_scalar;
+            VI ties, ties_base, ties_scalar;
+            neg.evaluateNodeMove( v, empty_cl, to, val, &ties );
+            neg.NEG::evaluateNodeMove( v, empty_cl, to_base, val_base, &ties_base );
+
+            SwapValueKernels::simd_level = SwapValueKernels::SCALAR;
+            neg.evaluateNodeMove( v, empty_cl, to_scalar, val_scalar, &ties_scalar );
+            SwapValueKernels::simd_level = SwapValueKernels::detectedSimdLevel();
+
+            ASSERT_EQ( val, val_base );
+            ASSERT_EQ( val, val_scalar );
+            ASSERT_EQ( to, to_scalar );
+            ASSERT_EQ( ties, ties_scalar );
+            sort(ALL(ties));
+            sort(ALL(ties_base));
+            ASSERT_EQ( ties, ties_base );
+            if( to_base != -1 ) ASSERT_TRUE( binary_search( ALL(ties), to ) );
+            else ASSERT_EQ( to, -1 );
+        }
+    }
+}
+
+TEST_F( NEGreedyFixture, test_gain_buckets ){
+    Global::startAlg(); // otherwise improve() terminates immediately due to time limit
+
+    for( int i=0; i<5; i++ ){
+        VVI V = cliquesWithRandomEdges( 12, 5, 12 );
+
+        VI partition(V.size());
+        iota(ALL(partition),0);
+        ClusterGraph clg(&V, partition);
+
+        State st(clg, SINGLE_NODES);
+
+        NodeEdgeGreedy neg(st);
+        neg.move_frequency = 2;
+        neg.use_gain_buckets = true;
+        neg.allow_perturbations = false;
+
+        neg.improve();
+        ASSERT_TRUE( neg.compareCurrentResultWithBruteResult() );
+        ASSERT_LT( neg.current_result, neg.initial_result );
+
+        // after a move, key of the moved node is the swap value of its current best move, and keys of its neighbors
+        // are lower bounds on swap values of their best moves
+        neg.use_queue_propagation = false;
+        int v = i, to = neg.inCl[ V[v][0] ] == neg.inCl[v] ? *neg.first_free_cluster.begin() : neg.inCl[ V[v][0] ];
+        neg.resizeStructuresForEmptyCluster(to);
+        neg.moveNodeTo( v, to );
+        neg.updateGainBuckets();
+        ASSERT_TRUE( neg.gain_moved_nodes.empty() );
+
+        const int empty_cl = *neg.first_free_cluster.begin();
+        neg.resizeStructuresForEmptyCluster(empty_cl);
+        int v_to, v_val;
+        neg.evaluateNodeMove( v, empty_cl, v_to, v_val );
+        ASSERT_EQ( neg.gain_key[v], v_val );
+        for( int d : V[v] ){
+            int d_to, d_val;
+            neg.evaluateNodeMove( d, empty_cl, d_to, d_val );
+            ASSERT_LE( neg.gain_key[d], d_val );
+        }
+    }
+}
@@ -3,6 +3,7 @@
 //
 
 #include <graphs/GraphUtils.h>
+#include <utils/RandomNumberGenerators.h>
 #include <clues/heur/PaceUtils.h>
 #include <clues/heur/SwapCandidates/SwpCndNode.h>
 #include <clues/heur/SwapCandidates/SwpCndTriangle.h>
@@ -269,7 +270,8 @@ TEST_F(SolverFixture, testOverall_2) {
             {{0, 1, 6, 7, 8}, {2}, {3, 4, 5}, {9}, {10, 11, 13, 14}, {12, 15}},
             {{0, 1, 6, 7, 8}, {2}, {3, 4, 5}, {9, 10}, {11, 12}, {13, 14, 15}},
             {{0, 1, 6, 7}, {2}, {3, 4, 5}, {8, 9, 10}, {11, 12}, {13, 14, 15}},
-            {{0, 1, 2, 6, 7}, {3, 4, 5}, {8, 9, 10, 11}, {12}, {13, 14, 15}}
+            {{0, 1, 2, 6, 7}, {3, 4, 5}, {8, 9, 10, 11}, {12}, {13, 14, 15}},
+            {{0, 1, 2, 6, 7}, {3, 4, 5}, {8, 9, 10}, {11, 12}, {13, 14, 15}}
     };
 
 
@@ -363,4 +365,64 @@ TEST_F(SolverFixture, testApplySwap){
     ASSERT_EQ( solver.st->inCl[5], solver.st->inCl[7] );
 
     solver.st = nullptr; // this will be deleted in Fixture::TearDown
-}
\ No newline at end of file
+}
+TEST_F(SolverFixture, getModifications){
+    Config cnf;
+    VI initial_partition = CE_test_graphs::swpcndedge_test2_partition;
+    Solver solver( V, initial_partition, cnf );
+
+    VPII mods = solver.getModifications();
+    EXPECT_EQ( mods.size(), solver.best_result );
+    EXPECT_TRUE( is_sorted(ALL(mods)) );
+
+    // after applying modifications, each cluster should be a clique and there should be no edges between clusters
+    int N = V.size();
+    set<PII> edges;
+    for( int i=0; i<N; i++ ) for( int d : V[i] ) if( i < d ) edges.insert({i,d});
+    for( auto e : mods ){
+        ASSERT_LT( e.first, e.second );
+        if( edges.count(e) ) edges.erase(e);
+        else edges.insert(e);
+    }
+
+    VI & part = solver.best_partition;
+    for( int i=0; i<N; i++ ){
+        for( int j=i+1; j<N; j++ ) EXPECT_EQ( edges.count({i,j}) == 1, part[i] == part[j] );
+    }
+}
+
+/**
+ * Radix sort in [sortCandidatesBySwpVal] must give the same order as stable_sort by swap value, including order of
+ * candidates with equal values. swpVal() should be called only once per candidate.
+ */
+TEST_F(SolverFixture, sortCandidatesBySwpVal){
+    Config cnf;
+    VI initial_partition = CE_test_graphs::swpcndedge_test2_partition;
+    Solver solver( V, initial_partition, cnf );
+
+    class CountingCnd : public SwapCandidateAdapter{
+    public:
+        int calls = 0;
+        virtual LL swpVal()override{ calls++; return swap_value; }
+    };
+
+    UniformIntGenerator rnd(0, 1'000'000'000, 23);
+    for( int range : {1, 7, 300, 70'000, 20'000'000} ){
+        for( int n : {0, 1, 2, 50, 1000} ){
+            vector<CountingCnd> cnds(n);
+            for( auto & c : cnds ) c.swap_value = rnd.nextInt(range) - range/2;
+
+            vector<SwapCandidate*> candidates;
+            for( auto & c : cnds ) candidates.push_back(&c);
+
+            vector<SwapCandidate*> expected = candidates;
+            stable_sort( ALL(expected), []( SwapCandidate* a, SwapCandidate* b ){
+                return ((CountingCnd*)a)->swap_value < ((CountingCnd*)b)->swap_value;
+            } );
+
+            solver.sortCandidatesBySwpVal(candidates);
+            ASSERT_EQ( candidates, expected );
+            for( auto & c : cnds ) ASSERT_LE( c.calls, 1 );
+        }
+    }
+}
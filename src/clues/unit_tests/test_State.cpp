@@ -211,6 +211,98 @@ TEST_F( StateFixture, apply_swap ) {
     }
 }
 
+TEST_F( StateFixture, apply_swap_incremental ) {
+    State st(*clg, SINGLE_NODES);
+    VVI to_merge = { {0,1,2,3}, {4,5}, {6,8} };
+    st.mergeClusters(to_merge);
+    st.createClNeighGraph();
+
+    // cluster {4,5} becomes empty, {3} and {2} are moved to new clusters
+    VPII to_swap = {{4, st.inCl[0]},
+                    {5, st.inCl[7]},
+                    {3, st.getIdOfEmptyCluster()},
+                    {2, st.getIdOfEmptyCluster()+3},
+                    {6, st.inCl[6]} // not moved at all
+    };
+    st.applySwap(to_swap);
+
+    ASSERT_EQ(st.inCl[0], st.inCl[4]);
+    ASSERT_EQ(st.inCl[0], st.inCl[1]);
+    ASSERT_EQ(st.inCl[5], st.inCl[7]);
+    ASSERT_EQ(st.inCl[6], st.inCl[8]);
+    ASSERT_NE(st.inCl[2], st.inCl[3]);
+
+    // clusters: {0,1,4}, {2}, {3}, {5,7}, {6,8} and the empty one
+    ASSERT_EQ( st.clusters.size(), 6 );
+    ASSERT_EQ( st.clusters.back().size(), 0 );
+    for( int i=0; i<st.clusters.size(); i++ ){
+        ASSERT_EQ( st.clusters[i].id, i );
+        if( i+1 < st.clusters.size() ) ASSERT_GT( st.clusters[i].size(), 0 );
+    }
+
+    for( int d=0; d<st.N; d++ ){
+        Cluster & cl = st.clusters[ st.inCl[d] ];
+        ASSERT_EQ( cl.g.nodes[ st.idInCl[d] ], d );
+
+        int deg = 0;
+        for( auto & [p,w] : clg->V[d] ) if( st.inCl[p] == st.inCl[d] ) deg += w;
+        ASSERT_EQ( st.degInCl[d], deg );
+    }
+
+    State fresh = st;
+    fresh.cl_neigh_graph.clear();
+    fresh.createClNeighGraph();
+    ASSERT_EQ( st.cl_neigh_graph, fresh.cl_neigh_graph );
+
+    State rebuilt(*clg, SINGLE_NODES);
+    rebuilt.applyPartition( st.inCl );
+    ASSERT_EQ( st.calculateResultForState(), rebuilt.calculateResultForState() );
+}
+
+TEST_F( StateFixture, apply_swap_moved_twice ) {
+    State st(*clg, SINGLE_NODES);
+    VVI to_merge = { {0,1,2,3}, {4,5}, {6,8} };
+    st.mergeClusters(to_merge);
+
+    // 4 is moved to a new cluster and then back to a nonempty one - the new cluster must not be left behind
+    VPII to_swap = { {7, st.inCl[6]}, {4, st.getIdOfEmptyCluster()+1}, {4, st.inCl[2]} };
+    st.applySwap(to_swap);
+
+    ASSERT_EQ( st.inCl[4], st.inCl[0] );
+    ASSERT_EQ( st.inCl[7], st.inCl[6] );
+    ASSERT_EQ( st.clusters.back().size(), 0 );
+    for( int i=0; i<st.clusters.size(); i++ ){
+        ASSERT_EQ( st.clusters[i].id, i );
+        if( i+1 < st.clusters.size() ) ASSERT_GT( st.clusters[i].size(), 0 );
+    }
+}
+
+TEST_F( StateFixture, apply_swap_cl_neigh_graph ) {
+    State st(*clg, SINGLE_NODES);
+    VVI to_merge = { {0,1,2,3}, {4,5}, {6,8} };
+    st.mergeClusters(to_merge);
+    ASSERT_TRUE( st.cl_neigh_graph.empty() ); // created lazily after merging
+    st.createClNeighGraph();
+
+    VVPII swaps = {
+            { {0, st.getIdOfEmptyCluster()}, {1, st.getIdOfEmptyCluster()} },
+            { {7, st.inCl[6]}, {4, st.getIdOfEmptyCluster()+1}, {4, st.inCl[2]} }, // 4 is moved twice
+            { {6, st.inCl[2]}, {8, st.inCl[2]}, {7, st.inCl[5]} },
+    };
+
+    for( auto & to_swap : swaps ){
+        st.applySwap(to_swap);
+
+        ASSERT_EQ( st.clusters.back().size(), 0 );
+        for( int i=0; i+1<st.clusters.size(); i++ ) ASSERT_GT( st.clusters[i].size(), 0 );
+
+        State fresh = st;
+        fresh.cl_neigh_graph.clear();
+        fresh.createClNeighGraph();
+        ASSERT_EQ( st.cl_neigh_graph, fresh.cl_neigh_graph );
+    }
+}
+
 TEST_F(StateFixture, calculate_state_result){
     State st(*clg, SINGLE_NODES);
     {
@@ -0,0 +1,78 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#include <utils/RandomNumberGenerators.h>
+#include "clues/heur/SwapValueKernels.h"
+#include "gtest/gtest.h"
+
+using namespace SwapValueKernels;
+
+/**
+ * @return all simd levels supported by the processor
+ */
+static vector<SimdLevel> supportedLevels(){
+    vector<SimdLevel> res;
+    for( int l = SCALAR; l <= detectedSimdLevel(); l++ ) res.push_back( (SimdLevel)l );
+    return res;
+}
+
+TEST( SwapValueKernels, test_small ){
+    VI edge_w = {3, 5, 1, 5};
+    VI cl_w = {4, 6, 1, 6};
+    int min_val;
+
+    // values are 4-6 = -2, 6-10 = -4, 1-2 = -1, -4
+    ASSERT_EQ( argminMoveValue( edge_w.data(), cl_w.data(), 4, 1, min_val ), 1 );
+    ASSERT_EQ( min_val, -4 );
+
+    ASSERT_EQ( argminMoveValue( edge_w.data(), cl_w.data(), 0, 1, min_val ), -1 );
+
+    VPII items = { {7,3}, {2,5}, {0,1} };
+    VI cluster_weights = {1, 0, 6, 0, 0, 0, 0, 4};
+    ASSERT_EQ( argminMoveValuePairs( items.data(), 3, cluster_weights.data(), 3, 1, min_val ), 1 );
+    ASSERT_EQ( min_val, -4 );
+    ASSERT_EQ( argminMoveValuePairs( items.data(), 3, cluster_weights.data(), 2, 1, min_val ), 0 );
+    ASSERT_EQ( min_val, -2 );
+
+    VPII single = { {2,5} };
+    ASSERT_EQ( argminMoveValuePairs( single.data(), 1, cluster_weights.data(), 2, 1, min_val ), -1 );
+}
+
+TEST( SwapValueKernels, test_random_all_levels ){
+    UniformIntGenerator rnd(0, 1'000'000'000, 11);
+    const SimdLevel old_level = simd_level;
+
+    for( int rep = 0; rep < 2000; rep++ ){
+        int n = rnd.nextInt(100);
+        int C = 1 + rnd.nextInt(200);
+        int nw = 1 + rnd.nextInt(5);
+        int max_w = 1 + rnd.nextInt(30); // small weights, so that there are many ties
+
+        VI edge_w(n), cl_w(n), cluster_weights(C);
+        VPII items(n);
+        for( int i=0; i<C; i++ ) cluster_weights[i] = 1 + rnd.nextInt(max_w);
+        for( int i=0; i<n; i++ ){
+            items[i] = { rnd.nextInt(C), 1 + rnd.nextInt(max_w) };
+            edge_w[i] = items[i].second;
+            cl_w[i] = cluster_weights[ items[i].first ];
+        }
+        int skip_id = rnd.nextInt(C);
+
+        int exp_val = 0, exp_pairs_val = 0;
+        int exp = argminMoveValueScalar( edge_w.data(), cl_w.data(), n, nw, exp_val );
+        int exp_pairs = argminMoveValuePairsScalar( items.data(), n, cluster_weights.data(), skip_id, nw, exp_pairs_val );
+
+        for( SimdLevel l : supportedLevels() ){
+            simd_level = l;
+            int val = 0, pairs_val = 0;
+            ASSERT_EQ( argminMoveValue( edge_w.data(), cl_w.data(), n, nw, val ), exp );
+            if( exp != -1 ) ASSERT_EQ( val, exp_val );
+
+            ASSERT_EQ( argminMoveValuePairs( items.data(), n, cluster_weights.data(), skip_id, nw, pairs_val ), exp_pairs );
+            if( exp_pairs != -1 ) ASSERT_EQ( pairs_val, exp_pairs_val );
+        }
+    }
+
+    simd_level = old_level;
+}
@@ -0,0 +1,151 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#include <utils/RandomNumberGenerators.h>
+#include "datastructures/AdaptiveIntMap.h"
+#include "gtest/gtest.h"
+
+typedef AdaptiveIntMap<> AIM;
+
+/**
+ * Checks that [m] contains exactly items from [exp], and that the table of positions (if used) is consistent.
+ */
+static void assertSameItems( AIM & m, map<int,int> & exp ){
+    ASSERT_EQ( m.size(), exp.size() );
+    map<int,int> items( m.begin(), m.end() );
+    ASSERT_EQ( items, exp );
+    for( auto [k,v] : exp ){
+        ASSERT_TRUE( m.contains(k) );
+        ASSERT_EQ( m.get(k), v );
+        ASSERT_EQ( m.find(k)->first, k );
+    }
+
+    if( m.isHashed() ){
+        int used = 0;
+        for( int i=0; i<m.heap.table_size; i++ ) if( m.heap.table[i] != -1 ) used++;
+        ASSERT_EQ( used, m.size() );
+        ASSERT_GE( m.heap.table_size, 2 * m.size() );
+    }
+}
+
+TEST( AdaptiveIntMap, test_inline ){
+    AIM m;
+    for( int i=0; i<6; i++ ) m[10*i] = i+1;
+    ASSERT_FALSE( m.large );
+    ASSERT_EQ( m.get(30), 4 );
+    ASSERT_EQ( m.get(31), 0 );
+    ASSERT_EQ( m.find(31), m.end() );
+
+    m.erase(0); // last item is moved to the place of the erased one
+    ASSERT_EQ( m.begin()->first, 50 );
+    ASSERT_EQ( m.size(), 5 );
+
+    m.transfer( 50, 20, 6 ); // moves whole value to an existing key - item 50 is erased
+    ASSERT_FALSE( m.contains(50) );
+    ASSERT_EQ( m.get(20), 9 );
+
+    m.transfer( 20, 70, 9 ); // item just changes its key
+    ASSERT_FALSE( m.contains(20) );
+    ASSERT_EQ( m.get(70), 9 );
+    ASSERT_EQ( m.size(), 4 );
+
+    m[80] = 1; m[90] = 1;
+    ASSERT_FALSE( m.large );
+    m[100] = 1; // seventh item - moved to the heap
+    ASSERT_TRUE( m.large );
+    ASSERT_FALSE( m.isHashed() );
+    ASSERT_EQ( m.get(70), 9 );
+}
+
+/**
+ * Keys collide in the probing table (all keys are multiples of its size), so erasing must shift items backwards.
+ */
+TEST( AdaptiveIntMap, test_backward_shift ){
+    AIM m;
+    map<int,int> exp;
+    for( int i=0; i<40; i++ ){
+        m[ i * 1024 ] = i+1;
+        exp[ i * 1024 ] = i+1;
+    }
+    ASSERT_TRUE( m.isHashed() );
+    assertSameItems(m, exp);
+
+    for( int i=0; i<40; i += 3 ){
+        m.erase( i * 1024 );
+        exp.erase( i * 1024 );
+        assertSameItems(m, exp);
+    }
+
+    for( int i=100; i<120; i++ ){
+        m[i] = 1;
+        exp[i] = 1;
+    }
+    assertSameItems(m, exp);
+}
+
+TEST( AdaptiveIntMap, test_random ){
+    UniformIntGenerator rnd(0, 1'000'000'000, 31);
+
+    for( int rep = 0; rep < 30; rep++ ){
+        int K = 3 + rnd.nextInt(80); // number of possible keys - maps of all sizes are tested
+        AIM m;
+        map<int,int> exp;
+
+        for( int it = 0; it < 2000; it++ ){
+            int key = rnd.nextInt(K) * 37;
+            int op = rnd.nextInt(4);
+
+            if( op == 0 ){
+                int v = 1 + rnd.nextInt(10);
+                m[key] += v;
+                exp[key] += v;
+            }else if( op == 1 ){
+                m.erase(key);
+                exp.erase(key);
+            }else if( op == 2 && !exp.empty() ){
+                int from = next( exp.begin(), rnd.nextInt(exp.size()) )->first;
+                if( from == key ) continue;
+                int w = 1 + rnd.nextInt( exp[from] );
+                m.transfer( from, key, w );
+                exp[from] -= w;
+                exp[key] += w;
+                if( exp[from] == 0 ) exp.erase(from);
+            }else if( rnd.nextInt(100) == 0 ){
+                m.clear();
+                exp.clear();
+            }
+
+            assertSameItems(m, exp);
+        }
+    }
+}
+
+TEST( AdaptiveIntMap, test_copy_and_move ){
+    for( int n : {3, 10, 40} ){
+        AIM m;
+        map<int,int> exp;
+        for( int i=0; i<n; i++ ){ m[i] = i+1; exp[i] = i+1; }
+
+        AIM c = m;
+        c[1000] = 1;
+        assertSameItems(m, exp);
+
+        AIM moved( std::move(m) );
+        assertSameItems(moved, exp);
+        ASSERT_EQ( m.size(), 0 ); // source of the move is left empty and usable
+        ASSERT_EQ( m.begin(), m.end() );
+        m[5] = 7;
+        ASSERT_EQ( m.get(5), 7 );
+
+        AIM assigned;
+        assigned = std::move(moved);
+        assertSameItems(assigned, exp);
+
+        vector<AIM> maps(3);
+        maps[0] = c;
+        maps.resize(100); // reallocation moves maps
+        ASSERT_EQ( maps[0].size(), n+1 );
+        ASSERT_EQ( maps[0].get(1000), 1 );
+    }
+}
@@ -0,0 +1,66 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#include <utils/RandomNumberGenerators.h>
+#include "datastructures/GainBuckets.h"
+#include "gtest/gtest.h"
+
+/**
+ * Random operations are compared with a set of pairs (key, id). Ids with equal keys may be popped in any order, so
+ * only keys of popped ids are compared.
+ */
+TEST( GainBuckets, test_random ){
+    UniformIntGenerator rnd(0, 1'000'000'000, 17);
+
+    const int N = 200, MAX_KEY = 30;
+    GainBuckets gb( N, MAX_KEY );
+    VI key(N,0);
+    set<PII> s;
+
+    for( int it = 0; it < 20'000; it++ ){
+        int id = rnd.nextInt(N);
+        int op = rnd.nextInt(4);
+
+        if( op == 0 ){ // insert or update, keys out of range are clamped
+            if( gb.contains(id) ) s.erase( {key[id], id} );
+            int k = rnd.nextInt( 2*MAX_KEY + 21 ) - MAX_KEY - 10;
+            gb.update( id, k );
+            key[id] = max( -MAX_KEY, min( MAX_KEY, k ) );
+            s.insert( {key[id], id} );
+            ASSERT_EQ( gb.key(id), key[id] );
+        }else if( op == 1 ){
+            if( !gb.contains(id) ) continue;
+            s.erase( {key[id], id} );
+            gb.remove(id);
+        }else if( op == 2 ){
+            if( gb.empty() ) continue;
+            int k = gb.minKey();
+            ASSERT_EQ( k, s.begin()->first );
+            int v = gb.pop();
+            ASSERT_EQ( key[v], k );
+            ASSERT_FALSE( gb.contains(v) );
+            s.erase( {key[v], v} );
+        }else if( rnd.nextInt(50) == 0 ){
+            gb.clear();
+            s.clear();
+            for( int v=0; v<N; v++ ) ASSERT_FALSE( gb.contains(v) );
+        }
+
+        ASSERT_EQ( gb.size(), s.size() );
+        if( !gb.empty() ) ASSERT_EQ( gb.minKey(), s.begin()->first );
+    }
+}
+
+/**
+ * Ids with equal keys are popped in LIFO order.
+ */
+TEST( GainBuckets, test_lifo ){
+    GainBuckets gb( 10, 5 );
+    for( int v : {3,7,1} ) gb.update( v, -2 );
+    gb.update( 4, 0 );
+
+    VI order;
+    while( !gb.empty() ) order.push_back( gb.pop() );
+    ASSERT_EQ( order, VI({1,7,3,4}) );
+}
@@ -0,0 +1,92 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#include <utils/RandomNumberGenerators.h>
+#include "datastructures/IndexedHeap.h"
+#include "gtest/gtest.h"
+
+struct PriorityCmp{
+    VI* prio;
+    bool operator()( int a, int b ) const{ return (*prio)[a] < (*prio)[b] || ( (*prio)[a] == (*prio)[b] && a < b ); }
+};
+
+static_assert( !is_copy_constructible< IndexedHeap<PriorityCmp> >::value );
+static_assert( !is_copy_assignable< IndexedHeap<PriorityCmp> >::value );
+static_assert( is_move_constructible< IndexedHeap<PriorityCmp> >::value );
+
+/**
+ * Random operations are compared with a set of pairs (priority, id).
+ */
+TEST( IndexedHeap, test_random ){
+    UniformIntGenerator rnd(0, 1'000'000'000, 17);
+
+    const int N = 200;
+    VI prio(N,0), pos(N,-1);
+    IndexedHeap<PriorityCmp> h( &pos, PriorityCmp{&prio} );
+    set<PII> s;
+
+    for( int it = 0; it < 20'000; it++ ){
+        int id = rnd.nextInt(N);
+        int op = rnd.nextInt(5);
+
+        if( op == 0 ){
+            if( h.contains(id) ) continue;
+            prio[id] = rnd.nextInt(100);
+            h.push(id);
+            s.insert( {prio[id], id} );
+        }else if( op == 1 ){
+            if( !h.contains(id) ) continue;
+            s.erase( {prio[id], id} );
+            prio[id] += rnd.nextInt(40) - 20;
+            h.update(id);
+            s.insert( {prio[id], id} );
+        }else if( op == 2 ){
+            if( !h.contains(id) ) continue;
+            s.erase( {prio[id], id} );
+            h.remove(id);
+        }else if( op == 3 ){
+            if( h.empty() ) continue;
+            int t = h.top();
+            ASSERT_EQ( t, s.begin()->second );
+            h.pop();
+            s.erase( s.begin() );
+            ASSERT_FALSE( h.contains(t) );
+        }else if( rnd.nextInt(50) == 0 ){
+            h.clear();
+            s.clear();
+            ASSERT_EQ( pos, VI(N,-1) );
+        }
+
+        ASSERT_EQ( h.size(), s.size() );
+        if( !h.empty() ) ASSERT_EQ( h.top(), s.begin()->second );
+        for( int i=0; i<h.size(); i++ ) ASSERT_EQ( pos[ h.h[i] ], i );
+    }
+}
+
+/**
+ * Heaps sharing one [pos] array, stored in a vector that is reallocated - moving must not break any of them.
+ */
+TEST( IndexedHeap, test_shared_pos ){
+    const int N = 40;
+    VI prio(N), pos(N,-1);
+    for( int i=0; i<N; i++ ) prio[i] = (i * 7) % N;
+
+    vector< IndexedHeap<PriorityCmp> > heaps;
+    for( int k=0; k<4; k++ ){
+        heaps.emplace_back( &pos, PriorityCmp{&prio} );
+        for( int i=k; i<N; i+=4 ) heaps.back().push(i);
+    }
+
+    for( int k=0; k<4; k++ ){
+        ASSERT_EQ( heaps[k].size(), N/4 );
+        VI popped;
+        while( !heaps[k].empty() ){
+            popped.push_back( prio[ heaps[k].top() ] );
+            heaps[k].pop();
+        }
+        ASSERT_TRUE( is_sorted( ALL(popped) ) );
+    }
+
+    ASSERT_EQ( pos, VI(N,-1) );
+}
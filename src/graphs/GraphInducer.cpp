@@ -63,10 +63,13 @@ InducedGraphPI GraphInducer::induce(VVPII &V, VI &nodes) {
 }
 
 
-InducedGraphPI GraphInducer::induceNoPerm(VVPII &V, VI &nodes, VI &helper) {
+/**
+ * Implementation of [GraphInducer::induceNoPerm], common for VVPII and CSRGraph<PII>. [par] field is not set.
+ */
+template<class _G>
+static InducedGraphPI induceNoPermImpl(_G &V, VI &nodes, VI &helper) {
     InducedGraphPI g;
     g.nodes = nodes;
-    g.par = &V;
     int N = SIZE(nodes);
 
     int M = 0;
@@ -95,6 +98,18 @@ InducedGraphPI GraphInducer::induceNoPerm(VVPII &V, VI &nodes, VI &helper) {
     return g;
 }
 
+InducedGraphPI GraphInducer::induceNoPerm(VVPII &V, VI &nodes, VI &helper) {
+    InducedGraphPI g = induceNoPermImpl(V, nodes, helper);
+    g.par = &V;
+    return g;
+}
+
+InducedGraphPI GraphInducer::induceNoPerm(CSRGraph<PII> &V, VI &nodes, VI &helper) {
+    InducedGraphPI g = induceNoPermImpl(V, nodes, helper);
+    g.par = nullptr;
+    return g;
+}
+
 
 
 
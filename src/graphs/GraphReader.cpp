@@ -3,6 +3,11 @@
 //
 
 #include "graphs/GraphReader.h"
+#include "graphs/GraphBinaryFormat.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 
 namespace GraphReader{
@@ -75,4 +80,243 @@ namespace GraphReader{
     }
 
 
+    /**
+     * Reads next nonnegative integer from the current line, skipping any other characters before it.
+     * @return false if end of line (or text) was reached before any digit. In that case [p] points to the end of line.
+     */
+    static inline bool nextInt( const char* & p, const char* end, int & x ){
+        while( p < end && (unsigned)(*p - '0') > 9 ){
+            if( *p == '\n' ) return false;
+            p++;
+        }
+        if( p == end ) return false;
+
+        unsigned v = 0;
+        while( p < end && (unsigned)(*p - '0') <= 9 ) v = 10*v + (*p++ - '0');
+        x = v;
+        return true;
+    }
+
+    static inline const char* skipLine( const char* p, const char* end ){
+        const char* nl = (const char*)memchr( p, '\n', end-p );
+        return nl == nullptr ? end : nl+1;
+    }
+
+    /**
+     * Skips comment lines and reads the 'p' line of dimacs text [beg,end).
+     * @return pointer to the beginning of the line after the 'p' line
+     */
+    static const char* parseDIMACSHeader( const char* beg, const char* end, int & N, int & M ){
+        const char* p = beg;
+        N = M = 0;
+
+        while( p < end && *p != 'p' ) p = skipLine(p,end);
+        if( p == end ) return end;
+
+        p++;
+        if( !nextInt(p,end,N) || !nextInt(p,end,M) ){
+            cerr << "Invalid header line in dimacs format" << endl;
+            N = M = 0;
+            return end;
+        }
+
+        return skipLine(p,end);
+    }
+
+    /**
+     * Calls f(a,b) for each of first M edges (a,b) in dimacs text [beg,end), with nodes indexed from 0. Comment lines
+     * are skipped.
+     */
+    template<class _F>
+    static void forEachDIMACSEdge( const char* beg, const char* end, int M, _F f ){
+        const char* p = beg;
+        int edges_read = 0;
+
+        while( p < end && edges_read < M ){
+            if( *p != 'c' ){
+                int a,b;
+                if( nextInt(p,end,a) && nextInt(p,end,b) ){
+                    f(a-1,b-1);
+                    edges_read++;
+                }
+            }
+
+            p = skipLine(p,end);
+        }
+    }
+
+    CSRGraph<int> parseGraphDIMACSWunweighed(const char* beg, const char* end) {
+        int N, M;
+        beg = parseDIMACSHeader( beg, end, N, M );
+
+        CSRGraph<int> V;
+        VI & offsets = V.offsets;
+
+        // first pass - counting degrees
+        offsets.assign(N+1,0);
+        forEachDIMACSEdge( beg, end, M, [&](int a, int b){
+            offsets[a+1]++;
+            offsets[b+1]++;
+        });
+        for( int i=0; i<N; i++ ) offsets[i+1] += offsets[i];
+
+        // second pass - placing neighbors
+        V.adj.resize( offsets[N] );
+        VI pos( offsets.begin(), offsets.end()-1 );
+        forEachDIMACSEdge( beg, end, M, [&](int a, int b){
+            V.adj[ pos[a]++ ] = b;
+            V.adj[ pos[b]++ ] = a;
+        });
+
+        V.sortNeighbors(true);
+        return V;
+    }
+
+    CSRGraph<int> readGraphDIMACSWunweighedCSR(istream &cin) {
+        const int BLOCK = 1<<22;
+        string text;
+
+        streambuf* buf = cin.rdbuf();
+        while(true){
+            size_t s = text.size();
+            text.resize( s + BLOCK );
+            size_t r = buf->sgetn( &text[s], BLOCK );
+            text.resize( s + r );
+            if( r < BLOCK ) break;
+        }
+
+        return parseGraphDIMACSWunweighed( text.data(), text.data() + text.size() );
+    }
+
+    CSRGraph<int> readGraphDIMACSWunweighedCSR(int fd) {
+        struct stat st;
+        if( fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 ){
+            size_t size = st.st_size;
+            void* data = mmap( nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+            if( data != MAP_FAILED ){
+                madvise( data, size, MADV_SEQUENTIAL );
+                const char* beg = (const char*)data;
+                CSRGraph<int> V = parseGraphDIMACSWunweighed( beg, beg + size );
+                munmap( data, size );
+                return V;
+            }
+        }
+
+        // not a regular file or mmap failed - reading in large blocks
+        const int BLOCK = 1<<22;
+        string text;
+        while(true){
+            size_t s = text.size();
+            text.resize( s + BLOCK );
+            ssize_t r = read( fd, &text[s], BLOCK );
+            if( r <= 0 ){
+                text.resize(s);
+                break;
+            }
+            text.resize( s + r );
+        }
+
+        return parseGraphDIMACSWunweighed( text.data(), text.data() + text.size() );
+    }
+
+    /**
+     * Reads single value from [p]. Values are copied element-wise, since [p] may not be aligned and pairs may not be
+     * copied by memcpy.
+     */
+    static void readEntry( const char* p, int & e ){ memcpy( &e, p, sizeof(int) ); }
+    static void readEntry( const char* p, PII & e ){
+        memcpy( &e.first, p, sizeof(int) );
+        memcpy( &e.second, p + sizeof(int), sizeof(int) );
+    }
+
+    template<class _T>
+    static bool readGraphBinaryImpl( const string & file, CSRGraph<_T> & V, VI * node_weights, VI * partition,
+                                     unsigned long long * key ){
+        int fd = open( file.c_str(), O_RDONLY );
+        if( fd < 0 ) return false;
+
+        struct stat st;
+        if( fstat(fd, &st) != 0 || st.st_size < sizeof(GraphBinaryHeader) ){
+            close(fd);
+            return false;
+        }
+
+        size_t size = st.st_size;
+        void* data = mmap( nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+        close(fd);
+        if( data == MAP_FAILED ) return false;
+
+        bool res = false;
+        GraphBinaryHeader header;
+        memcpy( &header, data, sizeof(header) );
+
+        const bool weighted = is_same<_T,PII>::value;
+        bool valid = ( header.magic == GraphBinaryHeader::MAGIC ) && header.N >= 0 && header.adj_size >= 0
+                && ( (header.flags & GraphBinaryHeader::WEIGHTED) != 0 ) == weighted
+                && (size_t)header.N < size / sizeof(int) && (size_t)header.adj_size <= size / sizeof(_T); // no overflow below
+
+        if(valid){
+            const int N = header.N;
+            const bool has_nw = ( header.flags & GraphBinaryHeader::HAS_NODE_WEIGHTS ) != 0;
+            const bool has_part = ( header.flags & GraphBinaryHeader::HAS_PARTITION ) != 0;
+
+            size_t expected = sizeof(header) + (N+1) * sizeof(int) + header.adj_size * sizeof(_T)
+                    + (has_nw ? N * sizeof(int) : 0) + (has_part ? N * sizeof(int) : 0);
+
+            if( expected == size ){
+                const char* p = (const char*)data + sizeof(header);
+                auto load = [&]( auto & vec, size_t cnt ){
+                    vec.resize(cnt);
+                    for( auto & e : vec ){
+                        readEntry( p, e );
+                        p += sizeof(e);
+                    }
+                };
+
+                load( V.offsets, N+1 );
+
+                // offsets must describe a valid CSR structure, otherwise [V] would be read out of bounds
+                bool valid_offsets = ( V.offsets[0] == 0 && V.offsets[N] == header.adj_size );
+                for( int i=0; i<N && valid_offsets; i++ ) if( V.offsets[i] > V.offsets[i+1] ) valid_offsets = false;
+
+                if(valid_offsets){
+                    load( V.adj, header.adj_size );
+                    for( int i=0; i<V.adj.size() && valid_offsets; i++ ){
+                        int d = CSRGraph<_T>::entryId( V.adj[i] );
+                        if( d < 0 || d >= N ) valid_offsets = false;
+                    }
+                }
+
+                if(valid_offsets){
+                    if( has_nw ){
+                        if( node_weights != nullptr ) load( *node_weights, N );
+                        else p += N * sizeof(int);
+                    }else if( node_weights != nullptr ) node_weights->clear();
+
+                    if( has_part ){
+                        if( partition != nullptr ) load( *partition, N );
+                        else p += N * sizeof(int);
+                    }else if( partition != nullptr ) partition->clear();
+
+                    if( key != nullptr ) *key = header.key;
+                    res = true;
+                }else V = CSRGraph<_T>();
+            }
+        }
+
+        munmap( data, size );
+        if(!res) cerr << "File " << file << " does not contain a valid graph in binary format" << endl;
+        return res;
+    }
+
+    bool readGraphBinary( const string & file, CSRGraph<int> & V, VI * node_weights, VI * partition,
+                          unsigned long long * key ){
+        return readGraphBinaryImpl( file, V, node_weights, partition, key );
+    }
+
+    bool readGraphBinary( const string & file, CSRGraph<PII> & V, VI * node_weights, VI * partition,
+                          unsigned long long * key ){
+        return readGraphBinaryImpl( file, V, node_weights, partition, key );
+    }
+
 }
\ No newline at end of file
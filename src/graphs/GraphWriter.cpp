@@ -5,6 +5,9 @@
 #include <graphs/GraphWriter.h>
 
 #include <graphs/GraphUtils.h>
+#include <graphs/GraphBinaryFormat.h>
+#include <thread>
+#include <unistd.h>
 
 namespace GraphWriter {
 
@@ -31,4 +34,65 @@ namespace GraphWriter {
         }
     }
 
+
+    template<class _T>
+    static bool writeGraphBinaryImpl( const CSRGraph<_T> & V, const string & file, const VI * node_weights,
+                                      const VI * partition, unsigned long long key ){
+        static_assert( sizeof(_T) == 4 || sizeof(_T) == 8 );
+        int N = V.size();
+
+        GraphBinaryHeader header;
+        header.N = N;
+        header.adj_size = V.adj.size();
+        header.key = key;
+        if( is_same<_T,PII>::value ) header.flags |= GraphBinaryHeader::WEIGHTED;
+        if( node_weights != nullptr ){
+            assert( node_weights->size() == N );
+            header.flags |= GraphBinaryHeader::HAS_NODE_WEIGHTS;
+        }
+        if( partition != nullptr ){
+            assert( partition->size() == N );
+            header.flags |= GraphBinaryHeader::HAS_PARTITION;
+        }
+
+        // many threads (or processes) may write the same file at once
+        string tmp = file + ".tmp" + to_string( getpid() ) + "_" + to_string( hash<thread::id>()( this_thread::get_id() ) );
+
+        {
+            ofstream out( tmp, ios::binary );
+            auto write = [&]( const void* data, size_t bytes ){ out.write( (const char*)data, bytes ); };
+
+            write( &header, sizeof(header) );
+            write( V.offsets.data(), V.offsets.size() * sizeof(int) );
+            write( V.adj.data(), V.adj.size() * sizeof(_T) );
+            if( node_weights != nullptr ) write( node_weights->data(), N * sizeof(int) );
+            if( partition != nullptr ) write( partition->data(), N * sizeof(int) );
+
+            out.close();
+            if( !out ){
+                cerr << "Could not write graph to file " << tmp << endl;
+                remove( tmp.c_str() );
+                return false;
+            }
+        }
+
+        if( rename( tmp.c_str(), file.c_str() ) != 0 ){
+            cerr << "Could not rename " << tmp << " to " << file << endl;
+            remove( tmp.c_str() );
+            return false;
+        }
+
+        return true;
+    }
+
+    bool writeGraphBinary( const CSRGraph<int> & V, const string & file, const VI * node_weights,
+                           const VI * partition, unsigned long long key ){
+        return writeGraphBinaryImpl( V, file, node_weights, partition, key );
+    }
+
+    bool writeGraphBinary( const CSRGraph<PII> & V, const string & file, const VI * node_weights,
+                           const VI * partition, unsigned long long key ){
+        return writeGraphBinaryImpl( V, file, node_weights, partition, key );
+    }
+
 }
\ No newline at end of file
@@ -0,0 +1,65 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#include "graphs/GraphReader.h"
+
+/**
+ * Compares speed of GraphReader::readGraphDIMACSWunweighed and GraphReader::parseGraphDIMACSWunweighed.
+ *
+ * Usage:
+ * GraphReaderBenchmark [file.gr]
+ * If no file is given, then a random graph with 10^6 nodes and 10^7 edges is generated.
+ */
+int main( int argc, char **argv ) {
+    string text;
+
+    if( argc > 1 ){
+        ifstream istr(argv[1]);
+        stringstream str;
+        str << istr.rdbuf();
+        text = str.str();
+    }else{
+        const int N = 1'000'000;
+        const int M = 10'000'000;
+        mt19937 gen(7);
+        uniform_int_distribution<int> dist(1,N);
+
+        stringstream str;
+        str << "c random graph" << endl << "p cep " << N << " " << M << endl;
+        for( int i=0; i<M; i++ ) str << dist(gen) << " " << dist(gen) << "\n";
+        text = str.str();
+    }
+
+    const double MB = text.size() / 1e6;
+    clog << "Input size: " << MB << " MB" << endl;
+
+    auto measure = [&]( string name, function<long long()> fun ){
+        auto start = chrono::steady_clock::now();
+        long long E = fun();
+        double secs = chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+        clog << name << ": " << secs << " s, " << (MB / secs) << " MB/s, edges: " << E << endl;
+    };
+
+    measure( "readGraphDIMACSWunweighed", [&](){
+        istringstream str(text);
+        VVI V = GraphReader::readGraphDIMACSWunweighed(str);
+        long long E = 0;
+        for( auto & neigh : V ) E += neigh.size();
+        return E/2;
+    });
+
+    measure( "parseGraphDIMACSWunweighed", [&](){
+        CSRGraph<int> V = GraphReader::parseGraphDIMACSWunweighed( text.data(), text.data() + text.size() );
+        return V.countEdges();
+    });
+
+    measure( "parseGraphDIMACSWunweighed + toVVI", [&](){
+        VVI V = GraphReader::parseGraphDIMACSWunweighed( text.data(), text.data() + text.size() ).toVVI();
+        long long E = 0;
+        for( auto & neigh : V ) E += neigh.size();
+        return E/2;
+    });
+
+    return 0;
+}
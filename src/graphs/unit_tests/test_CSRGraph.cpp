@@ -0,0 +1,160 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#include "graphs/CSRGraph.h"
+#include "graphs/GraphReader.h"
+#include "graphs/GraphInducer.h"
+#include "graphs/GraphWriter.h"
+#include "graphs/GraphBinaryFormat.h"
+#include "gtest/gtest.h"
+
+
+// TESTS
+class CSRGraphFixture : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        V = {
+                { {1,2}, {3,1} }, // 0
+                { {0,2}, {2,5}, {3,1} }, // 1
+                { {1,5} }, // 2
+                { {0,1}, {1,1}, {4,3} }, // 3
+                { {3,3} }, // 4
+                {} // 5
+        };
+    }
+
+    VVPII V;
+};
+
+
+TEST_F(CSRGraphFixture, fromVVPII) {
+    CSRGraph<PII> g(V);
+
+    EXPECT_EQ( g.size(), 6 );
+    EXPECT_EQ( g.countEdges(), 5 );
+    EXPECT_EQ( g.offsets, VI({0,2,5,6,9,10,10}) );
+
+    for( int i=0; i<V.size(); i++ ){
+        EXPECT_EQ( g[i].size(), V[i].size() );
+        EXPECT_EQ( g.degree(i), V[i].size() );
+        EXPECT_EQ( VPII( ALL(g[i]) ), V[i] );
+    }
+    EXPECT_TRUE( g[5].empty() );
+
+    EXPECT_EQ( g.toVV(), V );
+
+    VVI unweighted = { {1,3}, {0,2,3}, {1}, {0,1,4}, {3}, {} };
+    EXPECT_EQ( g.toVVI(), unweighted );
+
+    int sum = 0;
+    for( auto & [u,w] : g[3] ) sum += w;
+    EXPECT_EQ( sum, 5 );
+}
+
+TEST_F(CSRGraphFixture, fromEdges) {
+    VPII edges = { {3,1}, {0,1}, {4,3}, {1,2}, {0,3}, {1,0} };
+    VI weights = { 1, 2, 3, 5, 1, 2 };
+
+    CSRGraph<PII> g = CSRGraph<PII>::fromEdges( 6, edges, false, &weights );
+    EXPECT_EQ( g.size(), 6 );
+    EXPECT_EQ( g.countEdges(), 6 );
+    EXPECT_EQ( VPII( ALL(g[1]) ), VPII({ {3,1}, {0,2}, {2,5}, {0,2} }) ); // order in which edges were given
+
+    g.sortNeighbors(true);
+    EXPECT_EQ( g.countEdges(), 5 );
+    EXPECT_EQ( g.toVV(), V );
+
+    CSRGraph<int> h = CSRGraph<int>::fromEdges( 6, edges, true );
+    EXPECT_EQ( h.toVVI(), VVI({ {1,3}, {2,0}, {}, {1}, {3}, {} }) );
+}
+
+TEST_F(CSRGraphFixture, readDIMACS) {
+    stringstream str;
+    str << "c comment" << endl
+        << "p cep 6 6" << endl
+        << "1 2" << endl
+        << "2 3" << endl
+        << "c another comment" << endl
+        << "4 1" << endl
+        << "2 4" << endl
+        << "5 4" << endl
+        << "2 1" << endl;
+
+    CSRGraph<int> g = GraphReader::readGraphDIMACSWunweighedCSR(str);
+    EXPECT_EQ( g.size(), 6 );
+    EXPECT_EQ( g.countEdges(), 5 );
+    EXPECT_EQ( g.toVVI(), CSRGraph<PII>(V).toVVI() );
+}
+
+TEST_F(CSRGraphFixture, readDIMACSFromFile) {
+    string text = "c comment\np cep 6 6\ne 1 2\ne 2 3\ne 4 1\ne 2 4\ne 5 4\ne 2 1"; // no newline at the end
+
+    CSRGraph<int> g = GraphReader::parseGraphDIMACSWunweighed( text.data(), text.data() + text.size() );
+    EXPECT_EQ( g.toVVI(), CSRGraph<PII>(V).toVVI() );
+
+    FILE* f = tmpfile();
+    fputs( text.c_str(), f );
+    fflush(f);
+    rewind(f);
+    CSRGraph<int> h = GraphReader::readGraphDIMACSWunweighedCSR( fileno(f) ); // memory-mapped
+    fclose(f);
+    EXPECT_EQ( h.offsets, g.offsets );
+    EXPECT_EQ( h.adj, g.adj );
+
+    stringstream str(text);
+    VVI W = GraphReader::readGraphDIMACSWunweighed(str, true);
+    EXPECT_EQ( g.toVVI(), W );
+}
+
+TEST_F(CSRGraphFixture, induceNoPerm) {
+    CSRGraph<PII> g(V);
+    VI nodes = {3,1,4};
+    VI helper;
+
+    InducedGraphPI ig = GraphInducer::induceNoPerm( g, nodes, helper );
+    InducedGraphPI ig2 = GraphInducer::induceNoPerm( V, nodes, helper );
+
+    EXPECT_EQ( ig.V, ig2.V );
+    EXPECT_EQ( ig.V, VVPII({ { {1,1}, {2,3} }, { {0,1} }, { {0,3} } }) );
+    EXPECT_EQ( ig.par, nullptr );
+    for( int d : helper ) EXPECT_LT( d, 0 );
+}
+
+TEST_F(CSRGraphFixture, binaryFormat) {
+    string file = "test_CSRGraph_binaryFormat.bin";
+    CSRGraph<PII> g(V);
+    VI node_weights = {1,2,3,4,5,6};
+    VI partition = {0,0,1,1,2,3};
+
+    EXPECT_TRUE( GraphWriter::writeGraphBinary( g, file, &node_weights, &partition, 179 ) );
+
+    CSRGraph<PII> h;
+    VI nw, part;
+    unsigned long long key = 0;
+    EXPECT_TRUE( GraphReader::readGraphBinary( file, h, &nw, &part, &key ) );
+    EXPECT_EQ( h.toVV(), V );
+    EXPECT_EQ( nw, node_weights );
+    EXPECT_EQ( part, partition );
+    EXPECT_EQ( key, 179 );
+
+    CSRGraph<int> unweighted;
+    EXPECT_FALSE( GraphReader::readGraphBinary( file, unweighted ) ); // graph in the file is weighted
+
+    EXPECT_TRUE( GraphWriter::writeGraphBinary( CSRGraph<int>( g.toVVI() ), file ) );
+    EXPECT_TRUE( GraphReader::readGraphBinary( file, unweighted, &nw, &part ) );
+    EXPECT_EQ( unweighted.toVVI(), g.toVVI() );
+    EXPECT_TRUE( nw.empty() );
+    EXPECT_TRUE( part.empty() );
+
+    { // offsets that are not monotone - the file has correct size, but must be rejected
+        fstream f( file, ios::in | ios::out | ios::binary );
+        int bad_offset = 1'000;
+        f.seekp( sizeof(GraphBinaryHeader) + 2 * sizeof(int) );
+        f.write( (const char*)&bad_offset, sizeof(int) );
+    }
+    EXPECT_FALSE( GraphReader::readGraphBinary( file, unweighted ) );
+
+    remove( file.c_str() );
+    EXPECT_FALSE( GraphReader::readGraphBinary( file, unweighted ) );
+}
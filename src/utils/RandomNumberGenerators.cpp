@@ -5,5 +5,5 @@
 #include "utils/RandomNumberGenerators.h"
 
 
-int UniformIntGenerator::lastSeed = 171'234'573;
-int UniformDoubleGenerator::lastSeed = 232;
\ No newline at end of file
+thread_local int UniformIntGenerator::lastSeed = 171'234'573;
+thread_local int UniformDoubleGenerator::lastSeed = 232;
\ No newline at end of file
@@ -0,0 +1,95 @@
+//
+// Created by sylwester on 10/18/21.
+//
+
+#include "utils/ThreadPool.h"
+
+ThreadPool::ThreadPool(int threads) : next_index(0), finished(0) {
+    for( int i=1; i<threads; i++ ) workers.emplace_back( [this,i](){ workerLoop(i); } );
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(mtx);
+        stop = true;
+    }
+    cv_job.notify_all();
+    for( auto & t : workers ) t.join();
+}
+
+void ThreadPool::workerLoop( int thread_id ) {
+    int my_generation = 0;
+
+    while(true){
+        const function<void(int,int)> * f;
+        int n;
+
+        {
+            unique_lock<mutex> lock(mtx);
+            cv_job.wait( lock, [&](){ return stop || generation != my_generation; } );
+            if(stop) return;
+
+            my_generation = generation;
+            f = job;
+            n = job_size;
+            active++;
+        }
+
+        int i;
+        while( (i = next_index++) < n ){
+            (*f)(i, thread_id);
+            finished++;
+        }
+
+        {
+            lock_guard<mutex> lock(mtx);
+            active--;
+        }
+        cv_done.notify_all();
+    }
+}
+
+void ThreadPool::parallelFor(int n, const function<void(int)> &f) {
+    parallelForWithThreadId( n, [&f](int i, int){ f(i); } );
+}
+
+void ThreadPool::parallelForWithThreadId(int n, const function<void(int, int)> &f) {
+    if( n <= 0 ) return;
+    if( workers.empty() || n == 1 ){
+        for( int i=0; i<n; i++ ) f(i,0);
+        return;
+    }
+
+    lock_guard<mutex> run_lock(run_mtx);
+
+    {
+        unique_lock<mutex> lock(mtx);
+        // workers that woke up late for previous job might still be 'active' - they need to finish first
+        cv_done.wait( lock, [&](){ return active == 0; } );
+
+        job = &f;
+        job_size = n;
+        next_index = 0;
+        finished = 0;
+        generation++;
+    }
+    cv_job.notify_all();
+
+    int i;
+    while( (i = next_index++) < n ){
+        f(i,0);
+        finished++;
+    }
+
+    unique_lock<mutex> lock(mtx);
+    cv_done.wait( lock, [&](){ return finished == n && active == 0; } );
+    job = nullptr;
+}
+
+void ThreadPool::run(vector<function<void()>> &tasks) {
+    parallelFor( tasks.size(), [&tasks](int i){ tasks[i](); } );
+}
+
+int ThreadPool::hardwareThreads() {
+    return max( 1, (int)thread::hardware_concurrency() );
+}
@@ -26,6 +26,7 @@ TimeMeasurer::~TimeMeasurer() {
 }
 
 void TimeMeasurer::stopMeasurement(string option) {
+    lock_guard<recursive_mutex> lock(mtx);
 //    if( Params::WRITE_STATISTICS == false ) return;
 
     if( times.find(option) == times.end() ){
@@ -40,16 +41,19 @@ void TimeMeasurer::stopMeasurement(string option) {
 
 
 void TimeMeasurer::startMeasurement(string option) {
+    lock_guard<recursive_mutex> lock(mtx);
 //    if( Params::WRITE_STATISTICS == false ) return;
     times[option] = clock();
 }
 
 float TimeMeasurer::getMeasurementTimeInSeconds(string option) {
+    lock_guard<recursive_mutex> lock(mtx);
     if( timesTotal.find(option) == timesTotal.end() ) return -1;
     else return ( ( (double)timesTotal[option] / (double)CLOCKS_PER_SEC ) );
 }
 
 map<string, float> TimeMeasurer::getAllMeasurements() {
+    lock_guard<recursive_mutex> lock(mtx);
     map<string,float> res;
     for( auto a : timesTotal ){
         res[a.first] = getMeasurementTimeInSeconds(a.first);
@@ -70,19 +74,23 @@ void TimeMeasurer::writeAllMeasurements() {
 }
 
 void TimeMeasurer::clearOption(string option) {
+    lock_guard<recursive_mutex> lock(mtx);
     times.erase(option);
 //    timesTotal.erase(option);
 }
 
 void TimeMeasurer::resetAllOptions() {
+    lock_guard<recursive_mutex> lock(mtx);
     times.clear();
     timesTotal.clear();
 }
 
 void TimeMeasurer::resetOption(string option) {
+    lock_guard<recursive_mutex> lock(mtx);
     times.erase(option);
     timesTotal.erase(option);
 }
 
 map<string,LL> TimeMeasurer::times;
-map<string,LL> TimeMeasurer::timesTotal;
\ No newline at end of file
+map<string,LL> TimeMeasurer::timesTotal;
+recursive_mutex TimeMeasurer::mtx;
\ No newline at end of file